@@ -0,0 +1,459 @@
+//! Benchmarks for every quest-sys binding family.
+//!
+//! Register-sized benchmarks run on statevectors of N qubits and on density
+//! matrices of N/2 qubits, which hold the same 2^N amplitudes, so the two are
+//! directly comparable. N defaults to 10, 14, 18 and 22 and is set with
+//! `QUEST_BENCH_QUBITS=10,16,22,28` (28 qubits needs 4 GiB per register).
+//!
+//! Throughput is reported as amplitudes per second and as effective memory
+//! bandwidth, counting 16 bytes for every amplitude a kernel must read and
+//! again for every one it must write. Where bandwidth is flat across N the
+//! QuEST kernel dominates; a drop at small N is per-call binding overhead.
+//!
+//! `QUEST_BENCH_SAVE_BASELINE=1 cargo bench` records `benches/baseline.json`;
+//! later runs print every benchmark whose median moved by more than
+//! `QUEST_BENCH_TOLERANCE` (default 0.1) relative to it.
+
+use std::collections::BTreeMap;
+use std::hint::black_box;
+use std::path::{Path, PathBuf};
+
+use criterion::{BenchmarkId, Criterion, SamplingMode, Throughput, criterion_group};
+use cxx::UniquePtr;
+use quest_sys::*;
+use serde_json::{Value, json};
+
+const AMP_BYTES: u64 = 16;
+const DEFAULT_QUBITS: [i32; 4] = [10, 14, 18, 22];
+
+#[derive(Clone, Copy, PartialEq)]
+enum Kind {
+    Statevector,
+    Density,
+}
+
+impl Kind {
+    fn label(self) -> &'static str {
+        match self {
+            Kind::Statevector => "statevector",
+            Kind::Density => "density",
+        }
+    }
+}
+
+const BOTH: &[Kind] = &[Kind::Statevector, Kind::Density];
+const STATEVECTOR: &[Kind] = &[Kind::Statevector];
+const DENSITY: &[Kind] = &[Kind::Density];
+
+fn bench_qubits() -> Vec<i32> {
+    match std::env::var("QUEST_BENCH_QUBITS") {
+        Ok(list) => list
+            .split(',')
+            .map(|n| {
+                n.trim()
+                    .parse()
+                    .expect("QUEST_BENCH_QUBITS must list integers")
+            })
+            .inspect(|&n| assert!(n >= 6, "benchmarks need at least 6 qubits"))
+            .collect(),
+        Err(_) => DEFAULT_QUBITS.to_vec(),
+    }
+}
+
+// Register of 2^n amplitudes, and the number of qubits it acts on
+fn create_register(kind: Kind, n: i32) -> (UniquePtr<Qureg>, i32) {
+    let mut qureg = match kind {
+        Kind::Statevector => createQureg(n),
+        Kind::Density => createDensityQureg(n / 2),
+    };
+    initDebugState(qureg.pin_mut());
+    let num_qubits = if kind == Kind::Density { n / 2 } else { n };
+    (qureg, num_qubits)
+}
+
+// Runs `routine` on one register per (kind, N), where each call reads and
+// writes `reads` and `writes` multiples of the register's amplitudes
+fn bench_registers<F>(
+    c: &mut Criterion,
+    group_name: &str,
+    function: &str,
+    kinds: &[Kind],
+    (reads, writes): (u64, u64),
+    mut routine: F,
+) where
+    F: FnMut(&mut UniquePtr<Qureg>, i32),
+{
+    let mut group = c.benchmark_group(group_name);
+    group.sampling_mode(SamplingMode::Flat).sample_size(10);
+    for &kind in kinds {
+        for n in bench_qubits() {
+            let (mut qureg, num_qubits) = create_register(kind, n);
+            let num_amps = match kind {
+                Kind::Statevector => 1_u64 << num_qubits,
+                Kind::Density => 1_u64 << (2 * num_qubits),
+            };
+            group.throughput(Throughput::ElementsAndBytes {
+                elements: num_amps,
+                bytes: (reads + writes) * num_amps * AMP_BYTES,
+            });
+            let id = BenchmarkId::new(format!("{function}/{}", kind.label()), n);
+            group.bench_function(id, |b| b.iter(|| routine(&mut qureg, num_qubits)));
+            destroyQureg(qureg.pin_mut());
+        }
+    }
+    group.finish();
+}
+
+fn unit_matrix(dim: usize) -> Vec<Quest_Complex> {
+    // A real rotation on the first two basis states and identity elsewhere
+    let (s, c) = 0.3_f64.sin_cos();
+    let mut m = vec![complex(0.0, 0.0); dim * dim];
+    for i in 0..dim {
+        m[i * dim + i] = complex(1.0, 0.0);
+    }
+    m[0] = complex(c, 0.0);
+    m[1] = complex(-s, 0.0);
+    m[dim] = complex(s, 0.0);
+    m[dim + 1] = complex(c, 0.0);
+    m
+}
+
+fn gates(c: &mut Criterion) {
+    let m1 = getCompMatr1Flat(&unit_matrix(2));
+    let m2 = getCompMatr2Flat(&unit_matrix(4));
+    let mut m3 = createCompMatr(3);
+    setCompMatrFlat(m3.pin_mut(), &unit_matrix(8), 8);
+
+    bench_registers(c, "gates", "applyHadamard", BOTH, (1, 1), |q, n| {
+        applyHadamard(q.pin_mut(), n - 1)
+    });
+    bench_registers(c, "gates", "applyCompMatr1", BOTH, (1, 1), |q, n| {
+        applyCompMatr1(q.pin_mut(), n - 1, &m1)
+    });
+    bench_registers(c, "gates", "applyCompMatr2", BOTH, (1, 1), |q, n| {
+        applyCompMatr2(q.pin_mut(), 0, n - 1, &m2)
+    });
+    bench_registers(c, "gates", "applyCompMatr", BOTH, (1, 1), |q, n| {
+        applyCompMatr(q.pin_mut(), &[0, 1, n - 1], &m3)
+    });
+    // Two controls leave a quarter of the amplitudes to update
+    bench_registers(
+        c,
+        "gates",
+        "applyMultiControlledCompMatr1",
+        BOTH,
+        (1, 1),
+        |q, n| applyMultiControlledCompMatr1(q.pin_mut(), &[0, 1], n - 1, &m1),
+    );
+
+    destroyCompMatr(m3.pin_mut());
+}
+
+fn diagonals(c: &mut Criterion) {
+    let phase = |k: usize| {
+        let (s, c) = (0.1 * k as f64).sin_cos();
+        complex(c, s)
+    };
+    let d1 = getDiagMatr1(&[phase(0), phase(1)]);
+    let d2 = getDiagMatr2(&(0..4).map(phase).collect::<Vec<_>>());
+    let mut d3 = createDiagMatr(3);
+    setDiagMatr(d3.pin_mut(), &(0..8).map(phase).collect::<Vec<_>>());
+
+    bench_registers(c, "diagonals", "applyDiagMatr1", BOTH, (1, 1), |q, n| {
+        applyDiagMatr1(q.pin_mut(), n - 1, &d1)
+    });
+    bench_registers(c, "diagonals", "applyDiagMatr2", BOTH, (1, 1), |q, n| {
+        applyDiagMatr2(q.pin_mut(), 0, n - 1, &d2)
+    });
+    bench_registers(c, "diagonals", "applyDiagMatr", BOTH, (1, 1), |q, n| {
+        applyDiagMatr(q.pin_mut(), &[0, 1, n - 1], &d3)
+    });
+
+    destroyDiagMatr(d3.pin_mut());
+}
+
+fn decoherence(c: &mut Criterion) {
+    bench_registers(c, "decoherence", "mixDephasing", DENSITY, (1, 1), |q, n| {
+        mixDephasing(q.pin_mut(), n - 1, 0.01)
+    });
+    bench_registers(
+        c,
+        "decoherence",
+        "mixDepolarising",
+        DENSITY,
+        (1, 1),
+        |q, n| mixDepolarising(q.pin_mut(), n - 1, 0.01),
+    );
+    bench_registers(c, "decoherence", "mixDamping", DENSITY, (1, 1), |q, n| {
+        mixDamping(q.pin_mut(), n - 1, 0.01)
+    });
+    bench_registers(
+        c,
+        "decoherence",
+        "mixTwoQubitDepolarising",
+        DENSITY,
+        (1, 1),
+        |q, n| mixTwoQubitDepolarising(q.pin_mut(), 0, n - 1, 0.01),
+    );
+}
+
+fn calculations(c: &mut Criterion) {
+    // QuEST sweeps the register once per term
+    const TERMS: [&str; 4] = ["0.5 X", "-0.25 Z", "0.125 Y", "1.0 I"];
+    let mut sums = BTreeMap::new();
+    bench_registers(
+        c,
+        "calculations",
+        "calcExpecPauliStrSum",
+        BOTH,
+        (TERMS.len() as u64, 0),
+        |q, n| {
+            let sum = sums.entry(n).or_insert_with(|| {
+                let lines: Vec<String> = TERMS
+                    .iter()
+                    .map(|term| {
+                        let (coeff, pauli) = term.split_once(' ').unwrap();
+                        format!("{coeff} {}", pauli.repeat(n as usize))
+                    })
+                    .collect();
+                createInlinePauliStrSum(lines.join("\n"))
+            });
+            black_box(calcExpecPauliStrSum(q, sum));
+        },
+    );
+    for sum in sums.values_mut() {
+        destroyPauliStrSum(sum.pin_mut());
+    }
+
+    // The reduced register is a quarter of the size and freed each time
+    bench_registers(
+        c,
+        "calculations",
+        "calcPartialTrace",
+        DENSITY,
+        (1, 0),
+        |q, n| {
+            let mut reduced = calcPartialTrace(q, &[n - 1]);
+            destroyQureg(reduced.pin_mut());
+        },
+    );
+}
+
+fn amplitudes(c: &mut Criterion) {
+    let mut buffer = Vec::new();
+    bench_registers(c, "amplitudes", "get", STATEVECTOR, (1, 1), |q, n| {
+        buffer.resize(1 << n, complex(0.0, 0.0));
+        getQuregAmpsInto(q.pin_mut(), 0, &mut buffer);
+        black_box(&buffer);
+    });
+    bench_registers(c, "amplitudes", "get", DENSITY, (1, 1), |q, n| {
+        let dim = 1_i64 << n;
+        buffer.resize(1 << (2 * n), complex(0.0, 0.0));
+        getDensityQuregAmpsInto(q.pin_mut(), 0, 0, dim, dim, &mut buffer);
+        black_box(&buffer);
+    });
+    bench_registers(c, "amplitudes", "set", STATEVECTOR, (1, 1), |q, n| {
+        buffer.resize(1 << n, complex(0.0, 0.0));
+        setQuregAmps(q.pin_mut(), 0, &buffer);
+    });
+    bench_registers(c, "amplitudes", "set", DENSITY, (1, 1), |q, n| {
+        let dim = 1_i64 << n;
+        buffer.resize(1 << (2 * n), complex(0.0, 0.0));
+        setDensityQuregAmpsFlat(q.pin_mut(), 0, 0, dim, dim, &buffer);
+    });
+}
+
+// Four diagonal sign operators of weight 1/2, which sum to a valid channel
+fn kraus_operators(num_qubits: i32) -> Vec<Quest_Complex> {
+    let dim = 1_usize << num_qubits;
+    let mut ops = vec![complex(0.0, 0.0); 4 * dim * dim];
+    for k in 0..4_usize {
+        for i in 0..dim {
+            let sign = if (i & k).count_ones() % 2 == 0 {
+                0.5
+            } else {
+                -0.5
+            };
+            ops[(k * dim + i) * dim + i] = complex(sign, 0.0);
+        }
+    }
+    ops
+}
+
+fn channels(c: &mut Criterion) {
+    let mut group = c.benchmark_group("channels");
+    for num_qubits in 1..=3 {
+        let ops = kraus_operators(num_qubits);
+        let entries = ops.len() as u64;
+        group.throughput(Throughput::ElementsAndBytes {
+            elements: entries,
+            bytes: entries * AMP_BYTES,
+        });
+
+        group.bench_with_input(
+            BenchmarkId::new("createInlineKrausMapFlat", num_qubits),
+            &ops,
+            |b, ops| {
+                b.iter(|| {
+                    let mut map = createInlineKrausMapFlat(num_qubits, 4, ops);
+                    destroyKrausMap(map.pin_mut());
+                })
+            },
+        );
+
+        // Includes rebuilding the superoperator
+        let mut map = createKrausMap(num_qubits, 4);
+        group.bench_with_input(
+            BenchmarkId::new("setKrausMapFlat", num_qubits),
+            &ops,
+            |b, ops| {
+                b.iter(|| {
+                    setKrausMapFlat(map.pin_mut(), ops);
+                    syncKrausMap(map.pin_mut());
+                })
+            },
+        );
+        destroyKrausMap(map.pin_mut());
+
+        // Every call after the first is a cache hit
+        let mut cache = createChannelCache();
+        group.bench_with_input(
+            BenchmarkId::new("cacheKrausMap", num_qubits),
+            &ops,
+            |b, ops| b.iter(|| black_box(cacheKrausMap(cache.pin_mut(), num_qubits, 4, ops))),
+        );
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    gates,
+    diagonals,
+    decoherence,
+    calculations,
+    amplitudes,
+    channels
+);
+
+fn baseline_path() -> PathBuf {
+    Path::new(env!("CARGO_MANIFEST_DIR")).join("benches/baseline.json")
+}
+
+fn criterion_dir() -> PathBuf {
+    if let Ok(home) = std::env::var("CRITERION_HOME") {
+        return PathBuf::from(home);
+    }
+    if let Ok(target) = std::env::var("CARGO_TARGET_DIR") {
+        return Path::new(&target).join("criterion");
+    }
+    // quest-sys is a workspace member, so the target directory is one level up
+    let manifest = Path::new(env!("CARGO_MANIFEST_DIR"));
+    [
+        manifest.join("../target/criterion"),
+        manifest.join("target/criterion"),
+    ]
+    .into_iter()
+    .find(|dir| dir.exists())
+    .unwrap_or_else(|| manifest.join("../target/criterion"))
+}
+
+// Latest estimate of every benchmark Criterion has recorded, keyed by its id
+fn collect_results(dir: &Path, results: &mut BTreeMap<String, Value>) {
+    let Ok(entries) = std::fs::read_dir(dir) else {
+        return;
+    };
+    for entry in entries.filter_map(Result::ok) {
+        let path = entry.path();
+        if !path.is_dir() {
+            continue;
+        }
+        let read = |name: &str| -> Option<Value> {
+            let text = std::fs::read_to_string(path.join("new").join(name)).ok()?;
+            serde_json::from_str(&text).ok()
+        };
+        if let (Some(benchmark), Some(estimates)) = (read("benchmark.json"), read("estimates.json"))
+        {
+            if let Some(id) = benchmark["full_id"].as_str() {
+                results.insert(
+                    id.to_string(),
+                    json!({
+                        "mean_ns": estimates["mean"]["point_estimate"],
+                        "median_ns": estimates["median"]["point_estimate"],
+                        "throughput": benchmark["throughput"],
+                    }),
+                );
+            }
+        } else {
+            collect_results(&path, results);
+        }
+    }
+}
+
+fn save_or_compare_baseline() {
+    let mut results = BTreeMap::new();
+    collect_results(&criterion_dir(), &mut results);
+    if results.is_empty() {
+        return;
+    }
+
+    let path = baseline_path();
+    if std::env::var_os("QUEST_BENCH_SAVE_BASELINE").is_some() {
+        let threads = std::thread::available_parallelism().map_or(1, |n| n.get());
+        let baseline = json!({
+            "format": 1,
+            "machine": {
+                "os": std::env::consts::OS,
+                "arch": std::env::consts::ARCH,
+                "threads": threads,
+            },
+            "results": results,
+        });
+        std::fs::write(
+            &path,
+            serde_json::to_string_pretty(&baseline).unwrap() + "\n",
+        )
+        .expect("failed to write the benchmark baseline");
+        println!("Saved {} results to {}", results.len(), path.display());
+        return;
+    }
+
+    let Some(baseline) = std::fs::read_to_string(&path)
+        .ok()
+        .and_then(|text| serde_json::from_str::<Value>(&text).ok())
+    else {
+        return;
+    };
+    let tolerance: f64 = std::env::var("QUEST_BENCH_TOLERANCE")
+        .ok()
+        .and_then(|t| t.parse().ok())
+        .unwrap_or(0.1);
+
+    let mut compared = 0;
+    for (id, result) in &results {
+        let (Some(old), Some(new)) = (
+            baseline["results"][id]["median_ns"].as_f64(),
+            result["median_ns"].as_f64(),
+        ) else {
+            continue;
+        };
+        compared += 1;
+        let change = new / old - 1.0;
+        if change.abs() > tolerance {
+            let verdict = if change > 0.0 { "slower" } else { "faster" };
+            println!(
+                "{id}: {:+.1}% {verdict} than baseline ({old:.0} ns -> {new:.0} ns)",
+                100.0 * change
+            );
+        }
+    }
+    println!("Compared {compared} benchmarks against {}", path.display());
+}
+
+fn main() {
+    initQuESTEnv();
+    benches();
+    Criterion::default().configure_from_args().final_summary();
+    save_or_compare_baseline();
+    finalizeQuESTEnv();
+}
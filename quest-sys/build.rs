@@ -357,6 +357,11 @@ fn main() -> Result<(), Box<dyn std::error::Error>> {
         }
     }
 
+    // Per-wrapper call timings, compiled out unless requested
+    if cfg!(feature = "profiling") {
+        builder.define("QUEST_SYS_PROFILING", Some("1"));
+    }
+
     // Add the wrapper implementation
     let cpp_files: Vec<_> = fs::read_dir("src/cxx_bindings")
         .expect("Failed to read cpp directory")
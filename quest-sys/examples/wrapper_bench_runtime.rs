@@ -0,0 +1,5 @@
+//! Not a runnable example: Cargo builds this as a static library holding the
+//! compiled wrappers and the cxx runtime, which the native `cxx_wrapper_bench`
+//! links so it times exactly the code Rust callers run. See "Benchmarks" in
+//! the README.
+pub use quest_sys::ffi;
@@ -0,0 +1,275 @@
+// Times each quest_sys wrapper against the raw QuEST call it forwards to, on
+// the same inputs, so the difference is the wrapper's own cost: slice
+// conversions, std::unique_ptr wrapping and the temporaries built for nested
+// matrix inputs. Register workloads run on statevectors of every size given
+// on the command line (default 4 12 20); small registers expose the wrapper
+// cost, large ones show how little of a kernel it is. The wrappers and the cxx
+// runtime come from the Cargo-built wrapper_bench_runtime library, so slice
+// accesses cost what they cost when called from Rust.
+//
+// usage: cxx_wrapper_bench [numQubits...]
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "calculations.hpp"
+#include "channels.hpp"
+#include "environment.hpp"
+#include "matrices.hpp"
+#include "operations.hpp"
+#include "qureg.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr auto min_round_time = std::chrono::milliseconds(5);
+constexpr int num_rounds = 15;
+
+// Median over rounds of the mean time per call, in nanoseconds. The calls per
+// round double until one round takes at least min_round_time.
+double time_per_call(const std::function<void()>& func) {
+  func();
+  long calls = 1;
+  while (true) {
+    auto start = Clock::now();
+    for (long i = 0; i < calls; ++i) {
+      func();
+    }
+    if (Clock::now() - start >= min_round_time) {
+      break;
+    }
+    calls *= 2;
+  }
+
+  std::array<double, num_rounds> rounds{};
+  for (auto& round : rounds) {
+    auto start = Clock::now();
+    for (long i = 0; i < calls; ++i) {
+      func();
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    round = elapsed.count() / static_cast<double>(calls);
+  }
+  std::ranges::nth_element(rounds, rounds.begin() + num_rounds / 2);
+  return rounds[num_rounds / 2];
+}
+
+void report(const std::string& workload,
+            int numQubits,
+            const std::function<void()>& wrapped,
+            const std::function<void()>& raw) {
+  double wrappedNs = time_per_call(wrapped);
+  double rawNs = time_per_call(raw);
+  std::printf("%-44s %6d %12.1f %12.1f %10.1f %8.1f%%\n", workload.c_str(),
+              numQubits, wrappedNs, rawNs, wrappedNs - rawNs,
+              100.0 * (wrappedNs - rawNs) / rawNs);
+}
+
+// A real rotation on the first two basis states, identity elsewhere
+std::vector<Quest_Complex> rotation(std::size_t dim) {
+  std::vector<Quest_Complex> m(dim * dim);
+  for (std::size_t i = 0; i < dim; ++i) {
+    m[i * dim + i] = qcomp(1, 0);
+  }
+  m[0] = qcomp(0.8, 0);
+  m[1] = qcomp(-0.6, 0);
+  m[dim] = qcomp(0.6, 0);
+  m[dim + 1] = qcomp(0.8, 0);
+  return m;
+}
+
+const void* volatile sink = nullptr;
+
+// Stops the compiler discarding a result it can see is unused
+void keep(const void* value) {
+  sink = value;
+}
+
+// Row pointers into a row-major matrix, as rust::Slice rows and qcomp rows
+struct Rows {
+  std::vector<rust::Slice<const Quest_Complex>> slices;
+  std::vector<qcomp*> pointers;
+
+  Rows(Quest_Complex* first, std::size_t dim) {
+    for (std::size_t r = 0; r < dim; ++r) {
+      slices.emplace_back(first + r * dim, dim);
+      pointers.push_back(Quest_Complex::to_qcomp_ptr(first + r * dim));
+    }
+  }
+
+  rust::Slice<const rust::Slice<const Quest_Complex>> slice() const {
+    return {slices.data(), slices.size()};
+  }
+};
+
+void register_workloads(int numQubits) {
+  Qureg qureg = ::createQureg(numQubits);
+  ::initPlusState(qureg);
+
+  auto flat1 = rotation(2);
+  auto flat3 = rotation(8);
+  CompMatr1 m1 = ::getCompMatr1(Rows(flat1.data(), 2).pointers.data());
+  CompMatr m3 = ::createCompMatr(3);
+  ::setCompMatr(m3, Rows(flat3.data(), 8).pointers.data());
+
+  std::array<int, 2> controls{0, 1};
+  std::array<int, 3> targets{0, 1, numQubits - 1};
+  std::array<int, 2> outcomes{0, 0};
+  const int last = numQubits - 1;
+
+  report(
+      "applyHadamard", numQubits,
+      [&] { quest_sys::applyHadamard(qureg, last); },
+      [&] { ::applyHadamard(qureg, last); });
+
+  rust::Slice<const int> controlSlice(controls.data(), controls.size());
+  report(
+      "applyMultiControlledCompMatr1 (slice)", numQubits,
+      [&] {
+        quest_sys::applyMultiControlledCompMatr1(qureg, controlSlice, last, m1);
+      },
+      [&] {
+        ::applyMultiControlledCompMatr1(qureg, controls.data(), 2, last, m1);
+      });
+
+  rust::Slice<const int> targetSlice(targets.data(), targets.size());
+  report(
+      "applyCompMatr 3q (slice)", numQubits,
+      [&] { quest_sys::applyCompMatr(qureg, targetSlice, m3); },
+      [&] { ::applyCompMatr(qureg, targets.data(), 3, m3); });
+
+  rust::Slice<const int> outcomeSlice(outcomes.data(), outcomes.size());
+  report(
+      "calcProbOfMultiQubitOutcome (two slices)", numQubits,
+      [&] {
+        quest_sys::calcProbOfMultiQubitOutcome(qureg, controlSlice,
+                                               outcomeSlice);
+      },
+      [&] {
+        ::calcProbOfMultiQubitOutcome(qureg, controls.data(), outcomes.data(),
+                                      2);
+      });
+
+  std::vector<Quest_Complex> amps(std::size_t{1} << numQubits);
+  rust::Slice<Quest_Complex> ampSlice(amps.data(), amps.size());
+  report(
+      "getQuregAmpsInto (slice)", numQubits,
+      [&] { quest_sys::getQuregAmpsInto(qureg, 0, ampSlice); },
+      [&] {
+        ::getQuregAmps(Quest_Complex::to_qcomp_ptr(amps.data()), qureg, 0,
+                       static_cast<qindex>(amps.size()));
+      });
+
+  report(
+      "createQureg + destroyQureg (unique_ptr)", numQubits,
+      [&] {
+        auto q = quest_sys::createQureg(numQubits);
+        quest_sys::destroyQureg(*q);
+      },
+      [&] {
+        Qureg q = ::createQureg(numQubits);
+        ::destroyQureg(q);
+      });
+
+  ::destroyCompMatr(m3);
+  ::destroyQureg(qureg);
+}
+
+void matrix_workloads() {
+  auto flat1 = rotation(2);
+  Rows rows1(flat1.data(), 2);
+  report(
+      "getCompMatr1 (row vector, unique_ptr)", 0,
+      [&] { keep(quest_sys::getCompMatr1(rows1.slice()).get()); },
+      [&] {
+        CompMatr1 m = ::getCompMatr1(rows1.pointers.data());
+        keep(&m);
+      });
+
+  rust::Slice<const Quest_Complex> flatSlice1(flat1.data(), flat1.size());
+  report(
+      "getCompMatr1Flat (unique_ptr)", 0,
+      [&] { keep(quest_sys::getCompMatr1Flat(flatSlice1).get()); },
+      [&] {
+        CompMatr1 m = ::getCompMatr1(rows1.pointers.data());
+        keep(&m);
+      });
+
+  auto flat3 = rotation(8);
+  Rows rows3(flat3.data(), 8);
+  CompMatr m3 = ::createCompMatr(3);
+  report(
+      "setCompMatr 3q (row vector)", 0,
+      [&] { quest_sys::setCompMatr(m3, rows3.slice()); },
+      [&] { ::setCompMatr(m3, rows3.pointers.data()); });
+  ::destroyCompMatr(m3);
+}
+
+void channel_workloads() {
+  // Dephasing as two Kraus operators, sqrt(0.9) I and sqrt(0.1) Z
+  const double keepAmp = 0.9486832980505138;
+  const double flipAmp = 0.31622776601683794;
+  std::vector<Quest_Complex> flat{
+      qcomp(keepAmp, 0), qcomp(0, 0), qcomp(0, 0), qcomp(keepAmp, 0),
+      qcomp(flipAmp, 0), qcomp(0, 0), qcomp(0, 0), qcomp(-flipAmp, 0)};
+  std::array<Rows, 2> rows{Rows(flat.data(), 2), Rows(flat.data() + 4, 2)};
+  std::array<rust::Slice<const rust::Slice<const Quest_Complex>>, 2> ops{
+      rows[0].slice(), rows[1].slice()};
+  rust::Slice<const rust::Slice<const rust::Slice<const Quest_Complex>>>
+      opSlice(ops.data(), ops.size());
+  std::array<qcomp**, 2> opPointers{rows[0].pointers.data(),
+                                    rows[1].pointers.data()};
+  rust::Slice<const Quest_Complex> flatSlice(flat.data(), flat.size());
+
+  KrausMap map = ::createKrausMap(1, 2);
+  report(
+      "setKrausMap 1q (nested vectors)", 0,
+      [&] { quest_sys::setKrausMap(map, opSlice); },
+      [&] { ::setKrausMap(map, opPointers.data()); });
+  report(
+      "setKrausMapFlat 1q", 0,
+      [&] {
+        quest_sys::setKrausMapFlat(map, flatSlice);
+        ::syncKrausMap(map);
+      },
+      [&] { ::setKrausMap(map, opPointers.data()); });
+  ::destroyKrausMap(map);
+
+  report(
+      "createKrausMap + destroyKrausMap (unique_ptr)", 0,
+      [&] {
+        auto m = quest_sys::createKrausMap(1, 2);
+        quest_sys::destroyKrausMap(*m);
+      },
+      [&] {
+        KrausMap m = ::createKrausMap(1, 2);
+        ::destroyKrausMap(m);
+      });
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) {
+    sizes.push_back(std::atoi(argv[i]));
+  }
+  if (sizes.empty()) {
+    sizes = {4, 12, 20};
+  }
+
+  ::initQuESTEnv();
+  std::printf("%-44s %6s %12s %12s %10s %9s\n", "workload", "qubits",
+              "wrapper ns", "raw ns", "overhead", "relative");
+  for (int numQubits : sizes) {
+    register_workloads(std::max(numQubits, 3));
+  }
+  matrix_workloads();
+  channel_workloads();
+  ::finalizeQuESTEnv();
+  return 0;
+}
@@ -1,42 +1,146 @@
 #include "calculations.hpp"
 #include "helper.hpp"
+#include "profiling.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
 
 namespace quest_sys {
+namespace {
+// The marginal distribution of the measured qubits, clamped and normalised
+// against rounding. Empty after reporting an error.
+std::vector<Quest_Real> outcome_distribution(const Qureg& qureg,
+                                             rust::Slice<const int> qubits,
+                                             const char* caller) {
+  if (qubits.empty() ||
+      qubits.length() > static_cast<std::size_t>(qureg.numQubits)) {
+    ::invalidQuESTInputError(
+        "The number of sampled qubits must be between one and the width of "
+        "the Qureg.",
+        caller);
+    return {};
+  }
+  std::vector<Quest_Real> probs(Quest_Index{1} << qubits.length());
+  ::calcProbsOfAllMultiQubitOutcomes(probs.data(), qureg,
+                                     quest_helper::slice_to_ptr(qubits),
+                                     static_cast<int>(qubits.length()));
+  Quest_Real total = 0;
+  for (auto& prob : probs) {
+    prob = std::max<Quest_Real>(prob, 0);
+    total += prob;
+  }
+  if (total <= 0) {
+    ::invalidQuESTInputError("The Qureg has zero total probability.", caller);
+    return {};
+  }
+  for (auto& prob : probs) {
+    prob /= total;
+  }
+  return probs;
+}
+
+// Mixes the seeds last passed to setSeeds with the per-call seed, so samples
+// repeat whenever both do
+std::mt19937_64 sampling_rng(std::uint64_t seed) {
+  std::vector<unsigned> seeds(static_cast<std::size_t>(::getNumSeeds()));
+  ::getSeeds(seeds.data());
+  seeds.push_back(static_cast<unsigned>(seed));
+  seeds.push_back(static_cast<unsigned>(seed >> 32));
+  std::seed_seq seq(seeds.begin(), seeds.end());
+  return std::mt19937_64(seq);
+}
+
+// Vose's alias method: O(n) construction, then O(1) per draw
+class AliasTable {
+ public:
+  explicit AliasTable(const std::vector<Quest_Real>& probs)
+      : threshold_(probs.size()), alias_(probs.size()) {
+    auto n = probs.size();
+    std::vector<std::size_t> small;
+    std::vector<std::size_t> large;
+    std::vector<Quest_Real> scaled(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      scaled[i] = probs[i] * static_cast<Quest_Real>(n);
+      (scaled[i] < 1 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      auto s = small.back();
+      small.pop_back();
+      auto l = large.back();
+      threshold_[s] = scaled[s];
+      alias_[s] = l;
+      scaled[l] -= 1 - scaled[s];
+      if (scaled[l] < 1) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // Leftovers are 1 up to rounding
+    for (auto i : small) {
+      threshold_[i] = 1;
+    }
+    for (auto i : large) {
+      threshold_[i] = 1;
+    }
+  }
+
+  std::size_t operator()(std::mt19937_64& rng) const {
+    std::uniform_int_distribution<std::size_t> column(0, alias_.size() - 1);
+    std::uniform_real_distribution<Quest_Real> coin(0, 1);
+    auto i = column(rng);
+    return coin(rng) < threshold_[i] ? i : alias_[i];
+  }
+
+ private:
+  std::vector<Quest_Real> threshold_;
+  std::vector<std::size_t> alias_;
+};
+}  // namespace
+
 // Calculations
 Quest_Real calcExpecPauliStr(const Qureg& qureg, const PauliStr& str) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcExpecPauliStr(qureg, str);
 }
 
 Quest_Real calcExpecPauliStrSum(const Qureg& qureg, const PauliStrSum& sum) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcExpecPauliStrSum(qureg, sum);
 }
 
 Quest_Real calcExpecFullStateDiagMatr(const Qureg& qureg,
                                       const FullStateDiagMatr& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcExpecFullStateDiagMatr(qureg, matr);
 }
 
 Quest_Real calcExpecFullStateDiagMatrPower(const Qureg& qureg,
                                            const FullStateDiagMatr& matr,
                                            Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcExpecFullStateDiagMatrPower(qureg, matr, exponent);
 }
 
 Quest_Real calcTotalProb(const Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcTotalProb(qureg);
 }
 
 Quest_Real calcProbOfBasisState(const Qureg& qureg, Quest_Index index) {
+  QUEST_SYS_PROFILE(sizeof(qcomp));
   return ::calcProbOfBasisState(qureg, index);
 }
 
 Quest_Real calcProbOfQubitOutcome(const Qureg& qureg, int qubit, int outcome) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcProbOfQubitOutcome(qureg, qubit, outcome);
 }
 
 Quest_Real calcProbOfMultiQubitOutcome(const Qureg& qureg,
                                        rust::Slice<const int> qubits,
                                        rust::Slice<const int> outcomes) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcProbOfMultiQubitOutcome(
       qureg, quest_helper::slice_to_ptr(qubits),
       quest_helper::slice_to_ptr(outcomes), static_cast<int>(qubits.length()));
@@ -45,25 +149,89 @@ Quest_Real calcProbOfMultiQubitOutcome(const Qureg& qureg,
 void calcProbsOfAllMultiQubitOutcomes(rust::Slice<Quest_Real> outcomeProbs,
                                       const Qureg& qureg,
                                       rust::Slice<const int> qubits) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcProbsOfAllMultiQubitOutcomes(outcomeProbs.data(), qureg,
                                             quest_helper::slice_to_ptr(qubits),
                                             static_cast<int>(qubits.length()));
 }
 
+rust::Vec<Quest_Index> sampleMultiQubitOutcomes(const Qureg& qureg,
+                                               rust::Slice<const int> qubits,
+                                               std::uint64_t numShots,
+                                               std::uint64_t seed) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
+  rust::Vec<Quest_Index> out;
+  auto probs = outcome_distribution(qureg, qubits, __func__);
+  if (probs.empty()) {
+    return out;
+  }
+  AliasTable table(probs);
+  auto rng = sampling_rng(seed);
+  out.reserve(static_cast<std::size_t>(numShots));
+  for (std::uint64_t shot = 0; shot < numShots; ++shot) {
+    out.push_back(static_cast<Quest_Index>(table(rng)));
+  }
+  return out;
+}
+
+void sampleMultiQubitOutcomeCounts(rust::Slice<std::uint64_t> counts,
+                                   const Qureg& qureg,
+                                   rust::Slice<const int> qubits,
+                                   std::uint64_t numShots,
+                                   std::uint64_t seed) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
+  auto probs = outcome_distribution(qureg, qubits, __func__);
+  if (probs.empty()) {
+    return;
+  }
+  if (counts.length() != probs.size()) {
+    ::invalidQuESTInputError(
+        "The counts buffer must have one entry per outcome.", __func__);
+    return;
+  }
+  // A multinomial draw as a chain of binomials, so the cost is independent
+  // of the number of shots
+  auto rng = sampling_rng(seed);
+  auto remaining = numShots;
+  Quest_Real remainingProb = 1;
+  for (std::size_t i = 0; i < probs.size(); ++i) {
+    std::uint64_t count = 0;
+    if (i + 1 == probs.size()) {
+      count = remaining;
+    } else if (remaining > 0 && probs[i] > 0) {
+      auto p = std::min<Quest_Real>(probs[i] / remainingProb, 1);
+      count = std::binomial_distribution<std::uint64_t>(remaining, p)(rng);
+    }
+    counts[i] = count;
+    remaining -= count;
+    remainingProb -= probs[i];
+    if (remainingProb <= 0) {
+      std::fill(counts.begin() + static_cast<std::ptrdiff_t>(i) + 1,
+                counts.end(), 0);
+      counts[i] += remaining;
+      return;
+    }
+  }
+}
+
 Quest_Real calcPurity(const Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcPurity(qureg);
 }
 
 Quest_Real calcFidelity(const Qureg& qureg, const Qureg& other) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcFidelity(qureg, other);
 }
 
 Quest_Real calcDistance(const Qureg& qureg1, const Qureg& qureg2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg1));
   return ::calcDistance(qureg1, qureg2);
 }
 
 std::unique_ptr<Qureg> calcPartialTrace(const Qureg& qureg,
                                         rust::Slice<const int> traceOutQubits) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return std::make_unique<Qureg>(
       ::calcPartialTrace(qureg, quest_helper::slice_to_ptr(traceOutQubits),
                          static_cast<int>(traceOutQubits.length())));
@@ -72,6 +240,7 @@ std::unique_ptr<Qureg> calcPartialTrace(const Qureg& qureg,
 std::unique_ptr<Qureg> calcReducedDensityMatrix(
     const Qureg& qureg,
     rust::Slice<const int> retainQubits) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return std::make_unique<Qureg>(::calcReducedDensityMatrix(
       qureg, quest_helper::slice_to_ptr(retainQubits),
       static_cast<int>(retainQubits.length())));
@@ -80,6 +249,7 @@ std::unique_ptr<Qureg> calcReducedDensityMatrix(
 void setQuregToPartialTrace(Qureg& out,
                             const Qureg& in,
                             rust::Slice<const int> traceOutQubits) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(out));
   ::setQuregToPartialTrace(out, in, quest_helper::slice_to_ptr(traceOutQubits),
                            static_cast<int>(traceOutQubits.length()));
 }
@@ -87,23 +257,27 @@ void setQuregToPartialTrace(Qureg& out,
 void setQuregToReducedDensityMatrix(Qureg& out,
                                     const Qureg& in,
                                     rust::Slice<const int> retainQubits) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(out));
   ::setQuregToReducedDensityMatrix(out, in,
                                    quest_helper::slice_to_ptr(retainQubits),
                                    static_cast<int>(retainQubits.length()));
 }
 
 Quest_Complex calcInnerProduct(const Qureg& qureg1, const Qureg& qureg2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg1));
   return ::calcInnerProduct(qureg1, qureg2);
 }
 
 Quest_Complex calcExpecNonHermitianPauliStrSum(const Qureg& qureg,
                                                const PauliStrSum& sum) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcExpecNonHermitianPauliStrSum(qureg, sum);
 }
 
 Quest_Complex calcExpecNonHermitianFullStateDiagMatr(
     const Qureg& qureg,
     const FullStateDiagMatr& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcExpecNonHermitianFullStateDiagMatr(qureg, matr);
 }
 
@@ -111,6 +285,7 @@ Quest_Complex calcExpecNonHermitianFullStateDiagMatrPower(
     const Qureg& qureg,
     const FullStateDiagMatr& matrix,
     Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::calcExpecNonHermitianFullStateDiagMatrPower(qureg, matrix, exponent);
 }
 }  // namespace quest_sys
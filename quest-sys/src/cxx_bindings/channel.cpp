@@ -5,6 +5,20 @@
 #include "helper.hpp"
 
 namespace quest_sys {
+namespace {
+bool validate_flat_length(std::size_t length,
+                          Quest_Index expected,
+                          const char* caller) {
+  if (static_cast<Quest_Index>(length) != expected) {
+    ::invalidQuESTInputError(
+        "The number of elements does not match the channel dimensions.",
+        caller);
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
 std::unique_ptr<KrausMap> createKrausMap(int numQubits, int numOperators) {
   return std::make_unique<KrausMap>(::createKrausMap(numQubits, numOperators));
 }
@@ -68,4 +82,49 @@ std::unique_ptr<SuperOp> createInlineSuperOp(
   return std::make_unique<SuperOp>(
       ::createInlineSuperOp(numQubits, std::move(mat)));
 }
+
+void setKrausMapFlat(KrausMap& map, rust::Slice<const Quest_Complex> matrices) {
+  const Quest_Index dim = map.numRows;
+  if (!validate_flat_length(matrices.length(), map.numMatrices * dim * dim,
+                            __func__)) {
+    return;
+  }
+  // Rows are written in place; syncKrausMap then rebuilds the superoperator
+  const qcomp* in =
+      Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(matrices));
+  for (int k = 0; k < map.numMatrices; ++k) {
+    for (Quest_Index r = 0; r < dim; ++r) {
+      std::copy_n(in + (k * dim + r) * dim, dim, map.matrices[k][r]);
+    }
+  }
+  ::syncKrausMap(map);
+}
+
+void setSuperOpFlat(SuperOp& op, rust::Slice<const Quest_Complex> matrix) {
+  const Quest_Index dim = op.numRows;
+  if (!validate_flat_length(matrix.length(), dim * dim, __func__)) {
+    return;
+  }
+  std::copy_n(Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(matrix)),
+              dim * dim, op.cpuElemsFlat);
+  ::syncSuperOp(op);
+}
+
+std::unique_ptr<KrausMap> createInlineKrausMapFlat(
+    int numQubits,
+    int numOperators,
+    rust::Slice<const Quest_Complex> matrices) {
+  auto map = std::make_unique<KrausMap>(
+      ::createKrausMap(numQubits, numOperators));
+  setKrausMapFlat(*map, matrices);
+  return map;
+}
+
+std::unique_ptr<SuperOp> createInlineSuperOpFlat(
+    int numQubits,
+    rust::Slice<const Quest_Complex> matrix) {
+  auto op = std::make_unique<SuperOp>(::createSuperOp(numQubits));
+  setSuperOpFlat(*op, matrix);
+  return op;
+}
 }  // namespace quest_sys
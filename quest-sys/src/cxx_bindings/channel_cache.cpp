@@ -0,0 +1,148 @@
+#include "channel_cache.hpp"
+#include "helper.hpp"
+
+#include <cstring>
+
+namespace quest_sys {
+ChannelCache::~ChannelCache() {
+  clear();
+}
+
+std::uint64_t ChannelCache::insertKrausMap(int numQubits,
+                                           int numOperators,
+                                           const qcomp* matrices,
+                                           std::size_t numElems) {
+  quest_helper::Hasher hasher;
+  hasher.update(&numQubits, sizeof(numQubits));
+  hasher.update(&numOperators, sizeof(numOperators));
+  hasher.update(matrices, numElems * sizeof(qcomp));
+  std::uint64_t key = hasher.digest();
+
+  auto [first, last] = handlesByKey_.equal_range(key);
+  for (auto it = first; it != last; ++it) {
+    const Entry& entry = entries_.at(it->second);
+    if (entry.numQubits == numQubits && entry.numOperators == numOperators &&
+        entry.matrices.size() == numElems &&
+        std::memcmp(entry.matrices.data(), matrices,
+                    numElems * sizeof(qcomp)) == 0) {
+      return it->second;
+    }
+  }
+
+  // A miss pays for the superoperator construction exactly once
+  auto map = ::createKrausMap(numQubits, numOperators);
+  const std::size_t dim = static_cast<std::size_t>(map.numRows);
+  for (int k = 0; k < numOperators; ++k) {
+    for (std::size_t r = 0; r < dim; ++r) {
+      std::copy_n(matrices + (static_cast<std::size_t>(k) * dim + r) * dim,
+                  dim, map.matrices[k][r]);
+    }
+  }
+  ::syncKrausMap(map);
+
+  // host memory: the key copy, the operators and the superoperator
+  std::size_t superopElems = dim * dim * dim * dim;
+  std::size_t bytes = (2 * numElems + superopElems) * sizeof(qcomp);
+
+  std::uint64_t handle = nextHandle_++;
+  entries_.emplace(handle,
+                   Entry{key, numQubits, numOperators,
+                         std::vector<qcomp>(matrices, matrices + numElems),
+                         map, bytes});
+  handlesByKey_.emplace(key, handle);
+  numBytes_ += bytes;
+  return handle;
+}
+
+const KrausMap* ChannelCache::find(std::uint64_t handle) const {
+  auto it = entries_.find(handle);
+  return it == entries_.end() ? nullptr : &it->second.map;
+}
+
+bool ChannelCache::evict(std::uint64_t handle) {
+  auto it = entries_.find(handle);
+  if (it == entries_.end()) {
+    return false;
+  }
+  auto [first, last] = handlesByKey_.equal_range(it->second.key);
+  for (auto byKey = first; byKey != last; ++byKey) {
+    if (byKey->second == handle) {
+      handlesByKey_.erase(byKey);
+      break;
+    }
+  }
+  ::destroyKrausMap(it->second.map);
+  numBytes_ -= it->second.numBytes;
+  entries_.erase(it);
+  return true;
+}
+
+void ChannelCache::clear() {
+  for (auto& [handle, entry] : entries_) {
+    ::destroyKrausMap(entry.map);
+  }
+  entries_.clear();
+  handlesByKey_.clear();
+  numBytes_ = 0;
+}
+
+// Channel cache
+std::unique_ptr<ChannelCache> createChannelCache() {
+  return std::make_unique<ChannelCache>();
+}
+
+std::uint64_t cacheKrausMap(ChannelCache& cache,
+                            int numQubits,
+                            int numOperators,
+                            rust::Slice<const Quest_Complex> matrices) {
+  if (numQubits < 1 || numOperators < 1 || numQubits > 15) {
+    ::invalidQuESTInputError("Invalid Kraus map dimensions.", __func__);
+    return 0;
+  }
+  auto dim = std::size_t{1} << numQubits;
+  if (matrices.length() != static_cast<std::size_t>(numOperators) * dim * dim) {
+    ::invalidQuESTInputError(
+        "The number of elements does not match the channel dimensions.",
+        __func__);
+    return 0;
+  }
+  return cache.insertKrausMap(
+      numQubits, numOperators,
+      Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(matrices)),
+      matrices.length());
+}
+
+const KrausMap& getCachedKrausMap(const ChannelCache& cache,
+                                  std::uint64_t handle) {
+  const KrausMap* map = cache.find(handle);
+  if (map == nullptr) {
+    ::invalidQuESTInputError("Unknown or evicted channel cache handle.",
+                             __func__);
+    // for error handlers that return; QuEST rejects the unallocated map
+    static const KrausMap missing{};
+    return missing;
+  }
+  return *map;
+}
+
+const SuperOp& getCachedSuperOp(const ChannelCache& cache,
+                                std::uint64_t handle) {
+  return getCachedKrausMap(cache, handle).superop;
+}
+
+bool evictCachedChannel(ChannelCache& cache, std::uint64_t handle) {
+  return cache.evict(handle);
+}
+
+void clearChannelCache(ChannelCache& cache) {
+  cache.clear();
+}
+
+std::size_t getChannelCacheNumEntries(const ChannelCache& cache) {
+  return cache.numEntries();
+}
+
+std::size_t getChannelCacheBytes(const ChannelCache& cache) {
+  return cache.numBytes();
+}
+}  // namespace quest_sys
@@ -0,0 +1,260 @@
+#include "checkpoint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "helper.hpp"
+#include "initialisation.hpp"
+#include "mapped_file.hpp"
+
+// Checkpoint layout, in native byte order:
+//   [0, 64)              CheckpointHeader
+//   [64, payloadOffset)  zero padding up to a page boundary
+//   [payloadOffset, ..)  numAmps raw qcomp amplitudes, in QuEST's flat order
+//                        (column-major for density matrices)
+
+namespace quest_sys {
+namespace {
+constexpr std::array<char, 8> checkpoint_magic = {'Q', 'S', 'Y', 'S',
+                                                  'C', 'K', 'P', 'T'};
+constexpr std::uint32_t checkpoint_version = 1;
+constexpr std::uint64_t checkpoint_alignment = 4096;
+constexpr std::uint32_t checkpoint_has_checksum = 1u;
+
+// Amplitudes moved per chunk: 64 MiB at double precision
+constexpr Quest_Index checkpoint_chunk_amps = Quest_Index{1} << 22;
+
+struct CheckpointHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t headerBytes;
+  std::uint32_t numQubits;
+  std::uint32_t isDensityMatrix;
+  std::uint32_t ampBytes;
+  std::uint32_t flags;
+  std::uint64_t numAmps;
+  std::uint64_t payloadOffset;
+  std::uint64_t checksum;
+  std::uint64_t reserved;
+};
+static_assert(sizeof(CheckpointHeader) == 64,
+              "Checkpoint header must stay 64 bytes");
+
+// Reads (or validates) the header at the front of a mapped checkpoint
+bool read_header(const quest_helper::MappedFile& file,
+                 CheckpointHeader& header,
+                 const char* caller) {
+  if (!file.is_open()) {
+    ::invalidQuESTInputError("Could not open the checkpoint file.", caller);
+    return false;
+  }
+  if (file.size() < sizeof(CheckpointHeader)) {
+    ::invalidQuESTInputError("The checkpoint file is truncated.", caller);
+    return false;
+  }
+  std::memcpy(&header, file.data(), sizeof(CheckpointHeader));
+  if (header.magic != checkpoint_magic ||
+      header.version != checkpoint_version) {
+    ::invalidQuESTInputError(
+        "The file is not a checkpoint written by this version of quest-sys.",
+        caller);
+    return false;
+  }
+  if (header.ampBytes != sizeof(qcomp)) {
+    ::invalidQuESTInputError(
+        "The checkpoint was written with a different floating-point "
+        "precision.",
+        caller);
+    return false;
+  }
+  // bounds are compared by division so a crafted header cannot wrap them
+  if (header.payloadOffset > file.size() ||
+      header.numAmps > (file.size() - header.payloadOffset) / header.ampBytes) {
+    ::invalidQuESTInputError("The checkpoint payload is truncated.", caller);
+    return false;
+  }
+  if (header.payloadOffset % alignof(qcomp) != 0) {
+    ::invalidQuESTInputError("The checkpoint payload is misaligned.", caller);
+    return false;
+  }
+  return true;
+}
+
+// Copies numAmps amplitudes of QuEST's flat order, beginning at startInd, out
+// of a distributed qureg. Every rank must call this.
+void read_distributed_amps(Qureg& qureg,
+                           Quest_Index startInd,
+                           Quest_Index numAmps,
+                           qcomp* out,
+                           std::vector<qcomp*>& rows) {
+  if (!qureg.isDensityMatrix) {
+    ::getQuregAmps(out, qureg, startInd, numAmps);
+    return;
+  }
+  // walk the flat range one column segment at a time
+  const Quest_Index dim = Quest_Index{1} << qureg.numQubits;
+  Quest_Index done = 0;
+  while (done < numAmps) {
+    Quest_Index flat = startInd + done;
+    Quest_Index row = flat % dim;
+    Quest_Index col = flat / dim;
+    Quest_Index len = std::min(dim - row, numAmps - done);
+    rows.resize(static_cast<std::size_t>(len));
+    for (Quest_Index r = 0; r < len; ++r) {
+      rows[static_cast<std::size_t>(r)] = out + done + r;
+    }
+    ::getDensityQuregAmps(rows.data(), qureg, row, col, len, 1);
+    done += len;
+  }
+}
+}  // namespace
+
+void saveQuregCheckpoint(Qureg& qureg, rust::String path, bool withChecksum) {
+  CheckpointHeader header{};
+  header.magic = checkpoint_magic;
+  header.version = checkpoint_version;
+  header.headerBytes = sizeof(CheckpointHeader);
+  header.numQubits = static_cast<std::uint32_t>(qureg.numQubits);
+  header.isDensityMatrix = static_cast<std::uint32_t>(qureg.isDensityMatrix);
+  header.ampBytes = sizeof(qcomp);
+  header.flags = withChecksum ? checkpoint_has_checksum : 0u;
+  header.numAmps = static_cast<std::uint64_t>(qureg.numAmps);
+  header.payloadOffset = checkpoint_alignment;
+
+  // only rank 0 writes, even when every rank holds the whole register; a
+  // distributed Qureg's ranks all take part in the gather
+  const bool mpi = ::getQuESTEnv().isDistributed;
+  const bool writer = ::getQuESTEnv().rank == 0;
+  std::FILE* file = writer ? std::fopen(path.c_str(), "wb") : nullptr;
+  bool opened = !writer || file != nullptr;
+  if (mpi) {
+    // the other ranks must not enter the gather if rank 0 cannot write
+    opened = quest_helper::root_flag(opened);
+  }
+  if (!opened) {
+    ::invalidQuESTInputError("Could not open the checkpoint file to write.",
+                             __func__);
+    return;
+  }
+
+  bool ok = true;
+  if (writer) {
+    std::vector<char> prefix(checkpoint_alignment, 0);
+    std::memcpy(prefix.data(), &header, sizeof(CheckpointHeader));
+    ok = std::fwrite(prefix.data(), 1, prefix.size(), file) == prefix.size();
+  }
+
+  quest_helper::Hasher hasher;
+  auto write_chunk = [&](const qcomp* amps, Quest_Index numAmps) {
+    if (!writer || !ok) {
+      return;
+    }
+    if (withChecksum) {
+      hasher.update(amps, static_cast<std::size_t>(numAmps) * sizeof(qcomp));
+    }
+    ok = std::fwrite(amps, sizeof(qcomp), static_cast<std::size_t>(numAmps),
+                     file) == static_cast<std::size_t>(numAmps);
+  };
+
+  if (!qureg.isDistributed) {
+    // the payload is written straight from the amplitude buffer
+    if (writer && qureg.isGpuAccelerated) {
+      ::syncQuregFromGpu(qureg);
+    }
+    for (Quest_Index start = 0; start < qureg.numAmps;
+         start += checkpoint_chunk_amps) {
+      write_chunk(qureg.cpuAmps + start,
+                  std::min<Quest_Index>(checkpoint_chunk_amps, qureg.numAmps - start));
+    }
+  } else {
+    std::vector<qcomp> buffer(static_cast<std::size_t>(
+        std::min<Quest_Index>(checkpoint_chunk_amps, qureg.numAmps)));
+    std::vector<qcomp*> rows;
+    for (Quest_Index start = 0; start < qureg.numAmps;
+         start += checkpoint_chunk_amps) {
+      Quest_Index len = std::min<Quest_Index>(checkpoint_chunk_amps, qureg.numAmps - start);
+      read_distributed_amps(qureg, start, len, buffer.data(), rows);
+      write_chunk(buffer.data(), len);
+    }
+  }
+
+  if (writer) {
+    if (ok && withChecksum) {
+      header.checksum = hasher.digest();
+      ok = std::fseek(file, 0, SEEK_SET) == 0 &&
+           std::fwrite(&header, sizeof(CheckpointHeader), 1, file) == 1;
+    }
+    ok = (std::fclose(file) == 0) && ok;
+  }
+  if (mpi) {
+    ok = quest_helper::root_flag(ok);
+  }
+  if (!ok) {
+    ::invalidQuESTInputError("Failed to write the checkpoint file.", __func__);
+  }
+}
+
+bool loadQuregCheckpoint(Qureg& qureg, rust::String path) {
+  quest_helper::MappedFile file(path.c_str());
+  CheckpointHeader header{};
+  if (!read_header(file, header, __func__)) {
+    return false;
+  }
+  if (header.numQubits != static_cast<std::uint32_t>(qureg.numQubits) ||
+      header.isDensityMatrix !=
+          static_cast<std::uint32_t>(qureg.isDensityMatrix) ||
+      header.numAmps != static_cast<std::uint64_t>(qureg.numAmps)) {
+    ::invalidQuESTInputError(
+        "The checkpoint was taken from a Qureg of a different size or type.",
+        __func__);
+    return false;
+  }
+
+  file.advise_sequential();
+  const auto* payload =
+      reinterpret_cast<const qcomp*>(file.data() + header.payloadOffset);
+
+  // the payload is verified before any of it is written, so a corrupt file
+  // leaves the Qureg untouched
+  if ((header.flags & checkpoint_has_checksum) != 0) {
+    quest_helper::Hasher hasher;
+    hasher.update(payload,
+                  static_cast<std::size_t>(qureg.numAmps) * sizeof(qcomp));
+    if (hasher.digest() != header.checksum) {
+      ::invalidQuESTInputError(
+          "The checkpoint payload does not match its checksum.", __func__);
+      return false;
+    }
+  }
+
+  for (Quest_Index start = 0; start < qureg.numAmps;
+       start += checkpoint_chunk_amps) {
+    Quest_Index len = std::min<Quest_Index>(checkpoint_chunk_amps, qureg.numAmps - start);
+    setQuregFlatAmps(qureg, start, payload + start, len);
+  }
+  return true;
+}
+
+std::unique_ptr<Qureg> createQuregFromCheckpoint(rust::String path) {
+  CheckpointHeader header{};
+  {
+    quest_helper::MappedFile file(path.c_str());
+    if (!read_header(file, header, __func__)) {
+      return nullptr;
+    }
+  }
+  auto numQubits = static_cast<int>(header.numQubits);
+  auto qureg = std::make_unique<Qureg>(header.isDensityMatrix
+                                           ? ::createDensityQureg(numQubits)
+                                           : ::createQureg(numQubits));
+  if (!loadQuregCheckpoint(*qureg, std::move(path))) {
+    // never hand back a register that silently holds the zero state
+    ::destroyQureg(*qureg);
+    return nullptr;
+  }
+  return qureg;
+}
+}  // namespace quest_sys
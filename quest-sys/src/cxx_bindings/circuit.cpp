@@ -0,0 +1,701 @@
+#include "circuit.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace quest_sys {
+namespace {
+struct GateInfo {
+  std::uint32_t minQubits;
+  std::uint32_t maxQubits;  // 0 for unbounded
+  std::uint32_t numParams;
+};
+
+constexpr std::array<GateInfo, static_cast<std::size_t>(GateKind::NumKinds)>
+    gate_info{{
+        {1, 1, 0},   // Hadamard
+        {1, 1, 0},   // PauliX
+        {1, 1, 0},   // PauliY
+        {1, 1, 0},   // PauliZ
+        {1, 1, 0},   // S
+        {1, 1, 0},   // T
+        {1, 1, 1},   // RotateX
+        {1, 1, 1},   // RotateY
+        {1, 1, 1},   // RotateZ
+        {1, 1, 1},   // PhaseShift
+        {1, 1, 4},   // RotateAroundAxis
+        {2, 2, 0},   // Swap
+        {2, 2, 0},   // SqrtSwap
+        {2, 0, 0},   // ControlledHadamard
+        {2, 0, 0},   // ControlledPauliX
+        {2, 0, 0},   // ControlledPauliY
+        {2, 0, 0},   // ControlledPauliZ
+        {2, 0, 1},   // ControlledRotateX
+        {2, 0, 1},   // ControlledRotateY
+        {2, 0, 1},   // ControlledRotateZ
+        {1, 0, 1},   // MultiQubitPhaseShift
+        {1, 0, 0},   // MultiQubitPhaseFlip
+        {1, 0, 1},   // PhaseGadget
+        {1, 1, 8},   // CompMatr1
+        {2, 2, 32},  // CompMatr2
+        {1, 1, 4},   // DiagMatr1
+        {2, 2, 8},   // DiagMatr2
+        {1, 12, 0},  // CompMatr, params depend on width
+        {1, 24, 0},  // DiagMatr, params depend on width
+        {1, 0, 0},   // FullStateDiagMatr, built by coalesceDiagonalGates
+    }};
+
+const GateInfo& info(GateKind kind) {
+  return gate_info[static_cast<std::size_t>(kind)];
+}
+
+// Reinterprets (re, im) parameter pairs as complex numbers
+void to_complex(const qreal* params, qcomp* out, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = qcomp(params[2 * i], params[2 * i + 1]);
+  }
+}
+
+// Unpacks a row-major square matrix and points `rows` into it
+template <std::size_t Dim>
+void to_square(const qreal* params,
+               std::array<qcomp, Dim * Dim>& elems,
+               std::array<qcomp*, Dim>& rows) {
+  to_complex(params, elems.data(), Dim * Dim);
+  for (std::size_t r = 0; r < Dim; ++r) {
+    rows[r] = elems.data() + r * Dim;
+  }
+}
+
+// Dispatches a single-target gate with a leading block of controls
+template <typename NoCtrl, typename OneCtrl, typename ManyCtrl>
+void apply_controlled(const int* qubits,
+                      std::uint32_t numQubits,
+                      NoCtrl&& noCtrl,
+                      OneCtrl&& oneCtrl,
+                      ManyCtrl&& manyCtrl) {
+  auto numCtrls = static_cast<int>(numQubits) - 1;
+  int target = qubits[numCtrls];
+  if (numCtrls == 0) {
+    noCtrl(target);
+  } else if (numCtrls == 1) {
+    oneCtrl(qubits[0], target);
+  } else {
+    manyCtrl(const_cast<int*>(qubits), numCtrls, target);
+  }
+}
+
+void apply_instruction(Qureg& qureg,
+                       const TapeInstruction& inst,
+                       const int* q,
+                       const qreal* p) {
+  auto* targets = const_cast<int*>(q);
+  auto numTargets = static_cast<int>(inst.numQubits);
+
+  switch (inst.kind) {
+    case GateKind::Hadamard:
+      ::applyHadamard(qureg, q[0]);
+      break;
+    case GateKind::PauliX:
+      ::applyPauliX(qureg, q[0]);
+      break;
+    case GateKind::PauliY:
+      ::applyPauliY(qureg, q[0]);
+      break;
+    case GateKind::PauliZ:
+      ::applyPauliZ(qureg, q[0]);
+      break;
+    case GateKind::S:
+      ::applyS(qureg, q[0]);
+      break;
+    case GateKind::T:
+      ::applyT(qureg, q[0]);
+      break;
+    case GateKind::RotateX:
+      ::applyRotateX(qureg, q[0], p[0]);
+      break;
+    case GateKind::RotateY:
+      ::applyRotateY(qureg, q[0], p[0]);
+      break;
+    case GateKind::RotateZ:
+      ::applyRotateZ(qureg, q[0], p[0]);
+      break;
+    case GateKind::PhaseShift:
+      ::applyPhaseShift(qureg, q[0], p[0]);
+      break;
+    case GateKind::RotateAroundAxis:
+      ::applyRotateAroundAxis(qureg, q[0], p[0], p[1], p[2], p[3]);
+      break;
+    case GateKind::Swap:
+      ::applySwap(qureg, q[0], q[1]);
+      break;
+    case GateKind::SqrtSwap:
+      ::applySqrtSwap(qureg, q[0], q[1]);
+      break;
+    case GateKind::ControlledHadamard:
+      apply_controlled(
+          q, inst.numQubits, [&](int t) { ::applyHadamard(qureg, t); },
+          [&](int c, int t) { ::applyControlledHadamard(qureg, c, t); },
+          [&](int* cs, int n, int t) {
+            ::applyMultiControlledHadamard(qureg, cs, n, t);
+          });
+      break;
+    case GateKind::ControlledPauliX:
+      apply_controlled(
+          q, inst.numQubits, [&](int t) { ::applyPauliX(qureg, t); },
+          [&](int c, int t) { ::applyControlledPauliX(qureg, c, t); },
+          [&](int* cs, int n, int t) {
+            ::applyMultiControlledPauliX(qureg, cs, n, t);
+          });
+      break;
+    case GateKind::ControlledPauliY:
+      apply_controlled(
+          q, inst.numQubits, [&](int t) { ::applyPauliY(qureg, t); },
+          [&](int c, int t) { ::applyControlledPauliY(qureg, c, t); },
+          [&](int* cs, int n, int t) {
+            ::applyMultiControlledPauliY(qureg, cs, n, t);
+          });
+      break;
+    case GateKind::ControlledPauliZ:
+      apply_controlled(
+          q, inst.numQubits, [&](int t) { ::applyPauliZ(qureg, t); },
+          [&](int c, int t) { ::applyControlledPauliZ(qureg, c, t); },
+          [&](int* cs, int n, int t) {
+            ::applyMultiControlledPauliZ(qureg, cs, n, t);
+          });
+      break;
+    case GateKind::ControlledRotateX:
+      apply_controlled(
+          q, inst.numQubits, [&](int t) { ::applyRotateX(qureg, t, p[0]); },
+          [&](int c, int t) { ::applyControlledRotateX(qureg, c, t, p[0]); },
+          [&](int* cs, int n, int t) {
+            ::applyMultiControlledRotateX(qureg, cs, n, t, p[0]);
+          });
+      break;
+    case GateKind::ControlledRotateY:
+      apply_controlled(
+          q, inst.numQubits, [&](int t) { ::applyRotateY(qureg, t, p[0]); },
+          [&](int c, int t) { ::applyControlledRotateY(qureg, c, t, p[0]); },
+          [&](int* cs, int n, int t) {
+            ::applyMultiControlledRotateY(qureg, cs, n, t, p[0]);
+          });
+      break;
+    case GateKind::ControlledRotateZ:
+      apply_controlled(
+          q, inst.numQubits, [&](int t) { ::applyRotateZ(qureg, t, p[0]); },
+          [&](int c, int t) { ::applyControlledRotateZ(qureg, c, t, p[0]); },
+          [&](int* cs, int n, int t) {
+            ::applyMultiControlledRotateZ(qureg, cs, n, t, p[0]);
+          });
+      break;
+    case GateKind::MultiQubitPhaseShift:
+      ::applyMultiQubitPhaseShift(qureg, targets, numTargets, p[0]);
+      break;
+    case GateKind::MultiQubitPhaseFlip:
+      ::applyMultiQubitPhaseFlip(qureg, targets, numTargets);
+      break;
+    case GateKind::PhaseGadget:
+      ::applyPhaseGadget(qureg, targets, numTargets, p[0]);
+      break;
+    case GateKind::CompMatr1: {
+      std::array<qcomp, 4> elems{};
+      std::array<qcomp*, 2> rows{};
+      to_square<2>(p, elems, rows);
+      ::applyCompMatr1(qureg, q[0], ::getCompMatr1(rows.data()));
+      break;
+    }
+    case GateKind::CompMatr2: {
+      std::array<qcomp, 16> elems{};
+      std::array<qcomp*, 4> rows{};
+      to_square<4>(p, elems, rows);
+      ::applyCompMatr2(qureg, q[0], q[1], ::getCompMatr2(rows.data()));
+      break;
+    }
+    case GateKind::DiagMatr1: {
+      std::array<qcomp, 2> elems{};
+      to_complex(p, elems.data(), elems.size());
+      ::applyDiagMatr1(qureg, q[0], ::getDiagMatr1(elems.data()));
+      break;
+    }
+    case GateKind::DiagMatr2: {
+      std::array<qcomp, 4> elems{};
+      to_complex(p, elems.data(), elems.size());
+      ::applyDiagMatr2(qureg, q[0], q[1], ::getDiagMatr2(elems.data()));
+      break;
+    }
+    case GateKind::CompMatr:
+    case GateKind::DiagMatr:
+    case GateKind::FullStateDiagMatr:
+    case GateKind::NumKinds:
+      break;
+  }
+}
+
+// Identity everywhere except `u` acting on the top operand when every lower
+// operand (the controls) is 1
+std::vector<qcomp> controlled(std::uint32_t numQubits,
+                              const std::vector<qcomp>& u) {
+  std::size_t dim = std::size_t{1} << numQubits;
+  std::size_t ctrlMask = (dim >> 1) - 1;
+  std::size_t shift = numQubits - 1;
+  std::vector<qcomp> out(dim * dim, qcomp(0, 0));
+  for (std::size_t r = 0; r < dim; ++r) {
+    for (std::size_t c = 0; c < dim; ++c) {
+      if ((r & ctrlMask) != (c & ctrlMask)) {
+        continue;
+      }
+      if ((r & ctrlMask) == ctrlMask) {
+        out[r * dim + c] = u[(r >> shift) * 2 + (c >> shift)];
+      } else if (r == c) {
+        out[r * dim + c] = qcomp(1, 0);
+      }
+    }
+  }
+  return out;
+}
+
+std::vector<qcomp> diagonal(const std::vector<qcomp>& diag) {
+  std::size_t dim = diag.size();
+  std::vector<qcomp> out(dim * dim, qcomp(0, 0));
+  for (std::size_t i = 0; i < dim; ++i) {
+    out[i * dim + i] = diag[i];
+  }
+  return out;
+}
+
+std::vector<qcomp> one_qubit(GateKind kind, const qreal* p) {
+  const qreal h = 1 / std::sqrt(qreal{2});
+  const qcomp i(0, 1);
+  switch (kind) {
+    case GateKind::Hadamard:
+    case GateKind::ControlledHadamard:
+      return {h, h, h, -h};
+    case GateKind::PauliX:
+    case GateKind::ControlledPauliX:
+      return {0, 1, 1, 0};
+    case GateKind::PauliY:
+    case GateKind::ControlledPauliY:
+      return {0, -i, i, 0};
+    case GateKind::PauliZ:
+    case GateKind::ControlledPauliZ:
+      return {1, 0, 0, -1};
+    case GateKind::S:
+      return {1, 0, 0, i};
+    case GateKind::T:
+      return {1, 0, 0, std::exp(i * (std::numbers::pi_v<qreal> / 4))};
+    case GateKind::RotateX:
+    case GateKind::ControlledRotateX: {
+      qreal c = std::cos(p[0] / 2), s = std::sin(p[0] / 2);
+      return {c, -i * s, -i * s, c};
+    }
+    case GateKind::RotateY:
+    case GateKind::ControlledRotateY: {
+      qreal c = std::cos(p[0] / 2), s = std::sin(p[0] / 2);
+      return {c, -s, s, c};
+    }
+    case GateKind::RotateZ:
+    case GateKind::ControlledRotateZ:
+      return {std::exp(-i * (p[0] / 2)), 0, 0, std::exp(i * (p[0] / 2))};
+    case GateKind::PhaseShift:
+      return {1, 0, 0, std::exp(i * p[0])};
+    case GateKind::RotateAroundAxis: {
+      // exp(-i angle/2 n.sigma) for the normalised axis n
+      qreal norm = std::sqrt(p[1] * p[1] + p[2] * p[2] + p[3] * p[3]);
+      qreal x = p[1] / norm, y = p[2] / norm, z = p[3] / norm;
+      qreal c = std::cos(p[0] / 2), s = std::sin(p[0] / 2);
+      return {qcomp(c, -z * s), qcomp(-y * s, -x * s), qcomp(y * s, -x * s),
+              qcomp(c, z * s)};
+    }
+    default:
+      return {};
+  }
+}
+}  // namespace
+
+std::vector<qcomp> gateKindMatrix(GateKind kind,
+                                  std::uint32_t numQubits,
+                                  const qreal* params) {
+  std::size_t dim = std::size_t{1} << numQubits;
+
+  switch (kind) {
+    case GateKind::Swap:
+      return {1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 1};
+    case GateKind::SqrtSwap: {
+      qcomp a(qreal{0.5}, qreal{0.5}), b(qreal{0.5}, qreal{-0.5});
+      return {1, 0, 0, 0, 0, a, b, 0, 0, b, a, 0, 0, 0, 0, 1};
+    }
+    case GateKind::ControlledHadamard:
+    case GateKind::ControlledPauliX:
+    case GateKind::ControlledPauliY:
+    case GateKind::ControlledPauliZ:
+    case GateKind::ControlledRotateX:
+    case GateKind::ControlledRotateY:
+    case GateKind::ControlledRotateZ:
+      return controlled(numQubits, one_qubit(kind, params));
+    case GateKind::CompMatr1:
+    case GateKind::CompMatr2:
+    case GateKind::CompMatr: {
+      std::vector<qcomp> out(dim * dim);
+      to_complex(params, out.data(), out.size());
+      return out;
+    }
+    default:
+      if (gateKindIsDiagonal(kind)) {
+        return diagonal(gateKindDiagonal(kind, numQubits, params));
+      }
+      return one_qubit(kind, params);
+  }
+}
+
+bool gateKindIsDiagonal(GateKind kind) {
+  switch (kind) {
+    case GateKind::PauliZ:
+    case GateKind::S:
+    case GateKind::T:
+    case GateKind::RotateZ:
+    case GateKind::PhaseShift:
+    case GateKind::ControlledPauliZ:
+    case GateKind::ControlledRotateZ:
+    case GateKind::MultiQubitPhaseShift:
+    case GateKind::MultiQubitPhaseFlip:
+    case GateKind::PhaseGadget:
+    case GateKind::DiagMatr1:
+    case GateKind::DiagMatr2:
+    case GateKind::DiagMatr:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool gateKindHasAngle(GateKind kind) {
+  switch (kind) {
+    case GateKind::RotateX:
+    case GateKind::RotateY:
+    case GateKind::RotateZ:
+    case GateKind::PhaseShift:
+    case GateKind::RotateAroundAxis:
+    case GateKind::ControlledRotateX:
+    case GateKind::ControlledRotateY:
+    case GateKind::ControlledRotateZ:
+    case GateKind::MultiQubitPhaseShift:
+    case GateKind::PhaseGadget:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::vector<qcomp> gateKindDiagonal(GateKind kind,
+                                    std::uint32_t numQubits,
+                                    const qreal* params) {
+  std::size_t dim = std::size_t{1} << numQubits;
+  std::size_t allOnes = dim - 1;
+  const qcomp i(0, 1);
+  std::vector<qcomp> diag(dim, qcomp(1, 0));
+
+  switch (kind) {
+    case GateKind::PauliZ:
+    case GateKind::S:
+    case GateKind::T:
+    case GateKind::RotateZ:
+    case GateKind::PhaseShift: {
+      auto u = one_qubit(kind, params);
+      diag = {u[0], u[3]};
+      break;
+    }
+    case GateKind::ControlledPauliZ:
+      diag[allOnes] = qcomp(-1, 0);
+      break;
+    case GateKind::ControlledRotateZ: {
+      // the controls select between identity and RotateZ on the top operand
+      std::size_t ctrlMask = allOnes >> 1;
+      diag[ctrlMask] = std::exp(-i * (params[0] / 2));
+      diag[allOnes] = std::exp(i * (params[0] / 2));
+      break;
+    }
+    case GateKind::MultiQubitPhaseShift:
+      diag[allOnes] = std::exp(i * params[0]);
+      break;
+    case GateKind::MultiQubitPhaseFlip:
+      diag[allOnes] = qcomp(-1, 0);
+      break;
+    case GateKind::PhaseGadget:
+      // exp(-i angle/2 Z...Z)
+      for (std::size_t k = 0; k < dim; ++k) {
+        qreal sign = std::popcount(k) % 2 ? -1 : 1;
+        diag[k] = std::exp(-i * (sign * params[0] / 2));
+      }
+      break;
+    case GateKind::DiagMatr1:
+    case GateKind::DiagMatr2:
+    case GateKind::DiagMatr:
+      to_complex(params, diag.data(), dim);
+      break;
+    default:
+      break;
+  }
+  return diag;
+}
+
+std::uint32_t gateKindNumParams(GateKind kind, std::uint32_t numQubits) {
+  if (kind == GateKind::CompMatr) {
+    return 2u << (2 * numQubits);
+  }
+  if (kind == GateKind::DiagMatr) {
+    return 2u << numQubits;
+  }
+  return info(kind).numParams;
+}
+
+CircuitTape::CircuitTape(std::vector<TapeInstruction> instructions,
+                         std::vector<int> qubits,
+                         std::vector<qreal> params,
+                         std::vector<FullStateDiagonal> fullStateDiagonals)
+    : instructions_(std::move(instructions)),
+      qubits_(std::move(qubits)),
+      params_(std::move(params)),
+      fullStateDiagonals_(std::move(fullStateDiagonals)) {
+  if (!qubits_.empty()) {
+    maxQubit_ = *std::max_element(qubits_.begin(), qubits_.end());
+  }
+  for (auto& inst : instructions_) {
+    const qreal* p = params_.data() + inst.paramOffset;
+    auto n = static_cast<int>(inst.numQubits);
+    if (inst.kind == GateKind::CompMatr) {
+      auto matr = ::createCompMatr(n);
+      to_complex(p, matr.cpuElemsFlat,
+                 static_cast<std::size_t>(matr.numRows * matr.numRows));
+      ::syncCompMatr(matr);
+      inst.matrixIndex = static_cast<std::int32_t>(compMatrices_.size());
+      compMatrices_.push_back(matr);
+    } else if (inst.kind == GateKind::DiagMatr) {
+      auto matr = ::createDiagMatr(n);
+      to_complex(p, matr.cpuElems, static_cast<std::size_t>(matr.numElems));
+      ::syncDiagMatr(matr);
+      inst.matrixIndex = static_cast<std::int32_t>(diagMatrices_.size());
+      diagMatrices_.push_back(matr);
+    }
+  }
+}
+
+CircuitTape::~CircuitTape() {
+  for (auto& matr : compMatrices_) {
+    ::destroyCompMatr(matr);
+  }
+  for (auto& matr : diagMatrices_) {
+    ::destroyDiagMatr(matr);
+  }
+  for (auto& diagonal : fullStateDiagonals_) {
+    ::destroyFullStateDiagMatr(diagonal.matr);
+  }
+  for (auto& [key, matr] : redeployed_) {
+    ::destroyFullStateDiagMatr(matr);
+  }
+}
+
+const ::FullStateDiagMatr& CircuitTape::fullStateMatrixFor(
+    std::size_t index,
+    const Qureg& qureg) const {
+  const auto& diagonal = fullStateDiagonals_[index];
+  if (diagonal.matr.isDistributed == qureg.isDistributed &&
+      diagonal.matr.isGpuAccelerated == qureg.isGpuAccelerated) {
+    return diagonal.matr;
+  }
+  // e.g. the local single-threaded workers of trajectory and sweep runs,
+  // which QuEST will not apply a distributed matrix to
+  std::lock_guard lock(redeployedMutex_);
+  auto key = std::tuple{index, qureg.isDistributed, qureg.isGpuAccelerated};
+  auto found = redeployed_.find(key);
+  if (found == redeployed_.end()) {
+    auto matr = ::createCustomFullStateDiagMatr(
+        diagonal.matr.numQubits, qureg.isDistributed, qureg.isGpuAccelerated);
+    Quest_Index offset =
+        matr.isDistributed ? ::getQuESTEnv().rank * matr.numElemsPerNode : 0;
+    diagonal.fill(qureg.isMultithreaded, offset, matr.numElemsPerNode,
+                  matr.cpuElems);
+    ::syncFullStateDiagMatr(matr);
+    found = redeployed_.emplace(key, matr).first;
+  }
+  return found->second;
+}
+
+void CircuitTape::apply(Qureg& qureg) const {
+  // Validate the register width once rather than in every gate
+  if (maxQubit_ >= qureg.numQubits) {
+    ::invalidQuESTInputError(
+        "The circuit tape targets qubits beyond the width of the Qureg.",
+        "applyCircuitTape");
+    return;
+  }
+  applyRange(qureg, 0, instructions_.size());
+}
+
+void CircuitTape::applyRange(Qureg& qureg,
+                             std::size_t begin,
+                             std::size_t end) const {
+  applyRange(qureg, begin, end, params_.data());
+}
+
+void CircuitTape::applyRange(Qureg& qureg,
+                             std::size_t begin,
+                             std::size_t end,
+                             const qreal* params) const {
+  for (std::size_t i = begin; i < end; ++i) {
+    const auto& inst = instructions_[i];
+    auto* targets = const_cast<int*>(qubits(inst));
+    auto numTargets = static_cast<int>(inst.numQubits);
+    auto cached = static_cast<std::size_t>(inst.matrixIndex);
+    switch (inst.kind) {
+      case GateKind::CompMatr:
+        ::applyCompMatr(qureg, targets, numTargets, compMatrices_[cached]);
+        break;
+      case GateKind::DiagMatr:
+        ::applyDiagMatr(qureg, targets, numTargets, diagMatrices_[cached]);
+        break;
+      case GateKind::FullStateDiagMatr:
+        ::applyFullStateDiagMatr(qureg, fullStateMatrixFor(cached, qureg));
+        break;
+      default:
+        apply_instruction(qureg, inst, qubits(inst),
+                          params + inst.paramOffset);
+    }
+  }
+}
+
+// Circuit tapes
+std::unique_ptr<CircuitTape> createCircuitTape(
+    rust::Slice<const std::uint32_t> opcodes,
+    rust::Slice<const std::uint32_t> arities,
+    rust::Slice<const int> qubits,
+    rust::Slice<const double> params) {
+  if (opcodes.length() != arities.length()) {
+    ::invalidQuESTInputError(
+        "Each circuit tape opcode must have exactly one arity.", __func__);
+    return nullptr;
+  }
+
+  std::vector<TapeInstruction> instructions;
+  instructions.reserve(opcodes.length());
+  std::size_t qubitOffset = 0;
+  std::size_t paramOffset = 0;
+
+  for (std::size_t i = 0; i < opcodes.length(); ++i) {
+    if (opcodes[i] >= static_cast<std::uint32_t>(GateKind::NumKinds)) {
+      ::invalidQuESTInputError("Unknown circuit tape opcode.", __func__);
+      return nullptr;
+    }
+    auto kind = static_cast<GateKind>(opcodes[i]);
+    if (kind == GateKind::FullStateDiagMatr) {
+      ::invalidQuESTInputError(
+          "FullStateDiagMatr instructions can only be made by "
+          "coalesceDiagonalGates.",
+          __func__);
+      return nullptr;
+    }
+    const auto& gate = info(kind);
+    std::uint32_t numQubits = arities[i];
+    if (numQubits < gate.minQubits ||
+        (gate.maxQubits != 0 && numQubits > gate.maxQubits)) {
+      ::invalidQuESTInputError(
+          "Invalid number of qubits for a circuit tape opcode.", __func__);
+      return nullptr;
+    }
+    std::uint32_t numParams = gateKindNumParams(kind, numQubits);
+    if (qubitOffset + numQubits > qubits.length() ||
+        paramOffset + numParams > params.length()) {
+      ::invalidQuESTInputError(
+          "The circuit tape operands are shorter than its opcodes require.",
+          __func__);
+      return nullptr;
+    }
+    instructions.push_back({kind, numQubits,
+                            static_cast<std::uint32_t>(qubitOffset),
+                            static_cast<std::uint32_t>(paramOffset)});
+    qubitOffset += numQubits;
+    paramOffset += numParams;
+  }
+
+  if (qubitOffset != qubits.length() || paramOffset != params.length()) {
+    ::invalidQuESTInputError(
+        "The circuit tape operands are longer than its opcodes require.",
+        __func__);
+    return nullptr;
+  }
+  if (std::any_of(qubits.begin(), qubits.end(), [](int q) { return q < 0; })) {
+    ::invalidQuESTInputError("Circuit tape qubit indices must be non-negative.",
+                             __func__);
+    return nullptr;
+  }
+
+  return std::make_unique<CircuitTape>(
+      std::move(instructions), std::vector<int>(qubits.begin(), qubits.end()),
+      std::vector<qreal>(params.begin(), params.end()));
+}
+
+CircuitTapeBuilder::~CircuitTapeBuilder() {
+  // only non-empty when build() was never reached
+  for (auto& diagonal : fullStateDiagonals_) {
+    ::destroyFullStateDiagMatr(diagonal.matr);
+  }
+}
+
+void CircuitTapeBuilder::copy(const CircuitTape& tape,
+                              const TapeInstruction& inst) {
+  if (inst.kind == GateKind::FullStateDiagMatr) {
+    // each tape destroys the matrices it owns, so they cannot be shared
+    const auto& source = tape.fullStateDiagonal(inst);
+    auto matr = ::createCustomFullStateDiagMatr(source.matr.numQubits,
+                                                source.matr.isDistributed,
+                                                source.matr.isGpuAccelerated);
+    std::copy_n(source.matr.cpuElems, source.matr.numElemsPerNode,
+                matr.cpuElems);
+    ::syncFullStateDiagMatr(matr);
+    pushFullStateDiagMatr(tape.qubits(inst), inst.numQubits,
+                          {matr, source.fill});
+    return;
+  }
+  push(inst.kind, tape.qubits(inst), inst.numQubits, tape.params(inst),
+       gateKindNumParams(inst.kind, inst.numQubits));
+}
+
+void CircuitTapeBuilder::push(GateKind kind,
+                              const int* qubits,
+                              std::uint32_t numQubits,
+                              const qreal* params,
+                              std::uint32_t numParams) {
+  instructions_.push_back({kind, numQubits,
+                           static_cast<std::uint32_t>(qubits_.size()),
+                           static_cast<std::uint32_t>(params_.size())});
+  qubits_.insert(qubits_.end(), qubits, qubits + numQubits);
+  params_.insert(params_.end(), params, params + numParams);
+}
+
+void CircuitTapeBuilder::pushFullStateDiagMatr(const int* qubits,
+                                               std::uint32_t numQubits,
+                                               FullStateDiagonal diagonal) {
+  push(GateKind::FullStateDiagMatr, qubits, numQubits, nullptr, 0);
+  instructions_.back().matrixIndex =
+      static_cast<std::int32_t>(fullStateDiagonals_.size());
+  fullStateDiagonals_.push_back(std::move(diagonal));
+}
+
+std::unique_ptr<CircuitTape> CircuitTapeBuilder::build() {
+  return std::make_unique<CircuitTape>(
+      std::move(instructions_), std::move(qubits_), std::move(params_),
+      std::exchange(fullStateDiagonals_, {}));
+}
+
+void applyCircuitTape(Qureg& qureg, const CircuitTape& tape) {
+  tape.apply(qureg);
+}
+
+std::size_t getCircuitTapeSize(const CircuitTape& tape) {
+  return tape.size();
+}
+}  // namespace quest_sys
@@ -0,0 +1,174 @@
+#include "circuit.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+
+namespace quest_sys {
+namespace {
+// A diagonal gate of the current run, with its operands mapped to bit
+// positions of the index the run is evaluated over
+struct DiagonalFactor {
+  std::vector<int> bits;
+  std::vector<qcomp> diag;
+
+  qcomp at(Quest_Index index) const {
+    std::size_t local = 0;
+    for (std::size_t j = 0; j < bits.size(); ++j) {
+      local |= static_cast<std::size_t>((index >> bits[j]) & 1) << j;
+    }
+    return diag[local];
+  }
+};
+
+class DiagonalRun {
+ public:
+  bool empty() const { return members_.empty(); }
+
+  void add(const CircuitTape& tape, std::size_t index) {
+    const auto& inst = tape.instructions()[index];
+    const int* q = tape.qubits(inst);
+    for (std::uint32_t j = 0; j < inst.numQubits; ++j) {
+      if (std::find(qubits_.begin(), qubits_.end(), q[j]) == qubits_.end()) {
+        qubits_.push_back(q[j]);
+      }
+    }
+    members_.push_back(index);
+  }
+
+  void flush(CircuitTapeBuilder& builder,
+             const CircuitTape& tape,
+             int numQubits,
+             std::size_t maxDiagWidth) {
+    if (members_.size() == 1) {
+      builder.copy(tape, tape.instructions()[members_.front()]);
+    } else if (members_.size() > 1 && qubits_.size() <= maxDiagWidth) {
+      emit_diag_matr(builder, tape);
+    } else if (members_.size() > 1) {
+      emit_full_state(builder, tape, numQubits);
+    }
+    members_.clear();
+    qubits_.clear();
+  }
+
+ private:
+  // Maps every member's operands through `position`, which gives the bit of
+  // the evaluated index holding a qubit
+  template <typename Position>
+  std::vector<DiagonalFactor> factors(const CircuitTape& tape,
+                                      Position&& position) const {
+    std::vector<DiagonalFactor> out;
+    out.reserve(members_.size());
+    for (auto index : members_) {
+      const auto& inst = tape.instructions()[index];
+      const int* q = tape.qubits(inst);
+      DiagonalFactor factor;
+      for (std::uint32_t j = 0; j < inst.numQubits; ++j) {
+        factor.bits.push_back(position(q[j]));
+      }
+      factor.diag =
+          gateKindDiagonal(inst.kind, inst.numQubits, tape.params(inst));
+      out.push_back(std::move(factor));
+    }
+    return out;
+  }
+
+  // Multiplies the factors into elems[i] for the indices [offset, offset+n)
+  static void evaluate(const std::vector<DiagonalFactor>& factors,
+                       bool multithreaded,
+                       Quest_Index offset,
+                       Quest_Index count,
+                       qcomp* elems) {
+    quest_helper::parallel_for(
+        multithreaded, count, Quest_Index{1} << 14, [&](Quest_Index begin, Quest_Index end) {
+          for (Quest_Index i = begin; i < end; ++i) {
+            qcomp elem(1, 0);
+            for (const auto& factor : factors) {
+              elem *= factor.at(offset + i);
+            }
+            elems[i] = elem;
+          }
+        });
+  }
+
+  void emit_diag_matr(CircuitTapeBuilder& builder,
+                      const CircuitTape& tape) const {
+    auto fs = factors(tape, [this](int qubit) {
+      return static_cast<int>(
+          std::find(qubits_.begin(), qubits_.end(), qubit) - qubits_.begin());
+    });
+    Quest_Index dim = Quest_Index{1} << qubits_.size();
+    std::vector<qcomp> elems(static_cast<std::size_t>(dim));
+    evaluate(fs, ::getQuESTEnv().isMultithreaded, 0, dim, elems.data());
+
+    std::vector<qreal> flat;
+    flat.reserve(elems.size() * 2);
+    for (const auto& elem : elems) {
+      flat.push_back(elem.real());
+      flat.push_back(elem.imag());
+    }
+    builder.push(GateKind::DiagMatr, qubits_.data(),
+                 static_cast<std::uint32_t>(qubits_.size()), flat.data(),
+                 static_cast<std::uint32_t>(flat.size()));
+  }
+
+  void emit_full_state(CircuitTapeBuilder& builder,
+                       const CircuitTape& tape,
+                       int numQubits) const {
+    // the factors are kept so the tape can refill the diagonal for a
+    // register deployed differently from the environment
+    auto fs = factors(tape, [](int qubit) { return qubit; });
+    FullStateDiagFill fill = [fs = std::move(fs)](
+                                 bool multithreaded, Quest_Index offset,
+                                 Quest_Index count, qcomp* elems) {
+      evaluate(fs, multithreaded, offset, count, elems);
+    };
+
+    // each node only fills its own slice of the diagonal
+    auto matr = ::createFullStateDiagMatr(numQubits);
+    Quest_Index offset =
+        matr.isDistributed ? ::getQuESTEnv().rank * matr.numElemsPerNode : 0;
+    fill(matr.isMultithreaded, offset, matr.numElemsPerNode, matr.cpuElems);
+    ::syncFullStateDiagMatr(matr);
+    builder.pushFullStateDiagMatr(qubits_.data(),
+                                  static_cast<std::uint32_t>(qubits_.size()),
+                                  {matr, std::move(fill)});
+  }
+
+  std::vector<std::size_t> members_;
+  std::vector<int> qubits_;
+};
+}  // namespace
+
+// Diagonal coalescing
+std::unique_ptr<CircuitTape> coalesceDiagonalGates(const CircuitTape& tape,
+                                                   int numQubits,
+                                                   int maxDiagWidth) {
+  if (numQubits <= tape.maxQubit()) {
+    ::invalidQuESTInputError(
+        "The circuit tape targets qubits beyond the given register width.",
+        __func__);
+    return nullptr;
+  }
+  if (maxDiagWidth < 1) {
+    ::invalidQuESTInputError(
+        "The maximum DiagMatr width must be at least one qubit.", __func__);
+    return nullptr;
+  }
+  auto maxWidth = static_cast<std::size_t>(std::min(maxDiagWidth, 24));
+
+  CircuitTapeBuilder builder;
+  DiagonalRun run;
+  const auto& instructions = tape.instructions();
+  for (std::size_t i = 0; i < instructions.size(); ++i) {
+    if (gateKindIsDiagonal(instructions[i].kind)) {
+      run.add(tape, i);
+      continue;
+    }
+    run.flush(builder, tape, numQubits, maxWidth);
+    builder.copy(tape, instructions[i]);
+  }
+  run.flush(builder, tape, numQubits, maxWidth);
+
+  return builder.build();
+}
+}  // namespace quest_sys
@@ -3,6 +3,10 @@
 //
 #include "debug.hpp"
 #include "helper.hpp"
+#include "profiling.hpp"
+#include "quest-sys/src/lib.rs.h"
+
+#include <vector>
 
 namespace quest_sys {
 void setSeeds(rust::Slice<const unsigned> seeds) {
@@ -15,17 +19,14 @@ void setSeedsToDefault() {
 }
 
 rust::Vec<unsigned> getSeeds() {
-  unsigned* seed_ptr{};
-  ::getSeeds(seed_ptr);
+  std::vector<unsigned> seeds(static_cast<std::size_t>(::getNumSeeds()));
+  ::getSeeds(seeds.data());
   rust::Vec<unsigned> out{};
-  if (seed_ptr) {
-    for (int i = 0; i < ::getNumSeeds(); ++i) {
-      out.emplace_back(seed_ptr[0]);
-    }
-    return out;
-  } else {
-    return out;
+  out.reserve(seeds.size());
+  for (auto seed : seeds) {
+    out.push_back(seed);
   }
+  return out;
 }
 
 void invalidQuESTInputError(rust::String msg, rust::String func) {
@@ -73,4 +74,37 @@ rust::String getEnvironmentString() {
   ::getEnvironmentString(str.data());
   return {str.data()};
 }
+
+bool isProfilingEnabled() {
+#if defined(QUEST_SYS_PROFILING)
+  return true;
+#else
+  return false;
+#endif
+}
+
+rust::Vec<ProfileEntry> getProfileEntries() {
+  rust::Vec<ProfileEntry> out{};
+  for (const auto& s : quest_helper::profile_snapshot()) {
+    out.push_back(ProfileEntry{s.name, s.calls, s.totalNs, s.p50Ns, s.p90Ns,
+                               s.p99Ns, s.maxNs, s.bytes});
+  }
+  return out;
+}
+
+rust::String getProfileJson() {
+  return quest_helper::profile_json();
+}
+
+rust::String getProfileChromeTrace() {
+  return quest_helper::profile_chrome_trace();
+}
+
+void setProfileTraceCapacity(std::uint64_t numEvents) {
+  quest_helper::set_profile_trace_capacity(numEvents);
+}
+
+void resetProfile() {
+  quest_helper::reset_profile();
+}
 }  // namespace quest_sys
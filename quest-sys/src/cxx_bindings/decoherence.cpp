@@ -3,9 +3,11 @@
 //
 #include "decoherence.hpp"
 #include "helper.hpp"
+#include "profiling.hpp"
 
 namespace quest_sys {
 void mixDephasing(Qureg& qureg, int qubit, Quest_Real prob) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::mixDephasing(qureg, qubit, prob);
 }
 
@@ -13,10 +15,12 @@ void mixTwoQubitDephasing(Qureg& qureg,
                           int qubit1,
                           int qubit2,
                           Quest_Real prob) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::mixTwoQubitDephasing(qureg, qubit1, qubit2, prob);
 }
 
 void mixDepolarising(Qureg& qureg, int qubit, Quest_Real prob) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::mixDepolarising(qureg, qubit, prob);
 }
 
@@ -24,10 +28,12 @@ void mixTwoQubitDepolarising(Qureg& qureg,
                              int qubit1,
                              int qubit2,
                              Quest_Real prob) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::mixTwoQubitDepolarising(qureg, qubit1, qubit2, prob);
 }
 
 void mixDamping(Qureg& qureg, int qubit, Quest_Real prob) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::mixDamping(qureg, qubit, prob);
 }
 
@@ -36,16 +42,19 @@ void mixPaulis(Qureg& qureg,
                Quest_Real probX,
                Quest_Real probY,
                Quest_Real probZ) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::mixPaulis(qureg, qubit, probX, probY, probZ);
 }
 
 void mixQureg(Qureg& qureg, Qureg& other, Quest_Real prob) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::mixQureg(qureg, other, prob);
 }
 
 void mixKrausMap(Qureg& qureg,
                  rust::Slice<const int> qubits,
                  const KrausMap& map) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::mixKrausMap(qureg, quest_helper::slice_to_ptr(qubits),
                 static_cast<int>(qubits.size()), map);
 }
@@ -0,0 +1,183 @@
+#include "circuit.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quest_sys {
+namespace {
+// Dense unitary accumulated over an ordered set of qubits, where qubits[j] is
+// bit j of the matrix index
+struct FusedBlock {
+  std::vector<int> qubits;
+  std::vector<qcomp> matrix;  // row-major
+  std::vector<std::size_t> members;
+
+  std::size_t dim() const { return std::size_t{1} << qubits.size(); }
+
+  void reset() {
+    qubits.clear();
+    matrix.assign(1, qcomp(1, 0));
+    members.clear();
+  }
+
+  // Tensors identity onto the block for a qubit it does not yet cover
+  void add_qubit(int qubit) {
+    std::size_t oldDim = dim();
+    std::size_t newDim = oldDim * 2;
+    std::vector<qcomp> grown(newDim * newDim, qcomp(0, 0));
+    for (std::size_t high = 0; high < 2; ++high) {
+      for (std::size_t r = 0; r < oldDim; ++r) {
+        std::copy_n(matrix.begin() + static_cast<std::ptrdiff_t>(r * oldDim),
+                    oldDim,
+                    grown.begin() + static_cast<std::ptrdiff_t>(
+                                        (high * oldDim + r) * newDim +
+                                        high * oldDim));
+      }
+    }
+    matrix = std::move(grown);
+    qubits.push_back(qubit);
+  }
+
+  // Left-multiplies the block by a gate acting on a subset of its qubits
+  void multiply(const int* gateQubits,
+                std::uint32_t numGateQubits,
+                const std::vector<qcomp>& gate) {
+    std::vector<std::size_t> bits(numGateQubits);
+    for (std::uint32_t j = 0; j < numGateQubits; ++j) {
+      auto it = std::find(qubits.begin(), qubits.end(), gateQubits[j]);
+      bits[j] = static_cast<std::size_t>(it - qubits.begin());
+    }
+    std::size_t gateDim = std::size_t{1} << numGateQubits;
+    std::size_t gateMask = 0;
+    for (auto bit : bits) {
+      gateMask |= std::size_t{1} << bit;
+    }
+    // Scatters a gate-local index onto the block's bit positions
+    auto scatter = [&](std::size_t local) {
+      std::size_t out = 0;
+      for (std::uint32_t j = 0; j < numGateQubits; ++j) {
+        out |= ((local >> j) & 1) << bits[j];
+      }
+      return out;
+    };
+    auto gather = [&](std::size_t index) {
+      std::size_t out = 0;
+      for (std::uint32_t j = 0; j < numGateQubits; ++j) {
+        out |= ((index >> bits[j]) & 1) << j;
+      }
+      return out;
+    };
+
+    std::size_t n = dim();
+    std::vector<qcomp> product(n * n, qcomp(0, 0));
+    for (std::size_t r = 0; r < n; ++r) {
+      std::size_t rest = r & ~gateMask;
+      std::size_t gateRow = gather(r);
+      for (std::size_t g = 0; g < gateDim; ++g) {
+        qcomp elem = gate[gateRow * gateDim + g];
+        if (elem == qcomp(0, 0)) {
+          continue;
+        }
+        const qcomp* src = matrix.data() + (rest | scatter(g)) * n;
+        for (std::size_t c = 0; c < n; ++c) {
+          product[r * n + c] += elem * src[c];
+        }
+      }
+    }
+    matrix = std::move(product);
+  }
+};
+
+// Replaces a multi-gate block with one dense instruction
+void emit(CircuitTapeBuilder& builder,
+          const CircuitTape& tape,
+          const FusedBlock& block) {
+  if (block.members.empty()) {
+    return;
+  }
+  if (block.members.size() == 1) {
+    builder.copy(tape, tape.instructions()[block.members.front()]);
+    return;
+  }
+  auto width = static_cast<std::uint32_t>(block.qubits.size());
+  GateKind kind = width == 1   ? GateKind::CompMatr1
+                  : width == 2 ? GateKind::CompMatr2
+                               : GateKind::CompMatr;
+  std::vector<qreal> flat;
+  flat.reserve(block.matrix.size() * 2);
+  for (const auto& elem : block.matrix) {
+    flat.push_back(elem.real());
+    flat.push_back(elem.imag());
+  }
+  builder.push(kind, block.qubits.data(), width, flat.data(),
+               static_cast<std::uint32_t>(flat.size()));
+}
+}  // namespace
+
+bool isInstructionFusible(const CircuitTape& tape, const TapeInstruction& inst) {
+  if (inst.kind == GateKind::FullStateDiagMatr) {
+    return false;
+  }
+  if (inst.kind == GateKind::RotateAroundAxis) {
+    // a zero axis is left for QuEST to reject
+    const qreal* p = tape.params(inst);
+    return p[1] != 0 || p[2] != 0 || p[3] != 0;
+  }
+  return true;
+}
+
+// Gate fusion
+std::unique_ptr<CircuitTape> fuseCircuitTape(const CircuitTape& tape,
+                                             int maxWidth) {
+  if (maxWidth < 1 || maxWidth > 12) {
+    ::invalidQuESTInputError(
+        "The fused block width must be between 1 and 12 qubits.", __func__);
+    return nullptr;
+  }
+  auto width = static_cast<std::size_t>(maxWidth);
+
+  CircuitTapeBuilder builder;
+  FusedBlock block;
+  block.reset();
+
+  const auto& instructions = tape.instructions();
+  for (std::size_t i = 0; i < instructions.size(); ++i) {
+    const auto& inst = instructions[i];
+    const int* q = tape.qubits(inst);
+
+    if (inst.numQubits > width || !isInstructionFusible(tape, inst)) {
+      emit(builder, tape, block);
+      block.reset();
+      builder.copy(tape, inst);
+      continue;
+    }
+
+    std::size_t newQubits = 0;
+    for (std::uint32_t j = 0; j < inst.numQubits; ++j) {
+      if (std::find(block.qubits.begin(), block.qubits.end(), q[j]) ==
+          block.qubits.end()) {
+        ++newQubits;
+      }
+    }
+    if (block.qubits.size() + newQubits > width) {
+      emit(builder, tape, block);
+      block.reset();
+    }
+
+    for (std::uint32_t j = 0; j < inst.numQubits; ++j) {
+      if (std::find(block.qubits.begin(), block.qubits.end(), q[j]) ==
+          block.qubits.end()) {
+        block.add_qubit(q[j]);
+      }
+    }
+    block.multiply(q, inst.numQubits,
+                   gateKindMatrix(inst.kind, inst.numQubits,
+                                  tape.params(inst)));
+    block.members.push_back(i);
+  }
+  emit(builder, tape, block);
+
+  return builder.build();
+}
+}  // namespace quest_sys
@@ -0,0 +1,379 @@
+#include "gradient.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <unordered_map>
+#include <utility>
+
+namespace quest_sys {
+namespace {
+constexpr qreal pi = std::numbers::pi_v<qreal>;
+
+struct ShiftTerm {
+  qreal shift;
+  qreal coeff;
+};
+
+// f'(angle) = sum of coeff * f(angle + shift)
+std::vector<ShiftTerm> shift_rule(bool isFourTerm) {
+  if (!isFourTerm) {
+    return {{pi / 2, qreal{0.5}}, {-pi / 2, qreal{-0.5}}};
+  }
+  const qreal near = (2 + std::numbers::sqrt2_v<qreal>) / 8;
+  const qreal far = (2 - std::numbers::sqrt2_v<qreal>) / 8;
+  return {{pi / 2, near},
+          {-pi / 2, -near},
+          {3 * pi / 2, -far},
+          {-3 * pi / 2, far}};
+}
+
+// d/dangle of an angle gate at angle zero, in gateKindMatrix's operand
+// ordering. Each angle gate is exp(angle * this).
+std::vector<qcomp> angle_derivative(GateKind kind,
+                                    std::uint32_t numQubits,
+                                    const qreal* p) {
+  std::size_t dim = std::size_t{1} << numQubits;
+  std::vector<qcomp> out(dim * dim, qcomp(0, 0));
+  const qcomp i(0, 1);
+  const qcomp minusHalfI(0, qreal{-0.5});
+
+  // -i/2 sigma on the top operand where every lower operand (the controls)
+  // is 1, and zero elsewhere
+  auto set_target = [&](std::array<qcomp, 4> sigma) {
+    std::size_t ctrlMask = (dim >> 1) - 1;
+    std::size_t shift = numQubits - 1;
+    for (std::size_t a = 0; a < 2; ++a) {
+      for (std::size_t b = 0; b < 2; ++b) {
+        std::size_t r = (a << shift) | ctrlMask;
+        std::size_t c = (b << shift) | ctrlMask;
+        out[r * dim + c] = minusHalfI * sigma[a * 2 + b];
+      }
+    }
+  };
+
+  switch (kind) {
+    case GateKind::RotateX:
+    case GateKind::ControlledRotateX:
+      set_target({0, 1, 1, 0});
+      break;
+    case GateKind::RotateY:
+    case GateKind::ControlledRotateY:
+      set_target({0, -i, i, 0});
+      break;
+    case GateKind::RotateZ:
+    case GateKind::ControlledRotateZ:
+      set_target({1, 0, 0, -1});
+      break;
+    case GateKind::RotateAroundAxis: {
+      qreal norm = std::sqrt(p[1] * p[1] + p[2] * p[2] + p[3] * p[3]);
+      qreal x = p[1] / norm, y = p[2] / norm, z = p[3] / norm;
+      set_target({z, qcomp(x, -y), qcomp(x, y), -z});
+      break;
+    }
+    case GateKind::PhaseShift:
+    case GateKind::MultiQubitPhaseShift:
+      out[dim * dim - 1] = i;
+      break;
+    case GateKind::PhaseGadget:
+      for (std::size_t k = 0; k < dim; ++k) {
+        qreal sign = std::popcount(k) % 2 ? -1 : 1;
+        out[k * dim + k] = minusHalfI * sign;
+      }
+      break;
+    default:
+      break;
+  }
+  return out;
+}
+
+// Appends the inverse of an instruction. Angle gates negate their angle,
+// matrices are conjugate-transposed, and S, T and SqrtSwap, which have no
+// inverse of their own kind, become a PhaseShift or CompMatr2.
+void push_adjoint(CircuitTapeBuilder& builder,
+                  const CircuitTape& tape,
+                  const TapeInstruction& inst) {
+  const int* q = tape.qubits(inst);
+  const qreal* p = tape.params(inst);
+  std::uint32_t numParams = gateKindNumParams(inst.kind, inst.numQubits);
+  std::vector<qreal> params(p, p + numParams);
+
+  switch (inst.kind) {
+    case GateKind::S:
+    case GateKind::T: {
+      qreal angle = inst.kind == GateKind::S ? -pi / 2 : -pi / 4;
+      builder.push(GateKind::PhaseShift, q, 1, &angle, 1);
+      return;
+    }
+    case GateKind::SqrtSwap:
+    case GateKind::CompMatr1:
+    case GateKind::CompMatr2:
+    case GateKind::CompMatr: {
+      auto m = gateKindMatrix(inst.kind, inst.numQubits, p);
+      std::size_t dim = std::size_t{1} << inst.numQubits;
+      params.resize(2 * dim * dim);
+      for (std::size_t r = 0; r < dim; ++r) {
+        for (std::size_t c = 0; c < dim; ++c) {
+          qcomp elem = std::conj(m[c * dim + r]);
+          params[2 * (r * dim + c)] = std::real(elem);
+          params[2 * (r * dim + c) + 1] = std::imag(elem);
+        }
+      }
+      auto kind = inst.kind == GateKind::SqrtSwap ? GateKind::CompMatr2
+                                                  : inst.kind;
+      builder.push(kind, q, inst.numQubits, params.data(),
+                   static_cast<std::uint32_t>(params.size()));
+      return;
+    }
+    case GateKind::DiagMatr1:
+    case GateKind::DiagMatr2:
+    case GateKind::DiagMatr:
+      for (std::size_t k = 1; k < params.size(); k += 2) {
+        params[k] = -params[k];
+      }
+      break;
+    default:
+      if (gateKindHasAngle(inst.kind)) {
+        params[0] = -params[0];
+      }
+      break;
+  }
+  builder.push(inst.kind, q, inst.numQubits, params.data(), numParams);
+}
+
+bool validate_inputs(const Qureg& qureg,
+                     const DifferentiableCircuit& circuit,
+                     std::size_t rowLength,
+                     const char* caller) {
+  if (rowLength != circuit.numColumns()) {
+    ::invalidQuESTInputError(
+        "The parameter row does not match the circuit's number of columns.",
+        caller);
+    return false;
+  }
+  if (circuit.maxQubit() >= qureg.numQubits) {
+    ::invalidQuESTInputError(
+        "The circuit tape targets qubits beyond the width of the Qureg.",
+        caller);
+    return false;
+  }
+  return true;
+}
+
+rust::Vec<Quest_Real> to_vec(const std::vector<qreal>& values) {
+  rust::Vec<Quest_Real> out;
+  out.reserve(values.size());
+  for (qreal value : values) {
+    out.push_back(value);
+  }
+  return out;
+}
+}  // namespace
+
+DifferentiableCircuit::DifferentiableCircuit(
+    const ParameterisedCircuit& circuit)
+    : numColumns_(circuit.numColumns()) {
+  const auto& tape = circuit.tape();
+  const auto& insts = tape.instructions();
+  std::unordered_map<std::uint32_t, std::size_t> instructionOf;
+  for (std::size_t k = 0; k < insts.size(); ++k) {
+    if (gateKindHasAngle(insts[k].kind)) {
+      instructionOf[insts[k].paramOffset] = k;
+    }
+  }
+
+  // As in ParameterisedCircuit::bind, the last binding of an angle wins
+  std::unordered_map<std::uint32_t, std::size_t> angleOf;
+  for (const auto& binding : circuit.bindings()) {
+    auto [it, isNew] = angleOf.try_emplace(binding.paramIndex, angles_.size());
+    if (isNew) {
+      angles_.push_back({instructionOf.at(binding.paramIndex), 0, 0});
+    }
+    angles_[it->second].column = binding.column;
+    angles_[it->second].scale = binding.scale;
+  }
+  std::ranges::sort(angles_, std::ranges::greater{},
+                    &DifferentiableAngle::instruction);
+
+  // Each angle is its own column of the angled and adjoint circuits
+  std::vector<ParameterBinding> forward;
+  for (std::uint32_t j = 0; j < angles_.size(); ++j) {
+    forward.push_back({insts[angles_[j].instruction].paramOffset, j, 1});
+  }
+  angled_ = circuit.rebind(std::move(forward));
+
+  CircuitTapeBuilder builder;
+  for (auto k = insts.size(); k-- > 0;) {
+    push_adjoint(builder, tape, insts[k]);
+  }
+  auto adjointTape = builder.build();
+  std::vector<ParameterBinding> backward;
+  for (std::uint32_t j = 0; j < angles_.size(); ++j) {
+    const auto& inst =
+        adjointTape->instructions()[insts.size() - 1 - angles_[j].instruction];
+    backward.push_back({inst.paramOffset, j, -1});
+  }
+  adjoint_ = std::make_unique<ParameterisedCircuit>(std::move(adjointTape),
+                                                    std::move(backward));
+
+  for (auto& angle : angles_) {
+    const auto& inst = insts[angle.instruction];
+    auto n = static_cast<int>(inst.numQubits);
+    auto dim = std::size_t{1} << inst.numQubits;
+    auto derivative = angle_derivative(inst.kind, inst.numQubits,
+                                       tape.params(inst));
+    angle.isFourTerm = inst.kind == GateKind::ControlledRotateX ||
+                       inst.kind == GateKind::ControlledRotateY ||
+                       inst.kind == GateKind::ControlledRotateZ;
+    angle.isDiagonal = gateKindIsDiagonal(inst.kind);
+    if (angle.isDiagonal) {
+      angle.diagonalDerivative = ::createDiagMatr(n);
+      for (std::size_t k = 0; k < dim; ++k) {
+        angle.diagonalDerivative.cpuElems[k] = derivative[k * dim + k];
+      }
+      ::syncDiagMatr(angle.diagonalDerivative);
+    } else {
+      angle.derivative = ::createCompMatr(n);
+      std::copy(derivative.begin(), derivative.end(),
+                angle.derivative.cpuElemsFlat);
+      ::syncCompMatr(angle.derivative);
+    }
+  }
+}
+
+DifferentiableCircuit::~DifferentiableCircuit() {
+  for (auto& angle : angles_) {
+    if (angle.isDiagonal) {
+      ::destroyDiagMatr(angle.diagonalDerivative);
+    } else {
+      ::destroyCompMatr(angle.derivative);
+    }
+  }
+}
+
+std::vector<qreal> DifferentiableCircuit::angles(const qreal* row) const {
+  std::vector<qreal> values;
+  values.reserve(angles_.size());
+  for (const auto& angle : angles_) {
+    values.push_back(angle.scale * row[angle.column]);
+  }
+  return values;
+}
+
+std::vector<qreal> DifferentiableCircuit::parameterShift(
+    const Qureg& initial,
+    const PauliStrSum& observable,
+    const qreal* row,
+    int numWorkers) const {
+  auto base = angles(row);
+  std::vector<qreal> rows;
+  std::vector<std::pair<std::size_t, qreal>> terms;
+  for (std::size_t j = 0; j < angles_.size(); ++j) {
+    for (const auto& term : shift_rule(angles_[j].isFourTerm)) {
+      auto start = rows.size();
+      rows.insert(rows.end(), base.begin(), base.end());
+      rows[start + j] += term.shift;
+      terms.emplace_back(j, term.coeff);
+    }
+  }
+
+  auto values = calcSweepExpectations(initial, *angled_, observable,
+                                      rows.data(), terms.size(), numWorkers);
+  std::vector<qreal> gradient(numColumns_, 0);
+  for (std::size_t t = 0; t < terms.size(); ++t) {
+    const auto& angle = angles_[terms[t].first];
+    gradient[angle.column] += angle.scale * terms[t].second * values[t];
+  }
+  return gradient;
+}
+
+std::vector<qreal> DifferentiableCircuit::adjoint(
+    const Qureg& initial,
+    const PauliStrSum& observable,
+    const qreal* row) const {
+  auto values = angles(row);
+  auto params = angled_->defaultParams();
+  auto adjointParams = adjoint_->defaultParams();
+  adjoint_->bind(values.data(), adjointParams);
+
+  Qureg state = ::createCloneQureg(initial);
+  angled_->apply(state, params, values.data());
+  Qureg costate = ::createCloneQureg(state);
+  Qureg scratch = ::createCloneQureg(state);
+  ::multiplyPauliStrSum(costate, observable, scratch);
+
+  // Walking back, state holds U_k..U_1|initial> and costate holds
+  // U_k+1^dag..U_N^dag H|final>, so the derivative of gate k's angle is
+  // 2 Re <costate| dU_k U_k^dag |state>
+  const auto& forwardTape = angled_->tape();
+  const auto& adjointTape = adjoint_->tape();
+  std::size_t numGates = adjointTape.size();
+  std::size_t numApplied = numGates;
+  std::vector<qreal> gradient(numColumns_, 0);
+  for (const auto& angle : angles_) {
+    std::size_t begin = numGates - numApplied;
+    std::size_t end = numGates - 1 - angle.instruction;
+    adjointTape.applyRange(state, begin, end, adjointParams.data());
+    adjointTape.applyRange(costate, begin, end, adjointParams.data());
+    numApplied = angle.instruction + 1;
+
+    const auto& inst = forwardTape.instructions()[angle.instruction];
+    auto* targets = const_cast<int*>(forwardTape.qubits(inst));
+    auto numTargets = static_cast<int>(inst.numQubits);
+    ::setQuregToClone(scratch, state);
+    if (angle.isDiagonal) {
+      ::multiplyDiagMatr(scratch, targets, numTargets,
+                         angle.diagonalDerivative);
+    } else {
+      ::multiplyCompMatr(scratch, targets, numTargets, angle.derivative);
+    }
+    qcomp overlap = ::calcInnerProduct(costate, scratch);
+    gradient[angle.column] += 2 * angle.scale * std::real(overlap);
+  }
+
+  ::destroyQureg(scratch);
+  ::destroyQureg(costate);
+  ::destroyQureg(state);
+  return gradient;
+}
+
+// Gradients
+std::unique_ptr<DifferentiableCircuit> createDifferentiableCircuit(
+    const ParameterisedCircuit& circuit) {
+  return std::make_unique<DifferentiableCircuit>(circuit);
+}
+
+rust::Vec<Quest_Real> calcParameterShiftGradient(
+    const Qureg& initial,
+    const DifferentiableCircuit& circuit,
+    const PauliStrSum& observable,
+    rust::Slice<const double> row,
+    int numWorkers) {
+  if (!validate_inputs(initial, circuit, row.length(), __func__)) {
+    return {};
+  }
+  return to_vec(circuit.parameterShift(
+      initial, observable, quest_helper::slice_to_ptr(row), numWorkers));
+}
+
+rust::Vec<Quest_Real> calcAdjointGradient(const Qureg& initial,
+                                          const DifferentiableCircuit& circuit,
+                                          const PauliStrSum& observable,
+                                          rust::Slice<const double> row) {
+  if (!validate_inputs(initial, circuit, row.length(), __func__)) {
+    return {};
+  }
+  if (initial.isDensityMatrix) {
+    ::invalidQuESTInputError(
+        "Adjoint gradients need a statevector; use parameter-shift gradients "
+        "for density matrices.",
+        __func__);
+    return {};
+  }
+  return to_vec(
+      circuit.adjoint(initial, observable, quest_helper::slice_to_ptr(row)));
+}
+}  // namespace quest_sys
@@ -0,0 +1,243 @@
+#include "hamiltonian.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+namespace quest_sys {
+namespace {
+using Bases = std::array<std::uint8_t, quest_helper::max_pauli_qubits>;
+
+struct TermInfo {
+  Bases bases{};
+  Quest_Real coeff;
+};
+
+bool commutes_qubitwise(const Bases& group, const Bases& term) {
+  for (std::size_t q = 0; q < group.size(); ++q) {
+    if (group[q] && term[q] && group[q] != term[q]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// In place, leaving entry m as the expectation of the parity over mask m
+void walsh_hadamard(std::vector<Quest_Real>& probs) {
+  for (std::size_t half = 1; half < probs.size(); half *= 2) {
+    for (std::size_t i = 0; i < probs.size(); i += 2 * half) {
+      for (std::size_t j = i; j < i + half; ++j) {
+        Quest_Real even = probs[j];
+        Quest_Real odd = probs[j + half];
+        probs[j] = even + odd;
+        probs[j + half] = even - odd;
+      }
+    }
+  }
+}
+
+bool validate_group(const AnalysedHamiltonian& ham,
+                    std::size_t group,
+                    const char* caller) {
+  if (group >= ham.groups().size()) {
+    ::invalidQuESTInputError("Unknown Hamiltonian group.", caller);
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+AnalysedHamiltonian::AnalysedHamiltonian(const PauliStrSum& sum) {
+  std::vector<TermInfo> terms;
+  for (Quest_Index t = 0; t < sum.numTerms; ++t) {
+    TermInfo term{{}, sum.coeffs[t].real()};
+    bool isIdentity = true;
+    for (int q = 0; q < quest_helper::max_pauli_qubits; ++q) {
+      auto code = quest_helper::pauli_code(sum.strings[t], q);
+      term.bases[static_cast<std::size_t>(q)] =
+          static_cast<std::uint8_t>(code);
+      if (code) {
+        isIdentity = false;
+        maxQubit_ = std::max(maxQubit_, q);
+      }
+    }
+    if (isIdentity) {
+      identityCoeff_ += term.coeff;
+    } else {
+      terms.push_back(term);
+    }
+  }
+
+  // Sorted insertion: heaviest terms first, each into the first group it
+  // commutes with qubit-wise
+  std::stable_sort(terms.begin(), terms.end(), [](auto& a, auto& b) {
+    return std::abs(a.coeff) > std::abs(b.coeff);
+  });
+  std::vector<Bases> groupBases;
+  std::vector<std::vector<const TermInfo*>> members;
+  for (const auto& term : terms) {
+    std::size_t g = 0;
+    while (g < groupBases.size() &&
+           !commutes_qubitwise(groupBases[g], term.bases)) {
+      ++g;
+    }
+    if (g == groupBases.size()) {
+      groupBases.emplace_back();
+      members.emplace_back();
+    }
+    for (std::size_t q = 0; q < term.bases.size(); ++q) {
+      groupBases[g][q] = std::max(groupBases[g][q], term.bases[q]);
+    }
+    members[g].push_back(&term);
+  }
+
+  for (std::size_t g = 0; g < groupBases.size(); ++g) {
+    CommutingGroup group;
+    for (std::size_t q = 0; q < groupBases[g].size(); ++q) {
+      if (groupBases[g][q]) {
+        group.qubits.push_back(static_cast<int>(q));
+        group.bases.push_back(groupBases[g][q]);
+      }
+    }
+    for (const auto* term : members[g]) {
+      std::uint64_t mask = 0;
+      for (std::size_t j = 0; j < group.qubits.size(); ++j) {
+        if (term->bases[static_cast<std::size_t>(group.qubits[j])]) {
+          mask |= std::uint64_t{1} << j;
+        }
+      }
+      group.masks.push_back(mask);
+      group.coeffs.push_back(term->coeff);
+      group.weight += std::abs(term->coeff);
+    }
+    groups_.push_back(std::move(group));
+  }
+}
+
+void AnalysedHamiltonian::rotateToGroupBasis(Qureg& qureg,
+                                             std::size_t group) const {
+  const auto& g = groups_[group];
+  for (std::size_t j = 0; j < g.qubits.size(); ++j) {
+    // H maps X to Z; H S^dagger maps Y to Z
+    if (g.bases[j] == 2) {
+      ::applyPhaseShift(qureg, g.qubits[j], -std::numbers::pi_v<qreal> / 2);
+    }
+    if (g.bases[j] != 3) {
+      ::applyHadamard(qureg, g.qubits[j]);
+    }
+  }
+}
+
+// Hamiltonians
+std::unique_ptr<AnalysedHamiltonian> createAnalysedHamiltonian(
+    const PauliStrSum& sum) {
+  for (Quest_Index t = 0; t < sum.numTerms; ++t) {
+    if (std::abs(sum.coeffs[t].imag()) > ::getValidationEpsilon()) {
+      ::invalidQuESTInputError(
+          "Analysed Hamiltonians must be Hermitian, with real coefficients.",
+          __func__);
+      return nullptr;
+    }
+  }
+  return std::make_unique<AnalysedHamiltonian>(sum);
+}
+
+std::size_t getAnalysedHamiltonianNumGroups(const AnalysedHamiltonian& ham) {
+  return ham.groups().size();
+}
+
+rust::Slice<const int> getAnalysedHamiltonianGroupQubits(
+    const AnalysedHamiltonian& ham,
+    std::size_t group) {
+  if (!validate_group(ham, group, __func__)) {
+    return {};
+  }
+  const auto& qubits = ham.groups()[group].qubits;
+  return {qubits.data(), qubits.size()};
+}
+
+Quest_Real calcExpecAnalysedHamiltonian(const Qureg& qureg,
+                                        const AnalysedHamiltonian& ham,
+                                        Qureg& workspace) {
+  if (ham.maxQubit() >= qureg.numQubits) {
+    ::invalidQuESTInputError(
+        "The Hamiltonian targets qubits beyond the width of the Qureg.",
+        __func__);
+    return 0;
+  }
+  Quest_Real total = 0;
+  if (ham.identityCoeff() != 0) {
+    total += ham.identityCoeff() * ::calcTotalProb(qureg);
+  }
+
+  std::vector<Quest_Real> probs;
+  for (std::size_t g = 0; g < ham.groups().size(); ++g) {
+    const auto& group = ham.groups()[g];
+    ::setQuregToClone(workspace, qureg);
+    ham.rotateToGroupBasis(workspace, g);
+    probs.resize(std::size_t{1} << group.qubits.size());
+    ::calcProbsOfAllMultiQubitOutcomes(
+        probs.data(), workspace, const_cast<int*>(group.qubits.data()),
+        static_cast<int>(group.qubits.size()));
+
+    walsh_hadamard(probs);
+    for (std::size_t t = 0; t < group.masks.size(); ++t) {
+      total += group.coeffs[t] * probs[group.masks[t]];
+    }
+  }
+  return total;
+}
+
+void setQuregToHamiltonianGroupBasis(Qureg& out,
+                                     const Qureg& in,
+                                     const AnalysedHamiltonian& ham,
+                                     std::size_t group) {
+  if (!validate_group(ham, group, __func__)) {
+    return;
+  }
+  ::setQuregToClone(out, in);
+  ham.rotateToGroupBasis(out, group);
+}
+
+void allocateAnalysedHamiltonianShots(rust::Slice<std::uint64_t> counts,
+                                      const AnalysedHamiltonian& ham,
+                                      std::uint64_t numShots) {
+  const auto& groups = ham.groups();
+  if (counts.length() != groups.size()) {
+    ::invalidQuESTInputError(
+        "The counts buffer must have one entry per Hamiltonian group.",
+        __func__);
+    return;
+  }
+  // Shots proportional to each group's coefficient weight, which minimises
+  // the variance bound of the summed estimate; remainders go to the largest
+  // fractional parts
+  Quest_Real totalWeight = 0;
+  for (const auto& group : groups) {
+    totalWeight += group.weight;
+  }
+  if (totalWeight == 0) {
+    std::fill(counts.begin(), counts.end(), 0);
+    return;
+  }
+  std::vector<Quest_Real> remainders(groups.size());
+  std::uint64_t assigned = 0;
+  for (std::size_t g = 0; g < groups.size(); ++g) {
+    Quest_Real exact = static_cast<Quest_Real>(numShots) * groups[g].weight /
+                       totalWeight;
+    counts[g] = static_cast<std::uint64_t>(std::floor(exact));
+    remainders[g] = exact - static_cast<Quest_Real>(counts[g]);
+    assigned += counts[g];
+  }
+  std::vector<std::size_t> order(groups.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+    return remainders[a] > remainders[b];
+  });
+  for (std::size_t i = 0; assigned < numShots; ++i, ++assigned) {
+    ++counts[order[i % order.size()]];
+  }
+}
+}  // namespace quest_sys
@@ -5,6 +5,7 @@
 
 #include <quest.h>
 #include <rust/cxx.h>
+#include <cstdint>
 #include <memory>
 #include "types.hpp"
 
@@ -35,6 +36,19 @@ void calcProbsOfAllMultiQubitOutcomes(rust::Slice<Quest_Real> outcomeProbs,
                                       const Qureg& qureg,
                                       rust::Slice<const int> qubits);
 
+// Draws shots from the marginal distribution of `qubits`, computed once.
+// Outcome bit j is qubits[j]. Seeded from both setSeeds and `seed`.
+rust::Vec<Quest_Index> sampleMultiQubitOutcomes(const Qureg& qureg,
+                                               rust::Slice<const int> qubits,
+                                               std::uint64_t numShots,
+                                               std::uint64_t seed);
+
+void sampleMultiQubitOutcomeCounts(rust::Slice<std::uint64_t> counts,
+                                   const Qureg& qureg,
+                                   rust::Slice<const int> qubits,
+                                   std::uint64_t numShots,
+                                   std::uint64_t seed);
+
 Quest_Real calcPurity(const Qureg& qureg);
 
 Quest_Real calcFidelity(const Qureg& qureg, const Qureg& other);
@@ -0,0 +1,74 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+namespace quest_sys {
+// Content-addressed store of ready, synced KrausMaps (and so of their
+// superoperators). Identical operators share one entry and one handle.
+class ChannelCache {
+ public:
+  ChannelCache() = default;
+  ~ChannelCache();
+
+  ChannelCache(const ChannelCache&) = delete;
+  ChannelCache& operator=(const ChannelCache&) = delete;
+
+  // Returns the handle of an equal cached map, creating it on a miss
+  std::uint64_t insertKrausMap(int numQubits,
+                               int numOperators,
+                               const qcomp* matrices,
+                               std::size_t numElems);
+
+  // Null when the handle is unknown or was evicted
+  const KrausMap* find(std::uint64_t handle) const;
+
+  bool evict(std::uint64_t handle);
+  void clear();
+
+  std::size_t numEntries() const { return entries_.size(); }
+  std::size_t numBytes() const { return numBytes_; }
+
+ private:
+  struct Entry {
+    std::uint64_t key;
+    int numQubits;
+    int numOperators;
+    std::vector<qcomp> matrices;  // kept to tell hash collisions apart
+    KrausMap map;
+    std::size_t numBytes;
+  };
+
+  std::unordered_map<std::uint64_t, Entry> entries_;
+  std::unordered_multimap<std::uint64_t, std::uint64_t> handlesByKey_;
+  std::uint64_t nextHandle_ = 1;
+  std::size_t numBytes_ = 0;
+};
+
+// Channel cache
+std::unique_ptr<ChannelCache> createChannelCache();
+
+std::uint64_t cacheKrausMap(ChannelCache& cache,
+                            int numQubits,
+                            int numOperators,
+                            rust::Slice<const Quest_Complex> matrices);
+
+const KrausMap& getCachedKrausMap(const ChannelCache& cache,
+                                  std::uint64_t handle);
+
+const SuperOp& getCachedSuperOp(const ChannelCache& cache,
+                                std::uint64_t handle);
+
+bool evictCachedChannel(ChannelCache& cache, std::uint64_t handle);
+
+void clearChannelCache(ChannelCache& cache);
+
+std::size_t getChannelCacheNumEntries(const ChannelCache& cache);
+
+std::size_t getChannelCacheBytes(const ChannelCache& cache);
+}  // namespace quest_sys
@@ -43,4 +43,18 @@ std::unique_ptr<KrausMap> createInlineKrausMap(
 std::unique_ptr<SuperOp> createInlineSuperOp(
     int numQubits,
     rust::Slice<const rust::Slice<const Quest_Complex>> matrix);
+
+// Flat inputs: operators x dim x dim, each operator row-major
+void setKrausMapFlat(KrausMap& map, rust::Slice<const Quest_Complex> matrices);
+
+void setSuperOpFlat(SuperOp& op, rust::Slice<const Quest_Complex> matrix);
+
+std::unique_ptr<KrausMap> createInlineKrausMapFlat(
+    int numQubits,
+    int numOperators,
+    rust::Slice<const Quest_Complex> matrices);
+
+std::unique_ptr<SuperOp> createInlineSuperOpFlat(
+    int numQubits,
+    rust::Slice<const Quest_Complex> matrix);
 }  // namespace quest_sys
\ No newline at end of file
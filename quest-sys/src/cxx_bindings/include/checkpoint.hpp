@@ -0,0 +1,16 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <memory>
+
+#include "types.hpp"
+
+namespace quest_sys {
+// Checkpoints
+void saveQuregCheckpoint(Qureg& qureg, rust::String path, bool withChecksum);
+
+// False, leaving the Qureg untouched, if the checkpoint is rejected
+bool loadQuregCheckpoint(Qureg& qureg, rust::String path);
+
+std::unique_ptr<Qureg> createQuregFromCheckpoint(rust::String path);
+}  // namespace quest_sys
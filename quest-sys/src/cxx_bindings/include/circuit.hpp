@@ -0,0 +1,222 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "types.hpp"
+
+namespace quest_sys {
+// Opcodes understood by a CircuitTape. This is the definition behind the
+// shared GateKind enum of the Rust bridge, which checks each value against it
+// at compile time.
+//
+// Qubit operands are listed controls first, then targets. The "Controlled"
+// kinds take any number of controls in front of their fixed targets.
+// Parameters are real; complex matrix entries are stored as (re, im) pairs
+// in row-major order.
+enum class GateKind : std::uint32_t {
+  Hadamard = 0,
+  PauliX,
+  PauliY,
+  PauliZ,
+  S,
+  T,
+  RotateX,           // 1 param: angle
+  RotateY,           // 1 param: angle
+  RotateZ,           // 1 param: angle
+  PhaseShift,        // 1 param: angle
+  RotateAroundAxis,  // 4 params: angle, axis x, y, z
+  Swap,
+  SqrtSwap,
+  ControlledHadamard,
+  ControlledPauliX,
+  ControlledPauliY,
+  ControlledPauliZ,
+  ControlledRotateX,  // 1 param: angle
+  ControlledRotateY,  // 1 param: angle
+  ControlledRotateZ,  // 1 param: angle
+  MultiQubitPhaseShift,  // 1 param: angle, any number of targets
+  MultiQubitPhaseFlip,   // any number of targets
+  PhaseGadget,           // 1 param: angle, any number of targets
+  CompMatr1,             // 8 params: 2x2 complex matrix
+  CompMatr2,             // 32 params: 4x4 complex matrix
+  DiagMatr1,             // 4 params: 2 complex diagonal entries
+  DiagMatr2,             // 8 params: 4 complex diagonal entries
+  CompMatr,              // 2 * 4^n params: dense matrix on any n targets
+  DiagMatr,              // 2 * 2^n params: diagonal on any n targets
+  FullStateDiagMatr,     // internal only: cached whole-register diagonal
+  NumKinds
+};
+
+struct TapeInstruction {
+  GateKind kind;
+  std::uint32_t numQubits;
+  std::uint32_t qubitOffset;
+  std::uint32_t paramOffset;
+  std::int32_t matrixIndex = -1;  // cached QuEST matrix of the same kind
+};
+
+// Writes the whole-register diagonal elements [offset, offset + count) into
+// elems, so a FullStateDiagMatr can be rebuilt for any deployment
+using FullStateDiagFill = std::function<
+    void(bool multithreaded, Quest_Index offset, Quest_Index count, qcomp* elems)>;
+
+// A whole-register diagonal of a tape: the matrix built for the
+// environment's deployment, and how to fill one for another
+struct FullStateDiagonal {
+  ::FullStateDiagMatr matr;
+  FullStateDiagFill fill;
+};
+
+// A validated, immutable gate sequence which can be replayed on any Qureg.
+// CompMatr and DiagMatr instructions are uploaded to QuEST matrices once,
+// when the tape is built, and released with it. FullStateDiagMatr
+// instructions carry no parameters; the tape takes ownership of the matrices
+// passed in alongside them, and builds a matching copy the first time it is
+// applied to a register deployed differently.
+class CircuitTape {
+ public:
+  CircuitTape(std::vector<TapeInstruction> instructions,
+              std::vector<int> qubits,
+              std::vector<qreal> params,
+              std::vector<FullStateDiagonal> fullStateDiagonals = {});
+  ~CircuitTape();
+
+  CircuitTape(const CircuitTape&) = delete;
+  CircuitTape& operator=(const CircuitTape&) = delete;
+
+  void apply(Qureg& qureg) const;
+
+  // Applies instructions [begin, end) without re-validating the register
+  void applyRange(Qureg& qureg, std::size_t begin, std::size_t end) const;
+
+  // As above, reading parameters from a buffer laid out like the tape's own.
+  // Instructions uploaded to cached matrices ignore it.
+  void applyRange(Qureg& qureg,
+                  std::size_t begin,
+                  std::size_t end,
+                  const qreal* params) const;
+
+  std::size_t size() const { return instructions_.size(); }
+  std::size_t numParams() const { return params_.size(); }
+  int maxQubit() const { return maxQubit_; }
+
+  const std::vector<TapeInstruction>& instructions() const {
+    return instructions_;
+  }
+  const int* qubits(const TapeInstruction& inst) const {
+    return qubits_.data() + inst.qubitOffset;
+  }
+  const qreal* params(const TapeInstruction& inst) const {
+    return params_.data() + inst.paramOffset;
+  }
+  const FullStateDiagonal& fullStateDiagonal(
+      const TapeInstruction& inst) const {
+    return fullStateDiagonals_[static_cast<std::size_t>(inst.matrixIndex)];
+  }
+
+ private:
+  // The diagonal's matrix, or a copy deployed like qureg
+  const ::FullStateDiagMatr& fullStateMatrixFor(std::size_t index,
+                                                const Qureg& qureg) const;
+
+  std::vector<TapeInstruction> instructions_;
+  std::vector<int> qubits_;
+  std::vector<qreal> params_;
+  std::vector<::CompMatr> compMatrices_;
+  std::vector<::DiagMatr> diagMatrices_;
+  std::vector<FullStateDiagonal> fullStateDiagonals_;
+  int maxQubit_ = -1;
+
+  // Keyed by (diagonal, isDistributed, isGpuAccelerated); applying a tape
+  // only reads it, so workers can share one tape
+  mutable std::mutex redeployedMutex_;
+  mutable std::map<std::tuple<std::size_t, int, int>, ::FullStateDiagMatr>
+      redeployed_;
+};
+
+// Assembles a new tape instruction by instruction, for the tape passes
+class CircuitTapeBuilder {
+ public:
+  CircuitTapeBuilder() = default;
+  ~CircuitTapeBuilder();
+
+  CircuitTapeBuilder(const CircuitTapeBuilder&) = delete;
+  CircuitTapeBuilder& operator=(const CircuitTapeBuilder&) = delete;
+
+  // Copies an instruction of another tape verbatim, giving a whole-register
+  // diagonal its own copy of the matrix
+  void copy(const CircuitTape& tape, const TapeInstruction& inst);
+
+  void push(GateKind kind,
+            const int* qubits,
+            std::uint32_t numQubits,
+            const qreal* params,
+            std::uint32_t numParams);
+
+  // Takes ownership of a prepared whole-register diagonal
+  void pushFullStateDiagMatr(const int* qubits,
+                             std::uint32_t numQubits,
+                             FullStateDiagonal diagonal);
+
+  std::unique_ptr<CircuitTape> build();
+
+ private:
+  std::vector<TapeInstruction> instructions_;
+  std::vector<int> qubits_;
+  std::vector<qreal> params_;
+  std::vector<FullStateDiagonal> fullStateDiagonals_;
+};
+
+// Number of real parameters consumed by an instruction
+std::uint32_t gateKindNumParams(GateKind kind, std::uint32_t numQubits);
+
+// Row-major unitary of an instruction over its own operands, where operand j
+// is bit j of the matrix index (QuEST's target ordering). Controls are
+// included as ordinary operands.
+std::vector<qcomp> gateKindMatrix(GateKind kind,
+                                  std::uint32_t numQubits,
+                                  const qreal* params);
+
+// Whether gateKindMatrix can describe an instruction of this tape
+bool isInstructionFusible(const CircuitTape& tape, const TapeInstruction& inst);
+
+// Whether an instruction only multiplies amplitudes by phases or factors
+bool gateKindIsDiagonal(GateKind kind);
+
+// Whether an instruction's first parameter is a rotation or phase angle, and
+// it is the identity when that angle is zero
+bool gateKindHasAngle(GateKind kind);
+
+// The 2^n diagonal entries of a diagonal instruction, in the same operand
+// ordering as gateKindMatrix
+std::vector<qcomp> gateKindDiagonal(GateKind kind,
+                                    std::uint32_t numQubits,
+                                    const qreal* params);
+
+// Circuit tapes
+std::unique_ptr<CircuitTape> createCircuitTape(
+    rust::Slice<const std::uint32_t> opcodes,
+    rust::Slice<const std::uint32_t> arities,
+    rust::Slice<const int> qubits,
+    rust::Slice<const double> params);
+
+void applyCircuitTape(Qureg& qureg, const CircuitTape& tape);
+
+std::size_t getCircuitTapeSize(const CircuitTape& tape);
+
+// Gate fusion
+std::unique_ptr<CircuitTape> fuseCircuitTape(const CircuitTape& tape,
+                                             int maxWidth);
+
+// Diagonal coalescing
+std::unique_ptr<CircuitTape> coalesceDiagonalGates(const CircuitTape& tape,
+                                                   int numQubits,
+                                                   int maxDiagWidth);
+}  // namespace quest_sys
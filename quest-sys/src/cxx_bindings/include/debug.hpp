@@ -4,10 +4,13 @@
 #pragma once
 #include <quest.h>
 #include <rust/cxx.h>
+#include <cstdint>
 
 #include "types.hpp"
 
 namespace quest_sys {
+struct ProfileEntry;
+
 // Debug
 void setSeeds(rust::Slice<const unsigned> seeds);
 
@@ -36,4 +39,20 @@ Quest_Index getGpuCacheSize();
 void clearGpuCache();
 
 rust::String getEnvironmentString();
+
+// Profiling. Wrappers only record when built with the profiling feature;
+// otherwise every query is empty.
+bool isProfilingEnabled();
+
+rust::Vec<ProfileEntry> getProfileEntries();
+
+rust::String getProfileJson();
+
+// Chrome trace-event JSON of the most recent calls, for chrome://tracing
+// or Perfetto
+rust::String getProfileChromeTrace();
+
+void setProfileTraceCapacity(std::uint64_t numEvents);
+
+void resetProfile();
 }  // namespace quest_sys
@@ -0,0 +1,77 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sweep.hpp"
+#include "types.hpp"
+
+namespace quest_sys {
+// One bound angle of the circuit. The gate is exp(angle * derivative), so
+// its derivative at any angle is `derivative` times the gate.
+struct DifferentiableAngle {
+  std::size_t instruction;
+  std::uint32_t column;
+  qreal scale;
+  // Controlled rotations have generator eigenvalues {0, +-1/2} and need the
+  // four-term shift rule; every other angle gate needs two terms
+  bool isFourTerm = false;
+  bool isDiagonal = false;
+  CompMatr derivative{};
+  DiagMatr diagonalDerivative{};
+};
+
+// A parameterised circuit prepared for gradients with respect to its
+// columns. Every bound angle becomes a column of its own, the adjoint of the
+// tape is built once in reverse order, and the derivative of each bound gate
+// is uploaded to a QuEST matrix.
+class DifferentiableCircuit {
+ public:
+  explicit DifferentiableCircuit(const ParameterisedCircuit& circuit);
+  ~DifferentiableCircuit();
+  DifferentiableCircuit(const DifferentiableCircuit&) = delete;
+  DifferentiableCircuit& operator=(const DifferentiableCircuit&) = delete;
+
+  std::uint32_t numColumns() const { return numColumns_; }
+  int maxQubit() const { return angled_->tape().maxQubit(); }
+
+  // d<observable>/d(row[c]) by parameter shifts, evaluated as one sweep
+  std::vector<qreal> parameterShift(const Qureg& initial,
+                                    const PauliStrSum& observable,
+                                    const qreal* row,
+                                    int numWorkers) const;
+
+  // d<observable>/d(row[c]) by one forward and one reverse pass on a
+  // statevector
+  std::vector<qreal> adjoint(const Qureg& initial,
+                             const PauliStrSum& observable,
+                             const qreal* row) const;
+
+ private:
+  // The value of every bound angle, in the order of angles_
+  std::vector<qreal> angles(const qreal* row) const;
+
+  std::unique_ptr<ParameterisedCircuit> angled_;
+  std::unique_ptr<ParameterisedCircuit> adjoint_;
+  std::vector<DifferentiableAngle> angles_;  // by descending instruction
+  std::uint32_t numColumns_;
+};
+
+// Gradients
+std::unique_ptr<DifferentiableCircuit> createDifferentiableCircuit(
+    const ParameterisedCircuit& circuit);
+
+rust::Vec<Quest_Real> calcParameterShiftGradient(
+    const Qureg& initial,
+    const DifferentiableCircuit& circuit,
+    const PauliStrSum& observable,
+    rust::Slice<const double> row,
+    int numWorkers);
+
+rust::Vec<Quest_Real> calcAdjointGradient(const Qureg& initial,
+                                          const DifferentiableCircuit& circuit,
+                                          const PauliStrSum& observable,
+                                          rust::Slice<const double> row);
+}  // namespace quest_sys
@@ -0,0 +1,64 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "types.hpp"
+
+namespace quest_sys {
+// A set of terms that commute qubit-wise, so one basis change diagonalises
+// all of them
+struct CommutingGroup {
+  std::vector<int> qubits;  // support, ascending
+  std::vector<int> bases;   // per support qubit: 1=X, 2=Y, 3=Z
+  std::vector<std::uint64_t> masks;  // per term, over support positions
+  std::vector<Quest_Real> coeffs;    // per term
+  Quest_Real weight = 0;             // sum of |coeff|, for shot allocation
+};
+
+// A Hermitian PauliStrSum partitioned once into qubit-wise-commuting groups.
+// Each expectation then costs a basis change and one probability pass per
+// group rather than a pass per term.
+class AnalysedHamiltonian {
+ public:
+  explicit AnalysedHamiltonian(const PauliStrSum& sum);
+
+  const std::vector<CommutingGroup>& groups() const { return groups_; }
+  Quest_Real identityCoeff() const { return identityCoeff_; }
+  int maxQubit() const { return maxQubit_; }
+
+  // Rotates `qureg` so measuring the group's qubits in Z measures its terms
+  void rotateToGroupBasis(Qureg& qureg, std::size_t group) const;
+
+ private:
+  std::vector<CommutingGroup> groups_;
+  Quest_Real identityCoeff_ = 0;
+  int maxQubit_ = -1;
+};
+
+// Hamiltonians
+std::unique_ptr<AnalysedHamiltonian> createAnalysedHamiltonian(
+    const PauliStrSum& sum);
+
+std::size_t getAnalysedHamiltonianNumGroups(const AnalysedHamiltonian& ham);
+
+rust::Slice<const int> getAnalysedHamiltonianGroupQubits(
+    const AnalysedHamiltonian& ham,
+    std::size_t group);
+
+Quest_Real calcExpecAnalysedHamiltonian(const Qureg& qureg,
+                                        const AnalysedHamiltonian& ham,
+                                        Qureg& workspace);
+
+void setQuregToHamiltonianGroupBasis(Qureg& out,
+                                     const Qureg& in,
+                                     const AnalysedHamiltonian& ham,
+                                     std::size_t group);
+
+void allocateAnalysedHamiltonianShots(rust::Slice<std::uint64_t> counts,
+                                      const AnalysedHamiltonian& ham,
+                                      std::uint64_t numShots);
+}  // namespace quest_sys
@@ -4,13 +4,22 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <ranges>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
 #include "rust/cxx.h"
+#include "types.hpp"
+
+#if COMPILE_MPI
+#include <mpi.h>
+#endif
 
 namespace detail {
 // Type trait to check if T is rust::Slice (including const-qualified elements)
@@ -195,4 +204,176 @@ auto slice_to_vector(const SliceType& slice) {
   }
 }
 
+// Validates a block of a density matrix against the Qureg and the caller's
+// buffer, which must hold exactly the block when writing and at least the
+// block when reading
+inline bool validate_density_block(const Qureg& qureg,
+                                   Quest_Index startRow,
+                                   Quest_Index startCol,
+                                   Quest_Index numRows,
+                                   Quest_Index numCols,
+                                   std::size_t bufferLength,
+                                   bool isWrite,
+                                   const char* caller) {
+  const Quest_Index dim = Quest_Index{1} << qureg.numQubits;
+  if (!qureg.isDensityMatrix) {
+    ::invalidQuESTInputError("Expected a density matrix Qureg.", caller);
+    return false;
+  }
+  if (startRow < 0 || startCol < 0 || numRows < 0 || numCols < 0 ||
+      startRow + numRows > dim || startCol + numCols > dim) {
+    ::invalidQuESTInputError(
+        "The block of amplitudes exceeds the density matrix.", caller);
+    return false;
+  }
+  auto length = static_cast<Quest_Index>(bufferLength);
+  if (isWrite && length != numRows * numCols) {
+    ::invalidQuESTInputError(
+        "The number of amplitudes does not match the block dimensions.",
+        caller);
+    return false;
+  }
+  if (!isWrite && length < numRows * numCols) {
+    ::invalidQuESTInputError(
+        "The output buffer is too small for the requested block.", caller);
+    return false;
+  }
+  return true;
+}
+
+// Largest block handed to QuEST per call when it has to move the data itself
+constexpr Quest_Index max_bulk_chunk = Quest_Index{1} << 30;
+
+// Threads bulk helpers may use: QuEST's OpenMP thread count when it is set,
+// otherwise one per hardware thread
+inline Quest_Index max_worker_threads() {
+  static const Quest_Index count = [] {
+    if (const char* env = std::getenv("OMP_NUM_THREADS")) {
+      long value = std::strtol(env, nullptr, 10);
+      if (value > 0) {
+        return static_cast<Quest_Index>(value);
+      }
+    }
+    return static_cast<Quest_Index>(
+        std::max(1u, std::thread::hardware_concurrency()));
+  }();
+  return count;
+}
+
+// Splits [0, total) into contiguous ranges of at least `grain` elements and
+// runs func(begin, end) on each, one range per worker thread. Like QuEST's own
+// kernels it stays on the calling thread unless `multithreaded` is set, so
+// callers already running in parallel on single-threaded quregs (or with
+// QuEST's threading off) are not oversubscribed.
+template <typename Func>
+void parallel_for(bool multithreaded,
+                  Quest_Index total,
+                  Quest_Index grain,
+                  Func&& func) {
+  if (total <= 0) {
+    return;
+  }
+  Quest_Index numWorkers =
+      multithreaded ? std::min(max_worker_threads(),
+                               (total + grain - 1) /
+                                   std::max<Quest_Index>(grain, 1))
+                    : 1;
+  if (numWorkers <= 1) {
+    func(Quest_Index{0}, total);
+    return;
+  }
+  Quest_Index perWorker = (total + numWorkers - 1) / numWorkers;
+  std::vector<std::thread> workers;
+  workers.reserve(static_cast<std::size_t>(numWorkers - 1));
+  for (Quest_Index begin = perWorker; begin < total; begin += perWorker) {
+    Quest_Index end = std::min(begin + perWorker, total);
+    workers.emplace_back([&func, begin, end] { func(begin, end); });
+  }
+  func(Quest_Index{0}, std::min(perWorker, total));
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+// Copy for bulk amplitude transfers, multithreaded when the destination is
+template <typename T>
+void parallel_copy(bool multithreaded,
+                   const T* src,
+                   T* dst,
+                   Quest_Index count) {
+  constexpr Quest_Index grain = Quest_Index{1} << 20;
+  parallel_for(multithreaded, count, grain,
+               [src, dst](Quest_Index begin, Quest_Index end) {
+                 std::copy(src + begin, src + end, dst + begin);
+               });
+}
+
+// Rank 0's value of `flag` on every rank, so a distributed Qureg's ranks agree
+// on an outcome only the root observed (such as opening a file) before they
+// enter a collective call. Every rank must call it, so only call it when the
+// environment is distributed.
+inline bool root_flag(bool flag) {
+#if COMPILE_MPI
+  int value = flag ? 1 : 0;
+  MPI_Bcast(&value, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  return value != 0;
+#else
+  return flag;
+#endif
+}
+
+// The Pauli a string applies to one qubit, as QuEST packs them two bits per
+// qubit: 0=I, 1=X, 2=Y, 3=Z
+constexpr int max_pauli_qubits = 64;
+
+inline int pauli_code(const PauliStr& str, int qubit) {
+  auto word = qubit < 32 ? str.lowPaulis : str.highPaulis;
+  return static_cast<int>((word >> (2 * (qubit % 32))) & 3);
+}
+
+// Streaming 64-bit checksum over raw bytes, consumed a word at a time so it
+// keeps up with large sequential payloads
+class Hasher {
+ public:
+  explicit Hasher(std::uint64_t seed = 0) : state_(offset_basis ^ seed) {}
+
+  void update(const void* data, std::size_t numBytes) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= numBytes; i += sizeof(std::uint64_t)) {
+      std::uint64_t word;
+      std::memcpy(&word, bytes + i, sizeof(word));
+      mix(word);
+    }
+    for (; i < numBytes; ++i) {
+      mix(bytes[i]);
+    }
+    length_ += numBytes;
+  }
+
+  std::uint64_t digest() const {
+    // final avalanche so short inputs still spread over all bits
+    std::uint64_t h = state_ ^ length_;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+ private:
+  static constexpr std::uint64_t offset_basis = 0xcbf29ce484222325ULL;
+  static constexpr std::uint64_t prime = 0x100000001b3ULL;
+
+  void mix(std::uint64_t word) {
+    state_ ^= word;
+    state_ *= prime;
+    state_ ^= state_ >> 29;
+  }
+
+  std::uint64_t state_;
+  std::uint64_t length_ = 0;
+};
+
 }  // namespace quest_helper
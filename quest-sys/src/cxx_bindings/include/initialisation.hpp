@@ -37,10 +37,25 @@ void setDensityQuregAmps(
     Quest_Index startCol,
     rust::Slice<const rust::Slice<const Quest_Complex>> amps);
 
+// Row-major block of numRows x numCols amplitudes in one flat slice
+void setDensityQuregAmpsFlat(Qureg& qureg,
+                             Quest_Index startRow,
+                             Quest_Index startCol,
+                             Quest_Index numRows,
+                             Quest_Index numCols,
+                             rust::Slice<const Quest_Complex> amps);
+
 void setDensityQuregFlatAmps(Qureg& qureg,
                              Quest_Index startInd,
                              rust::Slice<const Quest_Complex> amps);
 
+// Bulk loader behind setQuregAmps and setDensityQuregFlatAmps, shared with
+// other C++ callers holding raw amplitudes in QuEST's flat order
+void setQuregFlatAmps(Qureg& qureg,
+                      Quest_Index startInd,
+                      const qcomp* amps,
+                      Quest_Index numAmps);
+
 void setQuregToClone(Qureg& targetQureg, const Qureg& copyQureg);
 
 void setQuregToSuperposition(Quest_Complex facOut,
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace quest_helper {
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool is_open() const { return opened_; }
+
+  const std::byte* data() const { return data_; }
+
+  std::size_t size() const { return size_; }
+
+  // Hints the kernel that the mapping will be read front to back
+  void advise_sequential() const;
+
+ private:
+  const std::byte* data_ = nullptr;
+  std::size_t size_ = 0;
+  bool opened_ = false;
+#if defined(_WIN32)
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+};
+}  // namespace quest_helper
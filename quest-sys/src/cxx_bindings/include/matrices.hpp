@@ -16,6 +16,11 @@ std::unique_ptr<CompMatr1> getCompMatr1(
 std::unique_ptr<CompMatr2> getCompMatr2(
     rust::Slice<const rust::Slice<const Quest_Complex>> in);
 
+// Row-major flat input, without a table of row slices
+std::unique_ptr<CompMatr1> getCompMatr1Flat(rust::Slice<const Quest_Complex> in);
+
+std::unique_ptr<CompMatr2> getCompMatr2Flat(rust::Slice<const Quest_Complex> in);
+
 std::unique_ptr<DiagMatr1> getDiagMatr1(rust::Slice<const Quest_Complex> in);
 
 std::unique_ptr<DiagMatr2> getDiagMatr2(rust::Slice<const Quest_Complex> in);
@@ -44,6 +49,10 @@ void syncFullStateDiagMatr(FullStateDiagMatr& matr);
 void setCompMatr(CompMatr& out,
                  rust::Slice<const rust::Slice<const Quest_Complex>> in);
 
+void setCompMatrFlat(CompMatr& out,
+                     rust::Slice<const Quest_Complex> in,
+                     Quest_Index dim);
+
 void setDiagMatr(DiagMatr& out, rust::Slice<const Quest_Complex> in);
 
 void setFullStateDiagMatr(FullStateDiagMatr& out,
@@ -0,0 +1,108 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "types.hpp"
+
+namespace quest_sys {
+// Idle matrices of one kind, keyed by their number of qubits
+template <typename Matr>
+class MatrixShelf {
+ public:
+  ~MatrixShelf() { clear(); }
+
+  // Pops an idle matrix, or returns false when none has this width
+  bool take(int numQubits, Matr& out);
+  void put(Matr matr);
+  void clear();
+  std::size_t size() const;
+
+ private:
+  std::map<int, std::vector<Matr>> idle_;
+};
+
+// Shared by a pool and every handle it has given out, so handles can be
+// released after the pool itself is dropped
+struct MatrixPoolState {
+  std::mutex mutex;
+  MatrixShelf<CompMatr> compMatrices;
+  MatrixShelf<DiagMatr> diagMatrices;
+  MatrixShelf<FullStateDiagMatr> fullStateMatrices;
+};
+
+// Owns a matrix borrowed from a pool and hands it back when destroyed
+template <typename Matr>
+class PooledMatrix {
+ public:
+  PooledMatrix(std::shared_ptr<MatrixPoolState> state, Matr matr)
+      : state_(std::move(state)), matr_(matr) {}
+  ~PooledMatrix();
+
+  PooledMatrix(const PooledMatrix&) = delete;
+  PooledMatrix& operator=(const PooledMatrix&) = delete;
+
+  Matr& get() { return matr_; }
+  const Matr& get() const { return matr_; }
+
+ private:
+  std::shared_ptr<MatrixPoolState> state_;
+  Matr matr_;
+};
+
+using PooledCompMatr = PooledMatrix<CompMatr>;
+using PooledDiagMatr = PooledMatrix<DiagMatr>;
+using PooledFullStateDiagMatr = PooledMatrix<FullStateDiagMatr>;
+
+// Recycles CompMatr, DiagMatr and FullStateDiagMatr objects by shape.
+// A reused matrix keeps the elements its previous holder left in it.
+class MatrixPool {
+ public:
+  MatrixPool() : state_(std::make_shared<MatrixPoolState>()) {}
+
+  std::unique_ptr<PooledCompMatr> acquireCompMatr(int numQubits);
+  std::unique_ptr<PooledDiagMatr> acquireDiagMatr(int numQubits);
+  std::unique_ptr<PooledFullStateDiagMatr> acquireFullStateDiagMatr(
+      int numQubits);
+
+  std::size_t numIdle() const;
+  void clear();
+
+ private:
+  std::shared_ptr<MatrixPoolState> state_;
+};
+
+// Matrix pools
+std::unique_ptr<MatrixPool> createMatrixPool();
+
+std::unique_ptr<PooledCompMatr> acquireCompMatr(MatrixPool& pool,
+                                                int numQubits);
+
+std::unique_ptr<PooledDiagMatr> acquireDiagMatr(MatrixPool& pool,
+                                                int numQubits);
+
+std::unique_ptr<PooledFullStateDiagMatr> acquireFullStateDiagMatr(
+    MatrixPool& pool,
+    int numQubits);
+
+const CompMatr& getPooledCompMatr(const PooledCompMatr& handle);
+
+CompMatr& getPooledCompMatrMut(PooledCompMatr& handle);
+
+const DiagMatr& getPooledDiagMatr(const PooledDiagMatr& handle);
+
+DiagMatr& getPooledDiagMatrMut(PooledDiagMatr& handle);
+
+const FullStateDiagMatr& getPooledFullStateDiagMatr(
+    const PooledFullStateDiagMatr& handle);
+
+FullStateDiagMatr& getPooledFullStateDiagMatrMut(
+    PooledFullStateDiagMatr& handle);
+
+std::size_t getMatrixPoolNumIdle(const MatrixPool& pool);
+
+void clearMatrixPool(MatrixPool& pool);
+}  // namespace quest_sys
@@ -0,0 +1,144 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "circuit.hpp"
+#include "types.hpp"
+
+namespace quest_sys {
+enum class ChannelKind : std::uint32_t {
+  Dephasing,
+  Depolarising,
+  Damping,
+  Paulis,
+  TwoQubitDephasing,
+  TwoQubitDepolarising,
+  Kraus
+};
+
+// A channel in both forms: its parameters, for QuEST's dedicated mix*
+// kernels, and its Kraus operators (operators x dim x dim, row-major) for
+// composing it with gates
+struct NoiseChannel {
+  ChannelKind kind;
+  std::array<qreal, 3> params{};
+  int numQubits = 1;
+  int numOperators = 0;
+  std::vector<qcomp> kraus;
+};
+
+// Attaches a channel after every instruction of a kind, optionally only on an
+// exact operand list. A channel as wide as the instruction acts on all its
+// operands; a one-qubit channel acts on each operand in turn.
+struct NoiseRule {
+  GateKind kind;
+  std::vector<int> qubits;  // empty matches any operands
+  std::uint32_t channel;
+};
+
+class NoiseModel {
+ public:
+  std::uint32_t addChannel(NoiseChannel channel);
+  void addRule(NoiseRule rule);
+
+  const std::vector<NoiseChannel>& channels() const { return channels_; }
+  const std::vector<NoiseRule>& rules() const { return rules_; }
+
+ private:
+  std::vector<NoiseChannel> channels_;
+  std::vector<NoiseRule> rules_;
+};
+
+// A channel application resolved against one instruction's operands
+struct ChannelTarget {
+  std::uint32_t channel;
+  std::vector<int> operands;  // positions within the instruction's operands
+};
+
+// The channels a model attaches to one instruction, in rule order.
+// Returns false after reporting an error if a channel does not fit.
+bool resolveNoiseRules(const NoiseModel& model,
+                       const CircuitTape& tape,
+                       const TapeInstruction& inst,
+                       std::vector<ChannelTarget>& out);
+
+// A tape with its noise attached, ready to replay on density matrices. Gates
+// whose trailing channels fit within the fusion width are premultiplied into
+// one SuperOp each.
+class NoisyCircuit {
+ public:
+  NoisyCircuit() = default;
+  ~NoisyCircuit();
+
+  NoisyCircuit(const NoisyCircuit&) = delete;
+  NoisyCircuit& operator=(const NoisyCircuit&) = delete;
+
+  void apply(Qureg& qureg) const;
+
+  std::size_t numSuperOps() const { return superOps_.size(); }
+
+ private:
+  friend std::unique_ptr<NoisyCircuit> compileNoisyCircuit(
+      const CircuitTape& tape,
+      const NoiseModel& model,
+      int maxFusedQubits);
+
+  enum class StepKind { Gates, SuperOp, Channel };
+  struct Step {
+    StepKind kind;
+    std::size_t begin;  // gate range, or the SuperOp / channel index
+    std::size_t end;
+    std::vector<int> targets;
+  };
+
+  void applyChannel(Qureg& qureg, const Step& step) const;
+
+  std::unique_ptr<CircuitTape> gates_;
+  std::vector<Step> steps_;
+  std::vector<NoiseChannel> channels_;
+  std::vector<KrausMap> krausMaps_;  // per channel, for Kraus channels only
+  std::vector<::SuperOp> superOps_;
+  int maxQubit_ = -1;
+};
+
+// Noise models
+std::unique_ptr<NoiseModel> createNoiseModel();
+
+std::uint32_t addDephasingChannel(NoiseModel& model, Quest_Real prob);
+
+std::uint32_t addDepolarisingChannel(NoiseModel& model, Quest_Real prob);
+
+std::uint32_t addDampingChannel(NoiseModel& model, Quest_Real prob);
+
+std::uint32_t addPauliChannel(NoiseModel& model,
+                              Quest_Real probX,
+                              Quest_Real probY,
+                              Quest_Real probZ);
+
+std::uint32_t addTwoQubitDephasingChannel(NoiseModel& model, Quest_Real prob);
+
+std::uint32_t addTwoQubitDepolarisingChannel(NoiseModel& model,
+                                             Quest_Real prob);
+
+std::uint32_t addKrausChannel(NoiseModel& model,
+                              int numQubits,
+                              int numOperators,
+                              rust::Slice<const Quest_Complex> matrices);
+
+void addNoiseRule(NoiseModel& model,
+                  std::uint32_t opcode,
+                  rust::Slice<const int> qubits,
+                  std::uint32_t channel);
+
+std::unique_ptr<NoisyCircuit> compileNoisyCircuit(const CircuitTape& tape,
+                                                  const NoiseModel& model,
+                                                  int maxFusedQubits);
+
+void applyNoisyCircuit(Qureg& qureg, const NoisyCircuit& circuit);
+
+std::size_t getNoisyCircuitNumSuperOps(const NoisyCircuit& circuit);
+}  // namespace quest_sys
@@ -0,0 +1,61 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+namespace quest_sys {
+// A Pauli string reduced to what a statevector sweep needs: P|i> =
+// phase * (-1)^popcount(i & zMask) |i ^ xMask>, with the coefficient and the
+// i^numY of its Y factors folded into `phase`
+struct BatchTerm {
+  std::uint64_t zMask;
+  qcomp phase;
+  std::uint32_t sum;
+};
+
+// Terms from any of the sums that flip the same qubits
+struct BatchGroup {
+  std::uint64_t xMask;
+  std::vector<BatchTerm> terms;
+};
+
+// Many Hermitian PauliStrSums evaluated together. Terms are grouped by their
+// X/Y flip mask across every sum so each group costs a single sweep of the
+// statevector, however many terms and observables share it.
+class PauliStrSumBatch {
+ public:
+  PauliStrSumBatch() = default;
+  ~PauliStrSumBatch();
+  PauliStrSumBatch(const PauliStrSumBatch&) = delete;
+  PauliStrSumBatch& operator=(const PauliStrSumBatch&) = delete;
+
+  // Copies the sum; returns its index in the results
+  std::uint32_t add(const PauliStrSum& sum);
+
+  const std::vector<BatchGroup>& groups() const { return groups_; }
+  const std::vector<PauliStrSum>& sums() const { return sums_; }
+  int maxQubit() const { return maxQubit_; }
+
+ private:
+  std::vector<BatchGroup> groups_;
+  std::unordered_map<std::uint64_t, std::size_t> groupIndex_;
+  std::vector<PauliStrSum> sums_;  // owned copies, for registers we cannot sweep
+  int maxQubit_ = -1;
+};
+
+// Pauli batches
+std::unique_ptr<PauliStrSumBatch> createPauliStrSumBatch();
+
+std::uint32_t addPauliStrSumToBatch(PauliStrSumBatch& batch,
+                                    const PauliStrSum& sum);
+
+std::size_t getPauliStrSumBatchNumGroups(const PauliStrSumBatch& batch);
+
+rust::Vec<Quest_Real> calcExpecPauliStrSums(const Qureg& qureg,
+                                            const PauliStrSumBatch& batch);
+}  // namespace quest_sys
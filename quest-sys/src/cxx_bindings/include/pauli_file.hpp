@@ -0,0 +1,31 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <cstdint>
+#include <memory>
+
+#include "types.hpp"
+
+namespace quest_sys {
+// Pauli files
+// Reads QuEST's text format (a coefficient then one Pauli per qubit on each
+// line, leftmost on the highest qubit unless reversed) by mapping the file
+// and parsing line-aligned chunks on every core
+std::unique_ptr<PauliStrSum> loadPauliStrSumFile(rust::String path,
+                                                 bool isReversed);
+
+// As above, but split into chunks of about chunkBytes however many cores
+// there are, to tune or test the chunked parser
+std::unique_ptr<PauliStrSum> loadPauliStrSumFileInChunks(
+    rust::String path,
+    bool isReversed,
+    std::uint64_t chunkBytes);
+
+void savePauliStrSumBinary(const PauliStrSum& sum, rust::String path);
+
+std::unique_ptr<PauliStrSum> loadPauliStrSumBinary(rust::String path);
+
+void convertPauliStrSumFileToBinary(rust::String textPath,
+                                    rust::String binaryPath,
+                                    bool isReversed);
+}  // namespace quest_sys
@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+namespace quest_helper {
+// Wall time is bucketed log-linearly: exact below 8ns, then four buckets per
+// power of two, so reported percentiles are within 12.5% of the true value
+constexpr int num_latency_buckets = 8 + 61 * 4;
+
+// Counters for one wrapper function. Sites are function-local statics that
+// register themselves on first use and live until exit.
+struct ProfileSite {
+  explicit ProfileSite(const char* name);
+
+  const char* name;
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> totalNs{0};
+  std::atomic<std::uint64_t> maxNs{0};
+  std::atomic<std::uint64_t> bytes{0};
+  std::array<std::atomic<std::uint64_t>, num_latency_buckets> buckets{};
+};
+
+// Times the enclosing scope and charges it to a site
+class ProfileScope {
+ public:
+  ProfileScope(ProfileSite& site, std::uint64_t bytes);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  ProfileSite& site_;
+  std::uint64_t bytes_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+struct ProfileStats {
+  std::string name;
+  std::uint64_t calls;
+  std::uint64_t totalNs;
+  std::uint64_t p50Ns;
+  std::uint64_t p90Ns;
+  std::uint64_t p99Ns;
+  std::uint64_t maxNs;
+  std::uint64_t bytes;
+};
+
+// Sites that have been called at least once, in order of first use
+std::vector<ProfileStats> profile_snapshot();
+
+void reset_profile();
+
+// Keeps the most recent numEvents calls for a Chrome trace; zero disables
+// tracing and discards any recorded events
+void set_profile_trace_capacity(std::uint64_t numEvents);
+
+std::string profile_json();
+
+std::string profile_chrome_trace();
+
+// Bytes charged to a wrapper that makes one pass over the local amplitudes
+inline std::uint64_t profile_bytes(const Qureg& qureg) {
+  return static_cast<std::uint64_t>(qureg.numAmpsPerNode) * sizeof(qcomp);
+}
+}  // namespace quest_helper
+
+// Records the enclosing wrapper under its own name when built with the
+// profiling feature. Otherwise the byte count is not even evaluated.
+#if defined(QUEST_SYS_PROFILING)
+#define QUEST_SYS_PROFILE(bytes)                                      \
+  static quest_helper::ProfileSite quest_sys_profile_site_(__func__); \
+  const quest_helper::ProfileScope quest_sys_profile_scope_(          \
+      quest_sys_profile_site_, static_cast<std::uint64_t>(bytes))
+#else
+#define QUEST_SYS_PROFILE(bytes) static_cast<void>(0)
+#endif
@@ -47,12 +47,37 @@ rust::Vec<Quest_Complex> getQuregAmps(Qureg& qureg,
                                       Quest_Index startInd,
                                       Quest_Index numAmps);
 
+void getQuregAmpsInto(Qureg& qureg,
+                      Quest_Index startInd,
+                      rust::Slice<Quest_Complex> outAmps);
+
+// Borrows the CPU amplitudes of a non-distributed, CPU-only statevector
+rust::Slice<const Quest_Complex> getQuregAmpsView(const Qureg& qureg);
+
+bool isQuregAmpsViewable(const Qureg& qureg);
+
 rust::Vec<Quest_Complex> getDensityQuregAmps_flatten(Qureg& qureg,
                                                      Quest_Index startRow,
                                                      Quest_Index startCol,
                                                      Quest_Index numRows,
                                                      Quest_Index numCols);
 
+// Fills a contiguous row-major buffer with a block of the density matrix
+void getDensityQuregAmpsInto(Qureg& qureg,
+                             Quest_Index startRow,
+                             Quest_Index startCol,
+                             Quest_Index numRows,
+                             Quest_Index numCols,
+                             rust::Slice<Quest_Complex> outAmps);
+
+// As above, but fills the buffer in column-major order
+void getDensityQuregAmpsColMajorInto(Qureg& qureg,
+                                     Quest_Index startRow,
+                                     Quest_Index startCol,
+                                     Quest_Index numRows,
+                                     Quest_Index numCols,
+                                     rust::Slice<Quest_Complex> outAmps);
+
 Quest_Complex getQuregAmp(Qureg& qureg, Quest_Index index);
 
 Quest_Complex getDensityQuregAmp(Qureg& qureg,
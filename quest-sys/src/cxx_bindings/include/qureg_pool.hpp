@@ -0,0 +1,117 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <compare>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "types.hpp"
+
+namespace quest_sys {
+struct QuregPoolStats;
+
+// What a register was requested as. Deployment flags of -1 leave the choice
+// to QuEST, as createQureg does.
+struct QuregShape {
+  int numQubits;
+  int isDensityMatrix;
+  int isDistributed;
+  int isGpuAccelerated;
+  int isMultithreaded;
+
+  auto operator<=>(const QuregShape&) const = default;
+};
+
+// How an acquired register is initialised. Fresh registers already hold the
+// zero state, so only reused ones pay for initZeroState. Shared with the Rust
+// bridge, which checks these values at compile time.
+enum class QuregInit : std::int32_t { Keep = 0, Blank = 1, Zero = 2 };
+
+// Shared by a pool and every handle it has given out, so handles can be
+// released after the pool itself is dropped
+struct QuregPoolState {
+  ~QuregPoolState();
+
+  std::mutex mutex;
+  // Idle registers by their actual shape
+  std::map<QuregShape, std::vector<Qureg>> idle;
+  // The actual shape QuEST chose for each requested shape
+  std::map<QuregShape, QuregShape> resolved;
+  std::uint64_t numIdle = 0;
+  std::uint64_t numInUse = 0;
+  std::uint64_t highWaterMark = 0;
+  std::uint64_t numCreated = 0;
+  std::uint64_t numReused = 0;
+  std::uint64_t idleBytes = 0;
+};
+
+// Owns a register borrowed from a pool and hands it back when destroyed
+class PooledQureg {
+ public:
+  PooledQureg(std::shared_ptr<QuregPoolState> state, Qureg qureg)
+      : state_(std::move(state)), qureg_(qureg) {}
+  ~PooledQureg();
+
+  PooledQureg(const PooledQureg&) = delete;
+  PooledQureg& operator=(const PooledQureg&) = delete;
+
+  Qureg& get() { return qureg_; }
+  const Qureg& get() const { return qureg_; }
+
+ private:
+  std::shared_ptr<QuregPoolState> state_;
+  Qureg qureg_;
+};
+
+// Recycles Qureg objects by size, type and deployment, so short-lived
+// scratch registers do not reallocate their amplitudes (and GPU memory)
+class QuregPool {
+ public:
+  QuregPool() : state_(std::make_shared<QuregPoolState>()) {}
+
+  std::unique_ptr<PooledQureg> acquire(const QuregShape& shape,
+                                       QuregInit init);
+  // A register deployed like `qureg` and holding a copy of its state
+  std::unique_ptr<PooledQureg> acquireClone(const Qureg& qureg);
+
+  QuregPoolStats stats() const;
+  // Destroys the idle registers; those in use return to the pool later
+  void clear();
+
+ private:
+  std::shared_ptr<QuregPoolState> state_;
+};
+
+// Qureg pools
+std::unique_ptr<QuregPool> createQuregPool();
+
+std::unique_ptr<PooledQureg> acquireQureg(QuregPool& pool,
+                                          int numQubits,
+                                          int initialState);
+
+std::unique_ptr<PooledQureg> acquireDensityQureg(QuregPool& pool,
+                                                 int numQubits,
+                                                 int initialState);
+
+std::unique_ptr<PooledQureg> acquireCustomQureg(QuregPool& pool,
+                                                int numQubits,
+                                                int isDensMatr,
+                                                int useDistrib,
+                                                int useGpuAccel,
+                                                int useMultithread,
+                                                int initialState);
+
+std::unique_ptr<PooledQureg> acquireCloneQureg(QuregPool& pool,
+                                               const Qureg& qureg);
+
+const Qureg& getPooledQureg(const PooledQureg& handle);
+
+Qureg& getPooledQuregMut(PooledQureg& handle);
+
+QuregPoolStats getQuregPoolStats(const QuregPool& pool);
+
+void clearQuregPool(QuregPool& pool);
+}  // namespace quest_sys
@@ -0,0 +1,79 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "circuit.hpp"
+#include "types.hpp"
+
+namespace quest_sys {
+// Sets the angle of one tape instruction to scale * row[column]. Several
+// bindings may share a column.
+struct ParameterBinding {
+  std::uint32_t paramIndex;  // into the tape's parameter buffer
+  std::uint32_t column;
+  qreal scale;
+};
+
+// A circuit tape whose rotation angles are read from a row of a parameter
+// matrix. It keeps its own copy of the tape.
+class ParameterisedCircuit {
+ public:
+  ParameterisedCircuit(std::unique_ptr<CircuitTape> tape,
+                       std::vector<ParameterBinding> bindings);
+
+  const CircuitTape& tape() const { return *tape_; }
+  const std::vector<ParameterBinding>& bindings() const { return bindings_; }
+  std::uint32_t numColumns() const { return numColumns_; }
+
+  // A copy of the same tape under other bindings
+  std::unique_ptr<ParameterisedCircuit> rebind(
+      std::vector<ParameterBinding> bindings) const;
+
+  // Writes the angles of one row into a buffer copied from the tape
+  void bind(const qreal* row, std::vector<qreal>& params) const;
+
+  std::vector<qreal> defaultParams() const;
+
+  void apply(Qureg& qureg, std::vector<qreal>& params, const qreal* row) const;
+
+ private:
+  std::unique_ptr<CircuitTape> tape_;
+  std::vector<ParameterBinding> bindings_;
+  std::uint32_t numColumns_ = 0;
+};
+
+// <observable> after the circuit on a copy of `initial` for each of `numSets`
+// rows of a valid row-major parameter matrix. Rows are shared out to workers
+// with private unthreaded registers; numWorkers <= 0 picks one per hardware
+// thread up to 20 qubits, and QuEST's own threading above that.
+std::vector<qreal> calcSweepExpectations(const Qureg& initial,
+                                         const ParameterisedCircuit& circuit,
+                                         const PauliStrSum& observable,
+                                         const qreal* rows,
+                                         std::size_t numSets,
+                                         int numWorkers);
+
+// Parameter sweeps
+std::unique_ptr<ParameterisedCircuit> createParameterisedCircuit(
+    const CircuitTape& tape,
+    rust::Slice<const std::uint32_t> instructions,
+    rust::Slice<const std::uint32_t> columns,
+    rust::Slice<const double> scales);
+
+std::uint32_t getParameterisedCircuitNumColumns(
+    const ParameterisedCircuit& circuit);
+
+void applyParameterisedCircuit(Qureg& qureg,
+                               const ParameterisedCircuit& circuit,
+                               rust::Slice<const double> row);
+
+// Validates `parameters` and evaluates calcSweepExpectations over its rows
+rust::Vec<Quest_Real> runParameterSweep(const Qureg& initial,
+                                        const ParameterisedCircuit& circuit,
+                                        const PauliStrSum& observable,
+                                        rust::Slice<const double> parameters,
+                                        int numWorkers);
+}  // namespace quest_sys
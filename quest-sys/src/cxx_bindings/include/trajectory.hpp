@@ -0,0 +1,51 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "circuit.hpp"
+#include "noise.hpp"
+#include "types.hpp"
+
+namespace quest_sys {
+// Per-trajectory expectation values, indexed by trajectory, with their sample
+// statistics. Trajectory i draws from a generator seeded by (seed, i) so the
+// samples do not depend on the number of workers.
+class TrajectoryResult {
+ public:
+  explicit TrajectoryResult(std::vector<Quest_Real> samples);
+
+  const std::vector<Quest_Real>& samples() const { return samples_; }
+  Quest_Real mean() const { return mean_; }
+  Quest_Real variance() const { return variance_; }
+  Quest_Real standardError() const;
+
+ private:
+  std::vector<Quest_Real> samples_;
+  Quest_Real mean_ = 0;
+  Quest_Real variance_ = 0;  // unbiased
+};
+
+// Simulates a noisy tape on statevectors, sampling one Kraus operator per
+// channel application, and evaluates the observable at the end of each
+// trajectory. Averages converge to the density-matrix expectation value.
+std::unique_ptr<TrajectoryResult> runNoisyTrajectories(
+    const Qureg& initial,
+    const CircuitTape& tape,
+    const NoiseModel& model,
+    const PauliStrSum& observable,
+    std::uint64_t numTrajectories,
+    int numWorkers,
+    std::uint64_t seed);
+
+Quest_Real getTrajectoryMean(const TrajectoryResult& result);
+
+Quest_Real getTrajectoryVariance(const TrajectoryResult& result);
+
+Quest_Real getTrajectoryStdError(const TrajectoryResult& result);
+
+rust::Slice<const Quest_Real> getTrajectorySamples(
+    const TrajectoryResult& result);
+}  // namespace quest_sys
@@ -0,0 +1,79 @@
+#pragma once
+#include <quest.h>
+#include <rust/cxx.h>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+
+namespace quest_sys {
+// A Hermitian term reduced to masks over the qubits of its block
+struct TrotterTerm {
+  PauliStr str;
+  Quest_Real coeff;
+  std::uint64_t support;
+};
+
+// Operations applied as a single pass: one Pauli gadget, a run of gadgets on
+// the same few qubits multiplied into a CompMatr, or every diagonal term of a
+// region folded into one DiagMatr of phases
+struct TrotterBlock {
+  enum class Kind { Gadget, Matrix, Diagonal };
+  Kind kind;
+  std::vector<TrotterTerm> terms;
+  std::vector<int> qubits;            // ascending
+  std::vector<Quest_Real> energies;   // Diagonal: sum of c_k * <b|P_k|b>
+  std::vector<CompMatr> matrices;     // Matrix: one per pass slot
+  std::vector<DiagMatr> diagonals;    // Diagonal: one per pass slot
+};
+
+// The gadget sequence of applyTrotterizedPauliStrSumGadget derived once from
+// a PauliStrSum, order and repetition count. Terms are reordered into blocks,
+// which are cheaper to replay but make a different (equally valid) product
+// formula when terms do not commute. Block matrices are refilled only when
+// the angle changes.
+class TrotterSchedule {
+ public:
+  TrotterSchedule(const PauliStrSum& sum, int order, int reps);
+  ~TrotterSchedule();
+  TrotterSchedule(const TrotterSchedule&) = delete;
+  TrotterSchedule& operator=(const TrotterSchedule&) = delete;
+
+  void apply(Qureg& qureg, Quest_Real angle);
+
+  int maxQubit() const { return maxQubit_; }
+  // Operations per application, before and after blocking
+  Quest_Index numTermSweeps() const;
+  Quest_Index numBlockSweeps() const;
+
+ private:
+  void refill(Quest_Real angle);
+
+  std::vector<TrotterBlock> blocks_;
+  // First-order passes of one repetition: (angle factor, reversed), each
+  // mapped to the slot holding its block matrices
+  std::vector<std::pair<Quest_Real, bool>> passes_;
+  std::vector<std::size_t> passSlot_;
+  std::vector<std::pair<Quest_Real, bool>> slots_;
+  Quest_Index numTerms_ = 0;
+  int reps_;
+  int maxQubit_ = -1;
+  bool isFilled_ = false;
+  Quest_Real filledAngle_ = 0;
+};
+
+// Trotter schedules
+std::unique_ptr<TrotterSchedule> createTrotterSchedule(const PauliStrSum& sum,
+                                                       int order,
+                                                       int reps);
+
+void applyTrotterSchedule(Qureg& qureg,
+                          TrotterSchedule& schedule,
+                          Quest_Real angle);
+
+Quest_Index getTrotterScheduleNumSweeps(const TrotterSchedule& schedule);
+
+Quest_Index getTrotterScheduleSweepsSaved(const TrotterSchedule& schedule);
+}  // namespace quest_sys
@@ -3,52 +3,104 @@
 //
 #include "initialisation.hpp"
 #include "helper.hpp"
+#include "profiling.hpp"
 
 namespace quest_sys {
+namespace {
+using quest_helper::max_bulk_chunk;
+
+void set_flat_amps(Qureg& qureg,
+                   Quest_Index startInd,
+                   const qcomp* amps,
+                   Quest_Index numAmps,
+                   bool expectDensityMatrix,
+                   const char* caller) {
+  if (qureg.isDistributed || qureg.isGpuAccelerated) {
+    // QuEST routes each chunk to the right node or device
+    for (Quest_Index done = 0; done < numAmps; done += max_bulk_chunk) {
+      Quest_Index len = std::min(max_bulk_chunk, numAmps - done);
+      auto* chunk = const_cast<qcomp*>(amps + done);
+      if (expectDensityMatrix) {
+        ::setDensityQuregFlatAmps(qureg, startInd + done, chunk, len);
+      } else {
+        ::setQuregAmps(qureg, startInd + done, chunk, len);
+      }
+    }
+    return;
+  }
+
+  if (static_cast<bool>(qureg.isDensityMatrix) != expectDensityMatrix) {
+    ::invalidQuESTInputError(expectDensityMatrix
+                                 ? "Expected a density matrix Qureg."
+                                 : "Expected a statevector Qureg.",
+                             caller);
+    return;
+  }
+  if (startInd < 0 || numAmps < 0 || startInd + numAmps > qureg.numAmps) {
+    ::invalidQuESTInputError(
+        "The amplitudes to set exceed the bounds of the Qureg.", caller);
+    return;
+  }
+  quest_helper::parallel_copy(qureg.isMultithreaded, amps,
+                              qureg.cpuAmps + startInd, numAmps);
+}
+
+}  // namespace
+
 void initBlankState(Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::initBlankState(qureg);
 }
 
 void initZeroState(Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::initZeroState(qureg);
 }
 
 void initPlusState(Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::initPlusState(qureg);
 }
 
 void initPureState(Qureg& qureg, Qureg& pure) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::initPureState(qureg, pure);
 }
 
 void initClassicalState(Qureg& qureg, Quest_Index stateInd) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::initClassicalState(qureg, stateInd);
 }
 
 void initDebugState(Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::initDebugState(qureg);
 }
 
 void initArbitraryPureState(Qureg& qureg,
                             rust::Slice<const Quest_Complex> amps) {
+  QUEST_SYS_PROFILE(amps.length() * sizeof(Quest_Complex));
   ::initArbitraryPureState(
       qureg, Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(amps)));
 }
 
 void initRandomPureState(Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::initRandomPureState(qureg);
 }
 
 void initRandomMixedState(Qureg& qureg, Quest_Index numPureStates) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::initRandomMixedState(qureg, numPureStates);
 }
 
 void setQuregAmps(Qureg& qureg,
                   Quest_Index startInd,
                   rust::Slice<const Quest_Complex> amps) {
-  ::setQuregAmps(qureg, startInd,
-                 Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(amps)),
-                 static_cast<int>(amps.length()));
+  QUEST_SYS_PROFILE(amps.length() * sizeof(Quest_Complex));
+  set_flat_amps(qureg, startInd,
+                Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(amps)),
+                static_cast<Quest_Index>(amps.length()), false, __func__);
 }
 
 void setDensityQuregAmps(
@@ -56,8 +108,11 @@ void setDensityQuregAmps(
     Quest_Index startRow,
     Quest_Index startCol,
     rust::Slice<const rust::Slice<const Quest_Complex>> amps) {
-  int rows = static_cast<int>(amps.length());
-  int cols = static_cast<int>(amps[0].length());
+  QUEST_SYS_PROFILE(amps.empty() ? 0
+                                 : amps.length() * amps[0].length() *
+                                       sizeof(Quest_Complex));
+  auto rows = static_cast<Quest_Index>(amps.length());
+  auto cols = static_cast<Quest_Index>(amps[0].length());
 
   std::vector<qcomp*> tmp{};
   std::ranges::transform(amps, std::back_inserter(tmp), [](auto val) {
@@ -66,16 +121,75 @@ void setDensityQuregAmps(
   ::setDensityQuregAmps(qureg, startRow, startCol, tmp.data(), rows, cols);
 }
 
+void setDensityQuregAmpsFlat(Qureg& qureg,
+                             Quest_Index startRow,
+                             Quest_Index startCol,
+                             Quest_Index numRows,
+                             Quest_Index numCols,
+                             rust::Slice<const Quest_Complex> amps) {
+  QUEST_SYS_PROFILE(amps.length() * sizeof(Quest_Complex));
+  if (!quest_helper::validate_density_block(
+          qureg, startRow, startCol, numRows, numCols, amps.length(), true,
+          __func__)) {
+    return;
+  }
+  const qcomp* in =
+      Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(amps));
+
+  if (qureg.isDistributed) {
+    // QuEST needs row pointers, which can point straight into the slice
+    std::vector<qcomp*> rows(static_cast<std::size_t>(numRows));
+    for (Quest_Index r = 0; r < numRows; ++r) {
+      rows[static_cast<std::size_t>(r)] = const_cast<qcomp*>(in + r * numCols);
+    }
+    ::setDensityQuregAmps(qureg, startRow, startCol, rows.data(), numRows,
+                          numCols);
+    return;
+  }
+
+  // QuEST stores the density matrix column-major, so the row-major block is
+  // transposed tile-wise into place
+  constexpr Quest_Index tile = 32;
+  const Quest_Index dim = Quest_Index{1} << qureg.numQubits;
+  for (Quest_Index colTile = 0; colTile < numCols; colTile += tile) {
+    Quest_Index colEnd = std::min(colTile + tile, numCols);
+    for (Quest_Index rowTile = 0; rowTile < numRows; rowTile += tile) {
+      Quest_Index rowEnd = std::min(rowTile + tile, numRows);
+      for (Quest_Index c = colTile; c < colEnd; ++c) {
+        qcomp* column = qureg.cpuAmps + startRow + (startCol + c) * dim;
+        for (Quest_Index r = rowTile; r < rowEnd; ++r) {
+          column[r] = in[r * numCols + c];
+        }
+      }
+    }
+  }
+  if (qureg.isGpuAccelerated) {
+    for (Quest_Index c = 0; c < numCols; ++c) {
+      ::syncSubQuregToGpu(qureg, startRow + (startCol + c) * dim, numRows);
+    }
+  }
+}
+
 void setDensityQuregFlatAmps(Qureg& qureg,
                              Quest_Index startInd,
                              rust::Slice<const Quest_Complex> amps) {
-  ::setDensityQuregFlatAmps(
-      qureg, startInd,
-      Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(amps)),
-      static_cast<int>(amps.length()));
+  QUEST_SYS_PROFILE(amps.length() * sizeof(Quest_Complex));
+  set_flat_amps(qureg, startInd,
+                Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(amps)),
+                static_cast<Quest_Index>(amps.length()), true, __func__);
+}
+
+void setQuregFlatAmps(Qureg& qureg,
+                      Quest_Index startInd,
+                      const qcomp* amps,
+                      Quest_Index numAmps) {
+  QUEST_SYS_PROFILE(std::max<Quest_Index>(numAmps, 0) * sizeof(qcomp));
+  set_flat_amps(qureg, startInd, amps, numAmps,
+                static_cast<bool>(qureg.isDensityMatrix), __func__);
 }
 
 void setQuregToClone(Qureg& targetQureg, const Qureg& copyQureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(targetQureg));
   ::setQuregToClone(targetQureg, copyQureg);
 }
 
@@ -85,14 +199,17 @@ void setQuregToSuperposition(Quest_Complex facOut,
                              const Qureg& qureg1,
                              Quest_Complex fac2,
                              const Qureg& qureg2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(out));
   ::setQuregToSuperposition(facOut, out, fac1, qureg1, fac2, qureg2);
 }
 
 Quest_Real setQuregToRenormalized(Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::setQuregToRenormalized(qureg);
 }
 
 void setQuregToPauliStrSum(Qureg& qureg, const PauliStrSum& sum) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::setQuregToPauliStrSum(qureg, sum);
 }
 }  // namespace quest_sys
@@ -0,0 +1,100 @@
+#include "mapped_file.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace quest_helper {
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::string& path) {
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    return;
+  }
+  file_ = file;
+  opened_ = true;
+  size_ = static_cast<std::size_t>(size.QuadPart);
+  if (size_ == 0) {
+    return;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    opened_ = false;
+    return;
+  }
+  mapping_ = mapping;
+  data_ = static_cast<const std::byte*>(
+      MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    opened_ = false;
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(static_cast<HANDLE>(mapping_));
+  }
+  if (file_ != nullptr) {
+    CloseHandle(static_cast<HANDLE>(file_));
+  }
+}
+
+void MappedFile::advise_sequential() const {
+  // FILE_FLAG_SEQUENTIAL_SCAN was already requested when opening
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    return;
+  }
+  opened_ = true;
+  size_ = static_cast<std::size_t>(info.st_size);
+  if (size_ > 0) {
+    void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      opened_ = false;
+      size_ = 0;
+    } else {
+      data_ = static_cast<const std::byte*>(addr);
+    }
+  }
+  // the mapping keeps the file contents alive after the descriptor closes
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<std::byte*>(data_), size_);
+  }
+}
+
+void MappedFile::advise_sequential() const {
+  if (data_ != nullptr) {
+    ::madvise(const_cast<std::byte*>(data_), size_, MADV_SEQUENTIAL);
+  }
+}
+#endif
+}  // namespace quest_helper
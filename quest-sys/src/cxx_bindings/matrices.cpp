@@ -2,7 +2,30 @@
 #include "matrices.hpp"
 #include "helper.hpp"
 
+#include <array>
+
 namespace quest_sys {
+namespace {
+using quest_helper::max_bulk_chunk;
+
+// Points a fixed-size row table into a flat row-major matrix
+template <std::size_t Dim>
+bool flat_rows(rust::Slice<const Quest_Complex> in,
+               std::array<qcomp*, Dim>& rows,
+               const char* caller) {
+  if (in.length() != Dim * Dim) {
+    ::invalidQuESTInputError(
+        "The number of elements does not match the matrix dimension.", caller);
+    return false;
+  }
+  qcomp* elems = Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(in));
+  for (std::size_t r = 0; r < Dim; ++r) {
+    rows[r] = elems + r * Dim;
+  }
+  return true;
+}
+}  // namespace
+
 std::unique_ptr<CompMatr1> getCompMatr1(
     rust::Slice<const rust::Slice<const Quest_Complex>> in) {
   std::vector<qcomp*> tmp{};
@@ -21,6 +44,24 @@ std::unique_ptr<CompMatr2> getCompMatr2(
   return std::make_unique<CompMatr2>(::getCompMatr2(tmp.data()));
 }
 
+std::unique_ptr<CompMatr1> getCompMatr1Flat(
+    rust::Slice<const Quest_Complex> in) {
+  std::array<qcomp*, 2> rows{};
+  if (!flat_rows(in, rows, __func__)) {
+    return nullptr;
+  }
+  return std::make_unique<CompMatr1>(::getCompMatr1(rows.data()));
+}
+
+std::unique_ptr<CompMatr2> getCompMatr2Flat(
+    rust::Slice<const Quest_Complex> in) {
+  std::array<qcomp*, 4> rows{};
+  if (!flat_rows(in, rows, __func__)) {
+    return nullptr;
+  }
+  return std::make_unique<CompMatr2>(::getCompMatr2(rows.data()));
+}
+
 std::unique_ptr<DiagMatr1> getDiagMatr1(rust::Slice<const Quest_Complex> in) {
   return std::make_unique<DiagMatr1>(::getDiagMatr1(
       Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(in))));
@@ -83,6 +124,24 @@ void setCompMatr(CompMatr& out,
   ::setCompMatr(out, tmp.data());
 }
 
+void setCompMatrFlat(CompMatr& out,
+                     rust::Slice<const Quest_Complex> in,
+                     Quest_Index dim) {
+  if (dim != out.numRows ||
+      static_cast<Quest_Index>(in.length()) != dim * dim) {
+    ::invalidQuESTInputError(
+        "The number of elements does not match the matrix dimension.",
+        __func__);
+    return;
+  }
+  // CompMatr keeps a flat row-major copy, which the sync pushes to the GPU
+  quest_helper::parallel_copy(
+      ::getQuESTEnv().isMultithreaded,
+      Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(in)),
+      out.cpuElemsFlat, dim * dim);
+  ::syncCompMatr(out);
+}
+
 void setDiagMatr(DiagMatr& out, rust::Slice<const Quest_Complex> in) {
   ::setDiagMatr(
       out, Quest_Complex::to_qcomp_ptr(const_cast<Quest_Complex*>(in.data())));
@@ -91,10 +150,30 @@ void setDiagMatr(DiagMatr& out, rust::Slice<const Quest_Complex> in) {
 void setFullStateDiagMatr(FullStateDiagMatr& out,
                           Quest_Index startInd,
                           rust::Slice<const Quest_Complex> in) {
-  ::setFullStateDiagMatr(
-      out, startInd,
-      Quest_Complex::to_qcomp_ptr(const_cast<Quest_Complex*>(in.data())),
-      static_cast<int>(in.length()));
+  const qcomp* elems =
+      Quest_Complex::to_qcomp_ptr(const_cast<Quest_Complex*>(in.data()));
+  auto numElems = static_cast<Quest_Index>(in.length());
+
+  if (out.isDistributed || out.isGpuAccelerated) {
+    // QuEST routes each chunk to the right node or device
+    for (Quest_Index done = 0; done < numElems; done += max_bulk_chunk) {
+      Quest_Index len = std::min(max_bulk_chunk, numElems - done);
+      ::setFullStateDiagMatr(out, startInd + done,
+                             const_cast<qcomp*>(elems + done), len);
+    }
+    return;
+  }
+
+  if (startInd < 0 || startInd + numElems > out.numElems) {
+    ::invalidQuESTInputError(
+        "The elements to set exceed the bounds of the FullStateDiagMatr.",
+        __func__);
+    return;
+  }
+  quest_helper::parallel_copy(out.isMultithreaded, elems,
+                              out.cpuElems + startInd, numElems);
+  // marks the matrix properties as unknown after the direct write
+  ::syncFullStateDiagMatr(out);
 }
 
 std::unique_ptr<FullStateDiagMatr> createFullStateDiagMatrFromPauliStrSum(
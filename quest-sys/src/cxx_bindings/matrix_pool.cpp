@@ -0,0 +1,207 @@
+#include "matrix_pool.hpp"
+
+namespace quest_sys {
+namespace {
+void destroy_matrix(CompMatr& matr) {
+  ::destroyCompMatr(matr);
+}
+
+void destroy_matrix(DiagMatr& matr) {
+  ::destroyDiagMatr(matr);
+}
+
+void destroy_matrix(FullStateDiagMatr& matr) {
+  ::destroyFullStateDiagMatr(matr);
+}
+
+// A create call QuEST rejected without exiting leaves no element storage
+bool has_elements(const CompMatr& matr) {
+  return matr.cpuElemsFlat != nullptr;
+}
+
+bool has_elements(const DiagMatr& matr) {
+  return matr.cpuElems != nullptr;
+}
+
+bool has_elements(const FullStateDiagMatr& matr) {
+  return matr.cpuElems != nullptr;
+}
+
+MatrixShelf<CompMatr>& shelf_for(MatrixPoolState& state, const CompMatr*) {
+  return state.compMatrices;
+}
+
+MatrixShelf<DiagMatr>& shelf_for(MatrixPoolState& state, const DiagMatr*) {
+  return state.diagMatrices;
+}
+
+MatrixShelf<FullStateDiagMatr>& shelf_for(MatrixPoolState& state,
+                                          const FullStateDiagMatr*) {
+  return state.fullStateMatrices;
+}
+
+// Reuses an idle matrix of the right width or allocates a new one. Null if
+// the width or the allocation is rejected, so a failed matrix never reaches
+// the shelf.
+template <typename Matr, typename Create>
+std::unique_ptr<PooledMatrix<Matr>> acquire(
+    const std::shared_ptr<MatrixPoolState>& state,
+    int numQubits,
+    Create&& create,
+    const char* caller) {
+  if (numQubits < 1) {
+    ::invalidQuESTInputError("A pooled matrix needs at least one qubit.",
+                             caller);
+    return nullptr;
+  }
+  Matr matr{};
+  bool reused = false;
+  {
+    std::lock_guard lock(state->mutex);
+    reused = shelf_for(*state, &matr).take(numQubits, matr);
+  }
+  if (!reused) {
+    matr = create(numQubits);
+    if (!has_elements(matr)) {
+      return nullptr;
+    }
+  }
+  return std::make_unique<PooledMatrix<Matr>>(state, matr);
+}
+}  // namespace
+
+template <typename Matr>
+bool MatrixShelf<Matr>::take(int numQubits, Matr& out) {
+  auto it = idle_.find(numQubits);
+  if (it == idle_.end() || it->second.empty()) {
+    return false;
+  }
+  out = it->second.back();
+  it->second.pop_back();
+  return true;
+}
+
+template <typename Matr>
+void MatrixShelf<Matr>::put(Matr matr) {
+  idle_[matr.numQubits].push_back(matr);
+}
+
+template <typename Matr>
+void MatrixShelf<Matr>::clear() {
+  for (auto& [numQubits, matrices] : idle_) {
+    for (auto& matr : matrices) {
+      destroy_matrix(matr);
+    }
+  }
+  idle_.clear();
+}
+
+template <typename Matr>
+std::size_t MatrixShelf<Matr>::size() const {
+  std::size_t total = 0;
+  for (const auto& [numQubits, matrices] : idle_) {
+    total += matrices.size();
+  }
+  return total;
+}
+
+template <typename Matr>
+PooledMatrix<Matr>::~PooledMatrix() {
+  std::lock_guard lock(state_->mutex);
+  shelf_for(*state_, &matr_).put(matr_);
+}
+
+template class MatrixShelf<CompMatr>;
+template class MatrixShelf<DiagMatr>;
+template class MatrixShelf<FullStateDiagMatr>;
+template class PooledMatrix<CompMatr>;
+template class PooledMatrix<DiagMatr>;
+template class PooledMatrix<FullStateDiagMatr>;
+
+std::unique_ptr<PooledCompMatr> MatrixPool::acquireCompMatr(int numQubits) {
+  return acquire<CompMatr>(state_, numQubits,
+                           [](int n) { return ::createCompMatr(n); },
+                           "acquireCompMatr");
+}
+
+std::unique_ptr<PooledDiagMatr> MatrixPool::acquireDiagMatr(int numQubits) {
+  return acquire<DiagMatr>(state_, numQubits,
+                           [](int n) { return ::createDiagMatr(n); },
+                           "acquireDiagMatr");
+}
+
+std::unique_ptr<PooledFullStateDiagMatr> MatrixPool::acquireFullStateDiagMatr(
+    int numQubits) {
+  return acquire<FullStateDiagMatr>(
+      state_, numQubits, [](int n) { return ::createFullStateDiagMatr(n); },
+      "acquireFullStateDiagMatr");
+}
+
+std::size_t MatrixPool::numIdle() const {
+  std::lock_guard lock(state_->mutex);
+  return state_->compMatrices.size() + state_->diagMatrices.size() +
+         state_->fullStateMatrices.size();
+}
+
+void MatrixPool::clear() {
+  std::lock_guard lock(state_->mutex);
+  state_->compMatrices.clear();
+  state_->diagMatrices.clear();
+  state_->fullStateMatrices.clear();
+}
+
+// Matrix pools
+std::unique_ptr<MatrixPool> createMatrixPool() {
+  return std::make_unique<MatrixPool>();
+}
+
+std::unique_ptr<PooledCompMatr> acquireCompMatr(MatrixPool& pool,
+                                                int numQubits) {
+  return pool.acquireCompMatr(numQubits);
+}
+
+std::unique_ptr<PooledDiagMatr> acquireDiagMatr(MatrixPool& pool,
+                                                int numQubits) {
+  return pool.acquireDiagMatr(numQubits);
+}
+
+std::unique_ptr<PooledFullStateDiagMatr> acquireFullStateDiagMatr(
+    MatrixPool& pool,
+    int numQubits) {
+  return pool.acquireFullStateDiagMatr(numQubits);
+}
+
+const CompMatr& getPooledCompMatr(const PooledCompMatr& handle) {
+  return handle.get();
+}
+
+CompMatr& getPooledCompMatrMut(PooledCompMatr& handle) {
+  return handle.get();
+}
+
+const DiagMatr& getPooledDiagMatr(const PooledDiagMatr& handle) {
+  return handle.get();
+}
+
+DiagMatr& getPooledDiagMatrMut(PooledDiagMatr& handle) {
+  return handle.get();
+}
+
+const FullStateDiagMatr& getPooledFullStateDiagMatr(
+    const PooledFullStateDiagMatr& handle) {
+  return handle.get();
+}
+
+FullStateDiagMatr& getPooledFullStateDiagMatrMut(
+    PooledFullStateDiagMatr& handle) {
+  return handle.get();
+}
+
+std::size_t getMatrixPoolNumIdle(const MatrixPool& pool) {
+  return pool.numIdle();
+}
+
+void clearMatrixPool(MatrixPool& pool) {
+  pool.clear();
+}
+}  // namespace quest_sys
@@ -0,0 +1,501 @@
+#include "noise.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quest_sys {
+namespace {
+using Matrix = std::vector<qcomp>;  // row-major, square
+
+// Pauli codes 0=I, 1=X, 2=Y, 3=Z
+std::array<qcomp, 4> pauli(int code) {
+  const qcomp i(0, 1);
+  switch (code) {
+    case 1:
+      return {0, 1, 1, 0};
+    case 2:
+      return {0, -i, i, 0};
+    case 3:
+      return {1, 0, 0, -1};
+    default:
+      return {1, 0, 0, 1};
+  }
+}
+
+// Appends coeff * (P_high (x) P_low), where P_low acts on operand 0
+void append_pauli(std::vector<qcomp>& kraus,
+                  qreal coeff,
+                  int low,
+                  int high = -1) {
+  auto a = pauli(low);
+  if (high < 0) {
+    for (auto elem : a) {
+      kraus.push_back(coeff * elem);
+    }
+    return;
+  }
+  auto b = pauli(high);
+  for (std::size_t r = 0; r < 4; ++r) {
+    for (std::size_t c = 0; c < 4; ++c) {
+      kraus.push_back(coeff * a[(r & 1) * 2 + (c & 1)] *
+                      b[(r >> 1) * 2 + (c >> 1)]);
+    }
+  }
+}
+
+// Returned by channel constructors that reject their input; addNoiseRule
+// refuses it like any other unknown channel
+constexpr std::uint32_t invalid_channel = 0xFFFFFFFFu;
+
+// Widest gate fused with its noise: a fused SuperOp holds 16^n elements, so
+// five qubits is already 16 MiB at double precision
+constexpr int max_fused_superop_qubits = 5;
+
+bool validate_prob(Quest_Real prob, const char* caller) {
+  if (!(prob >= 0 && prob <= 1)) {  // also rejects NaN
+    ::invalidQuESTInputError("Channel probabilities must lie in [0, 1].",
+                             caller);
+    return false;
+  }
+  return true;
+}
+
+NoiseChannel make_channel(ChannelKind kind,
+                          int numQubits,
+                          std::array<qreal, 3> params) {
+  NoiseChannel channel{kind, params, numQubits, 0, {}};
+  const qreal p = params[0];
+  auto& kraus = channel.kraus;
+  switch (kind) {
+    case ChannelKind::Dephasing:
+      append_pauli(kraus, std::sqrt(1 - p), 0);
+      append_pauli(kraus, std::sqrt(p), 3);
+      break;
+    case ChannelKind::Depolarising:
+      append_pauli(kraus, std::sqrt(1 - p), 0);
+      for (int code = 1; code < 4; ++code) {
+        append_pauli(kraus, std::sqrt(p / 3), code);
+      }
+      break;
+    case ChannelKind::Damping:
+      kraus = {1, 0, 0, std::sqrt(1 - p), 0, std::sqrt(p), 0, 0};
+      break;
+    case ChannelKind::Paulis:
+      append_pauli(kraus, std::sqrt(1 - params[0] - params[1] - params[2]), 0);
+      for (int code = 1; code < 4; ++code) {
+        append_pauli(kraus, std::sqrt(params[static_cast<std::size_t>(code - 1)]),
+                     code);
+      }
+      break;
+    case ChannelKind::TwoQubitDephasing:
+      append_pauli(kraus, std::sqrt(1 - p), 0, 0);
+      append_pauli(kraus, std::sqrt(p / 3), 3, 0);
+      append_pauli(kraus, std::sqrt(p / 3), 0, 3);
+      append_pauli(kraus, std::sqrt(p / 3), 3, 3);
+      break;
+    case ChannelKind::TwoQubitDepolarising:
+      append_pauli(kraus, std::sqrt(1 - p), 0, 0);
+      for (int code = 1; code < 16; ++code) {
+        append_pauli(kraus, std::sqrt(p / 15), code % 4, code / 4);
+      }
+      break;
+    case ChannelKind::Kraus:
+      break;
+  }
+  std::size_t dim = std::size_t{1} << numQubits;
+  channel.numOperators = static_cast<int>(kraus.size() / (dim * dim));
+  return channel;
+}
+
+// Lifts an operator on some of `numBits` operands to all of them
+Matrix embed(const qcomp* op, const std::vector<int>& positions, int numBits) {
+  std::size_t dim = std::size_t{1} << numBits;
+  std::size_t opDim = std::size_t{1} << positions.size();
+  std::size_t mask = 0;
+  for (int pos : positions) {
+    mask |= std::size_t{1} << pos;
+  }
+  auto gather = [&](std::size_t index) {
+    std::size_t out = 0;
+    for (std::size_t j = 0; j < positions.size(); ++j) {
+      out |= ((index >> positions[j]) & 1) << j;
+    }
+    return out;
+  };
+  Matrix out(dim * dim, qcomp(0, 0));
+  for (std::size_t r = 0; r < dim; ++r) {
+    for (std::size_t c = 0; c < dim; ++c) {
+      if ((r & ~mask) == (c & ~mask)) {
+        out[r * dim + c] = op[gather(r) * opDim + gather(c)];
+      }
+    }
+  }
+  return out;
+}
+
+Matrix multiply(const Matrix& a, const Matrix& b, std::size_t dim) {
+  Matrix out(dim * dim, qcomp(0, 0));
+  for (std::size_t r = 0; r < dim; ++r) {
+    for (std::size_t k = 0; k < dim; ++k) {
+      qcomp elem = a[r * dim + k];
+      if (elem == qcomp(0, 0)) {
+        continue;
+      }
+      for (std::size_t c = 0; c < dim; ++c) {
+        out[r * dim + c] += elem * b[k * dim + c];
+      }
+    }
+  }
+  return out;
+}
+
+// Adds conj(K) (x) K, QuEST's superoperator of rho -> K rho K^dagger
+void accumulate_superop(Matrix& superop, const Matrix& k, std::size_t dim) {
+  std::size_t superDim = dim * dim;
+  for (std::size_t r = 0; r < dim; ++r) {
+    for (std::size_t c = 0; c < dim; ++c) {
+      for (std::size_t r2 = 0; r2 < dim; ++r2) {
+        for (std::size_t c2 = 0; c2 < dim; ++c2) {
+          superop[(r + c * dim) * superDim + (r2 + c2 * dim)] +=
+              std::conj(k[c * dim + c2]) * k[r * dim + r2];
+        }
+      }
+    }
+  }
+}
+
+// Superoperator of an instruction followed by its channels, in rule order
+Matrix fused_superop(const CircuitTape& tape,
+                     const TapeInstruction& inst,
+                     const std::vector<ChannelTarget>& targets,
+                     const std::vector<NoiseChannel>& channels) {
+  auto numBits = static_cast<int>(inst.numQubits);
+  std::size_t dim = std::size_t{1} << numBits;
+  std::size_t superDim = dim * dim;
+
+  Matrix total(superDim * superDim, qcomp(0, 0));
+  accumulate_superop(
+      total, gateKindMatrix(inst.kind, inst.numQubits, tape.params(inst)), dim);
+
+  for (const auto& target : targets) {
+    const auto& channel = channels[target.channel];
+    std::size_t opDim = std::size_t{1} << channel.numQubits;
+    Matrix channelOp(superDim * superDim, qcomp(0, 0));
+    for (int k = 0; k < channel.numOperators; ++k) {
+      const qcomp* op =
+          channel.kraus.data() + static_cast<std::size_t>(k) * opDim * opDim;
+      accumulate_superop(channelOp, embed(op, target.operands, numBits), dim);
+    }
+    total = multiply(channelOp, total, superDim);
+  }
+  return total;
+}
+}  // namespace
+
+std::uint32_t NoiseModel::addChannel(NoiseChannel channel) {
+  channels_.push_back(std::move(channel));
+  return static_cast<std::uint32_t>(channels_.size() - 1);
+}
+
+void NoiseModel::addRule(NoiseRule rule) {
+  rules_.push_back(std::move(rule));
+}
+
+bool resolveNoiseRules(const NoiseModel& model,
+                       const CircuitTape& tape,
+                       const TapeInstruction& inst,
+                       std::vector<ChannelTarget>& out) {
+  out.clear();
+  const int* q = tape.qubits(inst);
+  auto numOperands = static_cast<int>(inst.numQubits);
+  for (const auto& rule : model.rules()) {
+    if (rule.kind != inst.kind) {
+      continue;
+    }
+    if (!rule.qubits.empty() &&
+        !std::equal(rule.qubits.begin(), rule.qubits.end(), q,
+                    q + numOperands)) {
+      continue;
+    }
+    const auto& channel = model.channels()[rule.channel];
+    if (channel.numQubits == numOperands) {
+      std::vector<int> all(static_cast<std::size_t>(numOperands));
+      for (int j = 0; j < numOperands; ++j) {
+        all[static_cast<std::size_t>(j)] = j;
+      }
+      out.push_back({rule.channel, std::move(all)});
+    } else if (channel.numQubits == 1) {
+      for (int j = 0; j < numOperands; ++j) {
+        out.push_back({rule.channel, {j}});
+      }
+    } else {
+      ::invalidQuESTInputError(
+          "A noise channel must act on one qubit or on all of a gate's "
+          "qubits.",
+          "compileNoisyCircuit");
+      return false;
+    }
+  }
+  return true;
+}
+
+NoisyCircuit::~NoisyCircuit() {
+  for (auto& map : krausMaps_) {
+    ::destroyKrausMap(map);
+  }
+  for (auto& op : superOps_) {
+    ::destroySuperOp(op);
+  }
+}
+
+void NoisyCircuit::apply(Qureg& qureg) const {
+  if (!qureg.isDensityMatrix) {
+    ::invalidQuESTInputError(
+        "Noisy circuits can only be applied to density matrices.",
+        "applyNoisyCircuit");
+    return;
+  }
+  if (maxQubit_ >= qureg.numQubits) {
+    ::invalidQuESTInputError(
+        "The noisy circuit targets qubits beyond the width of the Qureg.",
+        "applyNoisyCircuit");
+    return;
+  }
+  for (const auto& step : steps_) {
+    switch (step.kind) {
+      case StepKind::Gates:
+        gates_->applyRange(qureg, step.begin, step.end);
+        break;
+      case StepKind::SuperOp:
+        ::applySuperOp(qureg, const_cast<int*>(step.targets.data()),
+                       static_cast<int>(step.targets.size()),
+                       superOps_[step.begin]);
+        break;
+      case StepKind::Channel:
+        applyChannel(qureg, step);
+        break;
+    }
+  }
+}
+
+void NoisyCircuit::applyChannel(Qureg& qureg, const Step& step) const {
+  const auto& channel = channels_[step.begin];
+  const auto& p = channel.params;
+  const auto& t = step.targets;
+  switch (channel.kind) {
+    case ChannelKind::Dephasing:
+      ::mixDephasing(qureg, t[0], p[0]);
+      break;
+    case ChannelKind::Depolarising:
+      ::mixDepolarising(qureg, t[0], p[0]);
+      break;
+    case ChannelKind::Damping:
+      ::mixDamping(qureg, t[0], p[0]);
+      break;
+    case ChannelKind::Paulis:
+      ::mixPaulis(qureg, t[0], p[0], p[1], p[2]);
+      break;
+    case ChannelKind::TwoQubitDephasing:
+      ::mixTwoQubitDephasing(qureg, t[0], t[1], p[0]);
+      break;
+    case ChannelKind::TwoQubitDepolarising:
+      ::mixTwoQubitDepolarising(qureg, t[0], t[1], p[0]);
+      break;
+    case ChannelKind::Kraus:
+      ::mixKrausMap(qureg, const_cast<int*>(t.data()),
+                    static_cast<int>(t.size()), krausMaps_[step.end]);
+      break;
+  }
+}
+
+// Noise models
+std::unique_ptr<NoiseModel> createNoiseModel() {
+  return std::make_unique<NoiseModel>();
+}
+
+std::uint32_t addDephasingChannel(NoiseModel& model, Quest_Real prob) {
+  if (!validate_prob(prob, __func__)) {
+    return invalid_channel;
+  }
+  return model.addChannel(make_channel(ChannelKind::Dephasing, 1, {prob}));
+}
+
+std::uint32_t addDepolarisingChannel(NoiseModel& model, Quest_Real prob) {
+  if (!validate_prob(prob, __func__)) {
+    return invalid_channel;
+  }
+  return model.addChannel(make_channel(ChannelKind::Depolarising, 1, {prob}));
+}
+
+std::uint32_t addDampingChannel(NoiseModel& model, Quest_Real prob) {
+  if (!validate_prob(prob, __func__)) {
+    return invalid_channel;
+  }
+  return model.addChannel(make_channel(ChannelKind::Damping, 1, {prob}));
+}
+
+std::uint32_t addPauliChannel(NoiseModel& model,
+                              Quest_Real probX,
+                              Quest_Real probY,
+                              Quest_Real probZ) {
+  if (!validate_prob(probX, __func__) || !validate_prob(probY, __func__) ||
+      !validate_prob(probZ, __func__) ||
+      !validate_prob(probX + probY + probZ, __func__)) {
+    return invalid_channel;
+  }
+  return model.addChannel(
+      make_channel(ChannelKind::Paulis, 1, {probX, probY, probZ}));
+}
+
+std::uint32_t addTwoQubitDephasingChannel(NoiseModel& model, Quest_Real prob) {
+  if (!validate_prob(prob, __func__)) {
+    return invalid_channel;
+  }
+  return model.addChannel(
+      make_channel(ChannelKind::TwoQubitDephasing, 2, {prob}));
+}
+
+std::uint32_t addTwoQubitDepolarisingChannel(NoiseModel& model,
+                                             Quest_Real prob) {
+  if (!validate_prob(prob, __func__)) {
+    return invalid_channel;
+  }
+  return model.addChannel(
+      make_channel(ChannelKind::TwoQubitDepolarising, 2, {prob}));
+}
+
+std::uint32_t addKrausChannel(NoiseModel& model,
+                              int numQubits,
+                              int numOperators,
+                              rust::Slice<const Quest_Complex> matrices) {
+  if (numQubits < 1 || numQubits > 3 || numOperators < 1) {
+    ::invalidQuESTInputError(
+        "Kraus noise channels must act on one to three qubits.", __func__);
+    return invalid_channel;
+  }
+  auto dim = std::size_t{1} << numQubits;
+  if (matrices.length() != static_cast<std::size_t>(numOperators) * dim * dim) {
+    ::invalidQuESTInputError(
+        "The number of elements does not match the channel dimensions.",
+        __func__);
+    return invalid_channel;
+  }
+  NoiseChannel channel{ChannelKind::Kraus, {}, numQubits, numOperators, {}};
+  const qcomp* in =
+      Quest_Complex::to_qcomp_ptr(quest_helper::slice_to_ptr(matrices));
+  channel.kraus.assign(in, in + matrices.length());
+  return model.addChannel(std::move(channel));
+}
+
+void addNoiseRule(NoiseModel& model,
+                  std::uint32_t opcode,
+                  rust::Slice<const int> qubits,
+                  std::uint32_t channel) {
+  if (opcode >= static_cast<std::uint32_t>(GateKind::NumKinds)) {
+    ::invalidQuESTInputError("Unknown circuit tape opcode.", __func__);
+    return;
+  }
+  if (channel >= model.channels().size()) {
+    ::invalidQuESTInputError("Unknown noise channel.", __func__);
+    return;
+  }
+  model.addRule({static_cast<GateKind>(opcode),
+                 std::vector<int>(qubits.begin(), qubits.end()), channel});
+}
+
+std::unique_ptr<NoisyCircuit> compileNoisyCircuit(const CircuitTape& tape,
+                                                  const NoiseModel& model,
+                                                  int maxFusedQubits) {
+  if (maxFusedQubits < 0 || maxFusedQubits > max_fused_superop_qubits) {
+    ::invalidQuESTInputError(
+        "The fused gate width must be between 0 and 5 qubits.", __func__);
+    return nullptr;
+  }
+  auto circuit = std::make_unique<NoisyCircuit>();
+  circuit->channels_ = model.channels();
+  circuit->maxQubit_ = tape.maxQubit();
+
+  // Kraus channels not fused into a gate run through their own KrausMap
+  std::vector<std::int32_t> mapIndex(circuit->channels_.size(), -1);
+  auto kraus_map_for = [&](std::uint32_t ch) {
+    if (mapIndex[ch] < 0) {
+      const auto& channel = circuit->channels_[ch];
+      auto map = ::createKrausMap(channel.numQubits, channel.numOperators);
+      auto dim = static_cast<std::size_t>(map.numRows);
+      for (int k = 0; k < channel.numOperators; ++k) {
+        for (std::size_t r = 0; r < dim; ++r) {
+          std::copy_n(channel.kraus.data() +
+                          (static_cast<std::size_t>(k) * dim + r) * dim,
+                      dim, map.matrices[k][r]);
+        }
+      }
+      ::syncKrausMap(map);
+      mapIndex[ch] = static_cast<std::int32_t>(circuit->krausMaps_.size());
+      circuit->krausMaps_.push_back(map);
+    }
+    return static_cast<std::size_t>(mapIndex[ch]);
+  };
+
+  CircuitTapeBuilder builder;
+  std::size_t numGates = 0;
+  auto& steps = circuit->steps_;
+  std::vector<ChannelTarget> targets;
+
+  for (const auto& inst : tape.instructions()) {
+    if (!resolveNoiseRules(model, tape, inst, targets)) {
+      return nullptr;
+    }
+    const int* q = tape.qubits(inst);
+
+    bool fuse = !targets.empty() &&
+                static_cast<int>(inst.numQubits) <= maxFusedQubits &&
+                isInstructionFusible(tape, inst);
+    if (fuse) {
+      auto superop =
+          fused_superop(tape, inst, targets, circuit->channels_);
+      auto op = ::createSuperOp(static_cast<int>(inst.numQubits));
+      std::copy(superop.begin(), superop.end(), op.cpuElemsFlat);
+      ::syncSuperOp(op);
+      steps.push_back({NoisyCircuit::StepKind::SuperOp,
+                       circuit->superOps_.size(), 0,
+                       std::vector<int>(q, q + inst.numQubits)});
+      circuit->superOps_.push_back(op);
+      continue;
+    }
+
+    builder.copy(tape, inst);
+    if (!steps.empty() && steps.back().kind == NoisyCircuit::StepKind::Gates &&
+        steps.back().end == numGates) {
+      ++steps.back().end;
+    } else {
+      steps.push_back(
+          {NoisyCircuit::StepKind::Gates, numGates, numGates + 1, {}});
+    }
+    ++numGates;
+
+    for (const auto& target : targets) {
+      std::vector<int> qubits;
+      for (int pos : target.operands) {
+        qubits.push_back(q[pos]);
+      }
+      bool isKraus =
+          circuit->channels_[target.channel].kind == ChannelKind::Kraus;
+      steps.push_back({NoisyCircuit::StepKind::Channel, target.channel,
+                       isKraus ? kraus_map_for(target.channel) : 0,
+                       std::move(qubits)});
+    }
+  }
+
+  circuit->gates_ = builder.build();
+  return circuit;
+}
+
+void applyNoisyCircuit(Qureg& qureg, const NoisyCircuit& circuit) {
+  circuit.apply(qureg);
+}
+
+std::size_t getNoisyCircuitNumSuperOps(const NoisyCircuit& circuit) {
+  return circuit.numSuperOps();
+}
+}  // namespace quest_sys
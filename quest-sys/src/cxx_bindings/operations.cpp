@@ -4,14 +4,17 @@
 
 #include "operations.hpp"
 #include "helper.hpp"
+#include "profiling.hpp"
 
 namespace quest_sys {
 // CompMatr1 operations
 void multiplyCompMatr1(Qureg& qureg, int target, const CompMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyCompMatr1(qureg, target, matr);
 }
 
 void applyCompMatr1(Qureg& qureg, int target, const CompMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyCompMatr1(qureg, target, matr);
 }
 
@@ -19,6 +22,7 @@ void applyControlledCompMatr1(Qureg& qureg,
                               int control,
                               int target,
                               const CompMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledCompMatr1(qureg, control, target, matr);
 }
 
@@ -26,6 +30,7 @@ void applyMultiControlledCompMatr1(Qureg& qureg,
                                    rust::Slice<const int> controls,
                                    int target,
                                    const CompMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledCompMatr1(qureg, quest_helper::slice_to_ptr(controls),
                                   static_cast<int>(controls.length()), target,
                                   matr);
@@ -36,6 +41,7 @@ void applyMultiStateControlledCompMatr1(Qureg& qureg,
                                         rust::Slice<const int> states,
                                         int target,
                                         const CompMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledCompMatr1(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -47,6 +53,7 @@ void multiplyCompMatr2(Qureg& qureg,
                        int target1,
                        int target2,
                        const CompMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyCompMatr2(qureg, target1, target2, matr);
 }
 
@@ -54,6 +61,7 @@ void applyCompMatr2(Qureg& qureg,
                     int target1,
                     int target2,
                     const CompMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyCompMatr2(qureg, target1, target2, matr);
 }
 
@@ -62,6 +70,7 @@ void applyControlledCompMatr2(Qureg& qureg,
                               int target1,
                               int target2,
                               const CompMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledCompMatr2(qureg, control, target1, target2, matr);
 }
 
@@ -71,6 +80,7 @@ void applyMultiControlledCompMatr2(Qureg& qureg,
                                    int target1,
                                    int target2,
                                    const CompMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledCompMatr2(qureg, quest_helper::slice_to_ptr(controls),
                                   numControls, target1, target2, matr);
 }
@@ -81,6 +91,7 @@ void applyMultiStateControlledCompMatr2(Qureg& qureg,
                                         int target1,
                                         int target2,
                                         const CompMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledCompMatr2(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -91,6 +102,7 @@ void applyMultiStateControlledCompMatr2(Qureg& qureg,
 void multiplyCompMatr(Qureg& qureg,
                       rust::Slice<const int> targets,
                       const CompMatr& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyCompMatr(qureg, quest_helper::slice_to_ptr(targets),
                      static_cast<int>(targets.length()), matr);
 }
@@ -98,6 +110,7 @@ void multiplyCompMatr(Qureg& qureg,
 void applyCompMatr(Qureg& qureg,
                    rust::Slice<const int> targets,
                    const CompMatr& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyCompMatr(qureg, quest_helper::slice_to_ptr(targets),
                   static_cast<int>(targets.length()), matr);
 }
@@ -106,6 +119,7 @@ void applyControlledCompMatr(Qureg& qureg,
                              int control,
                              rust::Slice<const int> targets,
                              const CompMatr& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledCompMatr(qureg, control, quest_helper::slice_to_ptr(targets),
                             static_cast<int>(targets.length()), matr);
 }
@@ -114,6 +128,7 @@ void applyMultiControlledCompMatr(Qureg& qureg,
                                   rust::Slice<const int> controls,
                                   rust::Slice<const int> targets,
                                   const CompMatr& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledCompMatr(qureg, quest_helper::slice_to_ptr(controls),
                                  static_cast<int>(controls.length()),
                                  quest_helper::slice_to_ptr(targets),
@@ -125,6 +140,7 @@ void applyMultiStateControlledCompMatr(Qureg& qureg,
                                        rust::Slice<const int> states,
                                        rust::Slice<const int> targets,
                                        const CompMatr& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledCompMatr(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -134,16 +150,19 @@ void applyMultiStateControlledCompMatr(Qureg& qureg,
 
 // S gate operations
 void applyS(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyS(qureg, target);
 }
 
 void applyControlledS(Qureg& qureg, int control, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledS(qureg, control, target);
 }
 
 void applyMultiControlledS(Qureg& qureg,
                            rust::Slice<const int> controls,
                            int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledS(qureg, quest_helper::slice_to_ptr(controls),
                           static_cast<int>(controls.length()), target);
 }
@@ -152,6 +171,7 @@ void applyMultiStateControlledS(Qureg& qureg,
                                 rust::Slice<const int> controls,
                                 rust::Slice<const int> states,
                                 int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledS(qureg, quest_helper::slice_to_ptr(controls),
                                quest_helper::slice_to_ptr(states),
                                static_cast<int>(controls.length()), target);
@@ -159,16 +179,19 @@ void applyMultiStateControlledS(Qureg& qureg,
 
 // T gate operations
 void applyT(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyT(qureg, target);
 }
 
 void applyControlledT(Qureg& qureg, int control, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledT(qureg, control, target);
 }
 
 void applyMultiControlledT(Qureg& qureg,
                            rust::Slice<const int> controls,
                            int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledT(qureg, quest_helper::slice_to_ptr(controls),
                           static_cast<int>(controls.length()), target);
 }
@@ -177,6 +200,7 @@ void applyMultiStateControlledT(Qureg& qureg,
                                 rust::Slice<const int> controls,
                                 rust::Slice<const int> states,
                                 int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledT(qureg, quest_helper::slice_to_ptr(controls),
                                quest_helper::slice_to_ptr(states),
                                static_cast<int>(controls.length()), target);
@@ -184,16 +208,19 @@ void applyMultiStateControlledT(Qureg& qureg,
 
 // Hadamard operations
 void applyHadamard(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyHadamard(qureg, target);
 }
 
 void applyControlledHadamard(Qureg& qureg, int control, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledHadamard(qureg, control, target);
 }
 
 void applyMultiControlledHadamard(Qureg& qureg,
                                   rust::Slice<const int> controls,
                                   int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledHadamard(qureg, quest_helper::slice_to_ptr(controls),
                                  static_cast<int>(controls.length()), target);
 }
@@ -202,6 +229,7 @@ void applyMultiStateControlledHadamard(Qureg& qureg,
                                        rust::Slice<const int> controls,
                                        rust::Slice<const int> states,
                                        int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledHadamard(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -210,14 +238,17 @@ void applyMultiStateControlledHadamard(Qureg& qureg,
 
 // Swap operations
 void multiplySwap(Qureg& qureg, int qubit1, int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplySwap(qureg, qubit1, qubit2);
 }
 
 void applySwap(Qureg& qureg, int qubit1, int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applySwap(qureg, qubit1, qubit2);
 }
 
 void applyControlledSwap(Qureg& qureg, int control, int qubit1, int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledSwap(qureg, control, qubit1, qubit2);
 }
 
@@ -225,6 +256,7 @@ void applyMultiControlledSwap(Qureg& qureg,
                               rust::Slice<const int> controls,
                               int qubit1,
                               int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledSwap(qureg, quest_helper::slice_to_ptr(controls),
                              static_cast<int>(controls.length()), qubit1,
                              qubit2);
@@ -235,6 +267,7 @@ void applyMultiStateControlledSwap(Qureg& qureg,
                                    rust::Slice<const int> states,
                                    int qubit1,
                                    int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledSwap(qureg, quest_helper::slice_to_ptr(controls),
                                   quest_helper::slice_to_ptr(states),
                                   static_cast<int>(controls.length()), qubit1,
@@ -243,6 +276,7 @@ void applyMultiStateControlledSwap(Qureg& qureg,
 
 // Sqrt-swap operations
 void applySqrtSwap(Qureg& qureg, int qubit1, int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applySqrtSwap(qureg, qubit1, qubit2);
 }
 
@@ -250,6 +284,7 @@ void applyControlledSqrtSwap(Qureg& qureg,
                              int control,
                              int qubit1,
                              int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledSqrtSwap(qureg, control, qubit1, qubit2);
 }
 
@@ -257,6 +292,7 @@ void applyMultiControlledSqrtSwap(Qureg& qureg,
                                   rust::Slice<const int> controls,
                                   int qubit1,
                                   int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledSqrtSwap(qureg, quest_helper::slice_to_ptr(controls),
                                  static_cast<int>(controls.length()), qubit1,
                                  qubit2);
@@ -267,6 +303,7 @@ void applyMultiStateControlledSqrtSwap(Qureg& qureg,
                                        rust::Slice<const int> states,
                                        int qubit1,
                                        int qubit2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledSqrtSwap(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -275,44 +312,54 @@ void applyMultiStateControlledSqrtSwap(Qureg& qureg,
 
 // Individual Pauli operations
 void multiplyPauliX(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyPauliX(qureg, target);
 }
 
 void multiplyPauliY(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyPauliY(qureg, target);
 }
 
 void multiplyPauliZ(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyPauliZ(qureg, target);
 }
 
 void applyPauliX(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyPauliX(qureg, target);
 }
 
 void applyPauliY(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyPauliY(qureg, target);
 }
 
 void applyPauliZ(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyPauliZ(qureg, target);
 }
 
 void applyControlledPauliX(Qureg& qureg, int control, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledPauliX(qureg, control, target);
 }
 
 void applyControlledPauliY(Qureg& qureg, int control, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledPauliY(qureg, control, target);
 }
 
 void applyControlledPauliZ(Qureg& qureg, int control, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledPauliZ(qureg, control, target);
 }
 
 void applyMultiControlledPauliX(Qureg& qureg,
                                 rust::Slice<const int> controls,
                                 int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledPauliX(qureg, quest_helper::slice_to_ptr(controls),
                                static_cast<int>(controls.length()), target);
 }
@@ -320,6 +367,7 @@ void applyMultiControlledPauliX(Qureg& qureg,
 void applyMultiControlledPauliY(Qureg& qureg,
                                 rust::Slice<const int> controls,
                                 int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledPauliY(qureg, quest_helper::slice_to_ptr(controls),
                                static_cast<int>(controls.length()), target);
 }
@@ -327,6 +375,7 @@ void applyMultiControlledPauliY(Qureg& qureg,
 void applyMultiControlledPauliZ(Qureg& qureg,
                                 rust::Slice<const int> controls,
                                 int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledPauliZ(qureg, quest_helper::slice_to_ptr(controls),
                                static_cast<int>(controls.length()), target);
 }
@@ -335,6 +384,7 @@ void applyMultiStateControlledPauliX(Qureg& qureg,
                                      rust::Slice<const int> controls,
                                      rust::Slice<const int> states,
                                      int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledPauliX(qureg, quest_helper::slice_to_ptr(controls),
                                     quest_helper::slice_to_ptr(states),
                                     static_cast<int>(controls.length()),
@@ -344,6 +394,7 @@ void applyMultiStateControlledPauliY(Qureg& qureg,
                                      rust::Slice<const int> controls,
                                      rust::Slice<const int> states,
                                      int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledPauliY(qureg, quest_helper::slice_to_ptr(controls),
                                     quest_helper::slice_to_ptr(states),
                                     static_cast<int>(controls.length()),
@@ -353,6 +404,7 @@ void applyMultiStateControlledPauliZ(Qureg& qureg,
                                      rust::Slice<const int> controls,
                                      rust::Slice<const int> states,
                                      int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledPauliZ(qureg, quest_helper::slice_to_ptr(controls),
                                     quest_helper::slice_to_ptr(states),
                                     static_cast<int>(controls.length()),
@@ -361,14 +413,17 @@ void applyMultiStateControlledPauliZ(Qureg& qureg,
 
 // Rotation operations
 void applyRotateX(Qureg& qureg, int target, Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyRotateX(qureg, target, angle);
 }
 
 void applyRotateY(Qureg& qureg, int target, Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyRotateY(qureg, target, angle);
 }
 
 void applyRotateZ(Qureg& qureg, int target, Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyRotateZ(qureg, target, angle);
 }
 
@@ -376,6 +431,7 @@ void applyControlledRotateX(Qureg& qureg,
                             int control,
                             int target,
                             Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledRotateX(qureg, control, target, angle);
 }
 
@@ -383,6 +439,7 @@ void applyControlledRotateY(Qureg& qureg,
                             int control,
                             int target,
                             Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledRotateY(qureg, control, target, angle);
 }
 
@@ -390,6 +447,7 @@ void applyControlledRotateZ(Qureg& qureg,
                             int control,
                             int target,
                             Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledRotateZ(qureg, control, target, angle);
 }
 
@@ -397,6 +455,7 @@ void applyMultiControlledRotateX(Qureg& qureg,
                                  rust::Slice<const int> controls,
                                  int target,
                                  Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledRotateX(qureg, quest_helper::slice_to_ptr(controls),
                                 static_cast<int>(controls.length()), target,
                                 angle);
@@ -406,6 +465,7 @@ void applyMultiControlledRotateY(Qureg& qureg,
                                  rust::Slice<const int> controls,
                                  int target,
                                  Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledRotateY(qureg, quest_helper::slice_to_ptr(controls),
                                 static_cast<int>(controls.length()), target,
                                 angle);
@@ -415,6 +475,7 @@ void applyMultiControlledRotateZ(Qureg& qureg,
                                  rust::Slice<const int> controls,
                                  int target,
                                  Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledRotateZ(qureg, quest_helper::slice_to_ptr(controls),
                                 static_cast<int>(controls.length()), target,
                                 angle);
@@ -425,6 +486,7 @@ void applyMultiStateControlledRotateX(Qureg& qureg,
                                       rust::Slice<const int> states,
                                       int target,
                                       Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledRotateX(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -435,6 +497,7 @@ void applyMultiStateControlledRotateY(Qureg& qureg,
                                       rust::Slice<const int> states,
                                       int target,
                                       Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledRotateY(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -445,6 +508,7 @@ void applyMultiStateControlledRotateZ(Qureg& qureg,
                                       rust::Slice<const int> states,
                                       int target,
                                       Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledRotateZ(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -458,6 +522,7 @@ void applyRotateAroundAxis(Qureg& qureg,
                            Quest_Real axisX,
                            Quest_Real axisY,
                            Quest_Real axisZ) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyRotateAroundAxis(qureg, targ, angle, axisX, axisY, axisZ);
 }
 
@@ -468,6 +533,7 @@ void applyControlledRotateAroundAxis(Qureg& qureg,
                                      Quest_Real axisX,
                                      Quest_Real axisY,
                                      Quest_Real axisZ) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledRotateAroundAxis(qureg, ctrl, targ, angle, axisX, axisY,
                                     axisZ);
 }
@@ -479,6 +545,7 @@ void applyMultiControlledRotateAroundAxis(Qureg& qureg,
                                           Quest_Real axisX,
                                           Quest_Real axisY,
                                           Quest_Real axisZ) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledRotateAroundAxis(
       qureg, quest_helper::slice_to_ptr(ctrls),
       static_cast<int>(ctrls.length()), targ, angle, axisX, axisY, axisZ);
@@ -492,6 +559,7 @@ void applyMultiStateControlledRotateAroundAxis(Qureg& qureg,
                                                Quest_Real axisX,
                                                Quest_Real axisY,
                                                Quest_Real axisZ) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledRotateAroundAxis(
       qureg, quest_helper::slice_to_ptr(ctrls),
       quest_helper::slice_to_ptr(states), static_cast<int>(ctrls.length()),
@@ -500,14 +568,17 @@ void applyMultiStateControlledRotateAroundAxis(Qureg& qureg,
 
 // Phase operations
 void applyPhaseFlip(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyPhaseFlip(qureg, target);
 }
 
 void applyPhaseShift(Qureg& qureg, int target, Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyPhaseShift(qureg, target, angle);
 }
 
 void applyTwoQubitPhaseFlip(Qureg& qureg, int target1, int target2) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyTwoQubitPhaseFlip(qureg, target1, target2);
 }
 
@@ -515,10 +586,12 @@ void applyTwoQubitPhaseShift(Qureg& qureg,
                              int target1,
                              int target2,
                              Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyTwoQubitPhaseShift(qureg, target1, target2, angle);
 }
 
 void applyMultiQubitPhaseFlip(Qureg& qureg, rust::Slice<const int> targets) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiQubitPhaseFlip(qureg, quest_helper::slice_to_ptr(targets),
                              static_cast<int>(targets.length()));
 }
@@ -526,17 +599,20 @@ void applyMultiQubitPhaseFlip(Qureg& qureg, rust::Slice<const int> targets) {
 void applyMultiQubitPhaseShift(Qureg& qureg,
                                rust::Slice<const int> targets,
                                Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiQubitPhaseShift(qureg, quest_helper::slice_to_ptr(targets),
                               static_cast<int>(targets.length()), angle);
 }
 
 /// many-qubit CNOTs (aliases for X)
 void multiplyMultiQubitNot(Qureg& qureg, rust::Slice<const int> targets) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyMultiQubitNot(qureg, quest_helper::slice_to_ptr(targets),
                           static_cast<int>(targets.length()));
 }
 
 void applyMultiQubitNot(Qureg& qureg, rust::Slice<const int> targets) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiQubitNot(qureg, quest_helper::slice_to_ptr(targets),
                        static_cast<int>(targets.length()));
 }
@@ -544,6 +620,7 @@ void applyMultiQubitNot(Qureg& qureg, rust::Slice<const int> targets) {
 void applyControlledMultiQubitNot(Qureg& qureg,
                                   int control,
                                   rust::Slice<const int> targets) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledMultiQubitNot(qureg, control,
                                  quest_helper::slice_to_ptr(targets),
                                  static_cast<int>(targets.length()));
@@ -553,6 +630,7 @@ void applyMultiControlledMultiQubitNot(Qureg& qureg,
                                        rust::Slice<const int> controls,
                                        int numControls,
                                        rust::Slice<const int> targets) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledMultiQubitNot(
       qureg, quest_helper::slice_to_ptr(controls), numControls,
       quest_helper::slice_to_ptr(targets), static_cast<int>(targets.length()));
@@ -562,6 +640,7 @@ void applyMultiStateControlledMultiQubitNot(Qureg& qureg,
                                             rust::Slice<const int> controls,
                                             rust::Slice<const int> states,
                                             rust::Slice<const int> targets) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledMultiQubitNot(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -572,31 +651,37 @@ void applyMultiStateControlledMultiQubitNot(Qureg& qureg,
 void applySuperOp(Qureg& qureg,
                   rust::Slice<const int> targets,
                   const SuperOp& superop) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applySuperOp(qureg, quest_helper::slice_to_ptr(targets),
                  static_cast<int>(targets.length()), superop);
 }
 
 // Measurement operations
 int applyQubitMeasurement(Qureg& qureg, int target) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::applyQubitMeasurement(qureg, target);
 }
 
 int applyQubitMeasurementAndGetProb(Qureg& qureg,
                                     int target,
                                     Quest_Real* probability) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::applyQubitMeasurementAndGetProb(qureg, target, probability);
 }
 
 Quest_Real applyForcedQubitMeasurement(Qureg& qureg, int target, int outcome) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::applyForcedQubitMeasurement(qureg, target, outcome);
 }
 
 void applyQubitProjector(Qureg& qureg, int target, int outcome) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyQubitProjector(qureg, target, outcome);
 }
 
 Quest_Index applyMultiQubitMeasurement(Qureg& qureg,
                                        rust::Slice<const int> qubits) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::applyMultiQubitMeasurement(qureg, quest_helper::slice_to_ptr(qubits),
                                       static_cast<int>(qubits.length()));
 }
@@ -604,6 +689,7 @@ Quest_Index applyMultiQubitMeasurement(Qureg& qureg,
 Quest_Index applyMultiQubitMeasurementAndGetProb(Qureg& qureg,
                                                  rust::Slice<const int> qubits,
                                                  Quest_Real* probability) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::applyMultiQubitMeasurementAndGetProb(
       qureg, quest_helper::slice_to_ptr(qubits),
       static_cast<int>(qubits.length()), probability);
@@ -612,6 +698,7 @@ Quest_Index applyMultiQubitMeasurementAndGetProb(Qureg& qureg,
 Quest_Real applyForcedMultiQubitMeasurement(Qureg& qureg,
                                             rust::Slice<const int> qubits,
                                             rust::Slice<const int> outcomes) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   return ::applyForcedMultiQubitMeasurement(
       qureg, quest_helper::slice_to_ptr(qubits),
       quest_helper::slice_to_ptr(outcomes), static_cast<int>(qubits.length()));
@@ -620,6 +707,7 @@ Quest_Real applyForcedMultiQubitMeasurement(Qureg& qureg,
 void applyMultiQubitProjector(Qureg& qureg,
                               rust::Slice<const int> qubits,
                               rust::Slice<const int> outcomes) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiQubitProjector(qureg, quest_helper::slice_to_ptr(qubits),
                              quest_helper::slice_to_ptr(outcomes),
                              static_cast<int>(qubits.length()));
@@ -629,24 +717,29 @@ void applyMultiQubitProjector(Qureg& qureg,
 void applyQuantumFourierTransform(Qureg& qureg,
                                   rust::Slice<const int> targets,
                                   int numTargets) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyQuantumFourierTransform(qureg, quest_helper::slice_to_ptr(targets),
                                  numTargets);
 }
 
 void applyFullQuantumFourierTransform(Qureg& qureg) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyFullQuantumFourierTransform(qureg);
 }
 
 // Pauli string operations
 void multiplyPauliStr(Qureg& qureg, const PauliStr& str) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyPauliStr(qureg, str);
 }
 
 void applyPauliStr(Qureg& qureg, const PauliStr& str) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyPauliStr(qureg, str);
 }
 
 void applyControlledPauliStr(Qureg& qureg, int control, const PauliStr& str) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledPauliStr(qureg, control, str);
 }
 
@@ -654,6 +747,7 @@ void applyMultiControlledPauliStr(Qureg& qureg,
                                   rust::Slice<const int> controls,
                                   int numControls,
                                   const PauliStr& str) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledPauliStr(qureg, quest_helper::slice_to_ptr(controls),
                                  numControls, str);
 }
@@ -662,6 +756,7 @@ void applyMultiStateControlledPauliStr(Qureg& qureg,
                                        rust::Slice<const int> controls,
                                        rust::Slice<const int> states,
                                        const PauliStr& str) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledPauliStr(qureg,
                                       quest_helper::slice_to_ptr(controls),
                                       quest_helper::slice_to_ptr(states),
@@ -670,10 +765,12 @@ void applyMultiStateControlledPauliStr(Qureg& qureg,
 
 // Pauli gadget operations
 void multiplyPauliGadget(Qureg& qureg, const PauliStr& str, Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyPauliGadget(qureg, str, angle);
 }
 
 void applyPauliGadget(Qureg& qureg, const PauliStr& str, Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyPauliGadget(qureg, str, angle);
 }
 
@@ -681,6 +778,7 @@ void applyControlledPauliGadget(Qureg& qureg,
                                 int control,
                                 const PauliStr& str,
                                 Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledPauliGadget(qureg, control, str, angle);
 }
 
@@ -688,6 +786,7 @@ void applyMultiControlledPauliGadget(Qureg& qureg,
                                      rust::Slice<const int> controls,
                                      const PauliStr& str,
                                      Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledPauliGadget(qureg, quest_helper::slice_to_ptr(controls),
                                     static_cast<int>(controls.length()), str,
                                     angle);
@@ -698,6 +797,7 @@ void applyMultiStateControlledPauliGadget(Qureg& qureg,
                                           rust::Slice<const int> states,
                                           const PauliStr& str,
                                           Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledPauliGadget(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -708,6 +808,7 @@ void applyMultiStateControlledPauliGadget(Qureg& qureg,
 void multiplyPhaseGadget(Qureg& qureg,
                          rust::Slice<const int> targets,
                          Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyPhaseGadget(qureg, quest_helper::slice_to_ptr(targets),
                         static_cast<int>(targets.length()), angle);
 }
@@ -715,6 +816,7 @@ void multiplyPhaseGadget(Qureg& qureg,
 void applyPhaseGadget(Qureg& qureg,
                       rust::Slice<const int> targets,
                       Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyPhaseGadget(qureg, quest_helper::slice_to_ptr(targets),
                      static_cast<int>(targets.length()), angle);
 }
@@ -723,6 +825,7 @@ void applyControlledPhaseGadget(Qureg& qureg,
                                 int control,
                                 rust::Slice<const int> targets,
                                 Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledPhaseGadget(qureg, control,
                                quest_helper::slice_to_ptr(targets),
                                static_cast<int>(targets.length()), angle);
@@ -732,6 +835,7 @@ void applyMultiControlledPhaseGadget(Qureg& qureg,
                                      rust::Slice<const int> controls,
                                      rust::Slice<const int> targets,
                                      Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledPhaseGadget(qureg, quest_helper::slice_to_ptr(controls),
                                     static_cast<int>(controls.length()),
                                     quest_helper::slice_to_ptr(targets),
@@ -743,6 +847,7 @@ void applyMultiStateControlledPhaseGadget(Qureg& qureg,
                                           rust::Slice<const int> states,
                                           rust::Slice<const int> targets,
                                           Quest_Real angle) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledPhaseGadget(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -754,6 +859,7 @@ void applyMultiStateControlledPhaseGadget(Qureg& qureg,
 void multiplyPauliStrSum(Qureg& qureg,
                          const PauliStrSum& sum,
                          Qureg& workspace) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyPauliStrSum(qureg, sum, workspace);
 }
 
@@ -762,49 +868,59 @@ void applyTrotterizedPauliStrSumGadget(Qureg& qureg,
                                        Quest_Real angle,
                                        int order,
                                        int reps) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyTrotterizedPauliStrSumGadget(qureg, sum, angle, order, reps);
 }
 
 // Additional Pauli functions for Rust API convenience
 std::unique_ptr<PauliStr> getPauliStr(rust::String paulis,
                                       rust::Slice<const int> indices) {
+  QUEST_SYS_PROFILE(0);
   return std::make_unique<PauliStr>(
       ::getPauliStr(paulis.c_str(), quest_helper::slice_to_ptr(indices),
                     static_cast<int>(indices.length())));
 }
 
 std::unique_ptr<PauliStrSum> createInlinePauliStrSum(rust::String str) {
+  QUEST_SYS_PROFILE(0);
   return std::make_unique<PauliStrSum>(::createInlinePauliStrSum(str.c_str()));
 }
 
 std::unique_ptr<PauliStrSum> createPauliStrSumFromFile(rust::String fn) {
+  QUEST_SYS_PROFILE(0);
   return std::make_unique<PauliStrSum>(::createPauliStrSumFromFile(fn.c_str()));
 }
 
 std::unique_ptr<PauliStrSum> createPauliStrSumFromReversedFile(
     rust::String fn) {
+  QUEST_SYS_PROFILE(0);
   return std::make_unique<PauliStrSum>(
       ::createPauliStrSumFromReversedFile(fn.c_str()));
 }
 
 void destroyPauliStrSum(PauliStrSum& sum) {
+  QUEST_SYS_PROFILE(0);
   ::destroyPauliStrSum(sum);
 }
 
 void reportPauliStr(PauliStr& str) {
+  QUEST_SYS_PROFILE(0);
   ::reportPauliStr(str);
 }
 
 void reportPauliStrSum(PauliStrSum& str) {
+  QUEST_SYS_PROFILE(0);
   ::reportPauliStrSum(str);
 }
 
 /// DiagMatr1
 void multiplyDiagMatr1(Qureg& qureg, int target, const DiagMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyDiagMatr1(qureg, target, matr);
 }
 
 void applyDiagMatr1(Qureg& qureg, int target, const DiagMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyDiagMatr1(qureg, target, matr);
 }
 
@@ -812,6 +928,7 @@ void applyControlledDiagMatr1(Qureg& qureg,
                               int control,
                               int target,
                               const DiagMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledDiagMatr1(qureg, control, target, matr);
 }
 
@@ -819,6 +936,7 @@ void applyMultiControlledDiagMatr1(Qureg& qureg,
                                    rust::Slice<const int> controls,
                                    int target,
                                    const DiagMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledDiagMatr1(qureg, quest_helper::slice_to_ptr(controls),
                                   static_cast<int>(controls.length()), target,
                                   matr);
@@ -829,6 +947,7 @@ void applyMultiStateControlledDiagMatr1(Qureg& qureg,
                                         rust::Slice<const int> states,
                                         int target,
                                         const DiagMatr1& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledDiagMatr1(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -840,6 +959,7 @@ void multiplyDiagMatr2(Qureg& qureg,
                        int target1,
                        int target2,
                        const DiagMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyDiagMatr2(qureg, target1, target2, matr);
 }
 
@@ -847,6 +967,7 @@ void applyDiagMatr2(Qureg& qureg,
                     int target1,
                     int target2,
                     const DiagMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyDiagMatr2(qureg, target1, target2, matr);
 }
 
@@ -855,6 +976,7 @@ void applyControlledDiagMatr2(Qureg& qureg,
                               int target1,
                               int target2,
                               const DiagMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledDiagMatr2(qureg, control, target1, target2, matr);
 }
 
@@ -863,6 +985,7 @@ void applyMultiControlledDiagMatr2(Qureg& qureg,
                                    int target1,
                                    int target2,
                                    const DiagMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledDiagMatr2(qureg, quest_helper::slice_to_ptr(controls),
                                   static_cast<int>(controls.length()), target1,
                                   target2, matr);
@@ -874,6 +997,7 @@ void applyMultiStateControlledDiagMatr2(Qureg& qureg,
                                         int target1,
                                         int target2,
                                         const DiagMatr2& matr) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledDiagMatr2(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -884,6 +1008,7 @@ void applyMultiStateControlledDiagMatr2(Qureg& qureg,
 void multiplyDiagMatr(Qureg& qureg,
                       rust::Slice<const int> targets,
                       const DiagMatr& matrix) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyDiagMatr(qureg, quest_helper::slice_to_ptr(targets),
                      static_cast<int>(targets.length()), matrix);
 }
@@ -891,6 +1016,7 @@ void multiplyDiagMatr(Qureg& qureg,
 void applyDiagMatr(Qureg& qureg,
                    rust::Slice<const int> targets,
                    const DiagMatr& matrix) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyDiagMatr(qureg, quest_helper::slice_to_ptr(targets),
                   static_cast<int>(targets.length()), matrix);
 }
@@ -899,6 +1025,7 @@ void applyControlledDiagMatr(Qureg& qureg,
                              int control,
                              rust::Slice<const int> targets,
                              const DiagMatr& matrix) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledDiagMatr(qureg, control, quest_helper::slice_to_ptr(targets),
                             static_cast<int>(targets.length()), matrix);
 }
@@ -907,6 +1034,7 @@ void applyMultiControlledDiagMatr(Qureg& qureg,
                                   rust::Slice<const int> controls,
                                   rust::Slice<const int> targets,
                                   const DiagMatr& matrix) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledDiagMatr(qureg, quest_helper::slice_to_ptr(controls),
                                  static_cast<int>(controls.length()),
                                  quest_helper::slice_to_ptr(targets),
@@ -918,6 +1046,7 @@ void applyMultiStateControlledDiagMatr(Qureg& qureg,
                                        rust::Slice<const int> states,
                                        rust::Slice<const int> targets,
                                        const DiagMatr& matrix) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledDiagMatr(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -930,6 +1059,7 @@ void multiplyDiagMatrPower(Qureg& qureg,
                            rust::Slice<const int> targets,
                            const DiagMatr& matrix,
                            Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyDiagMatrPower(qureg, quest_helper::slice_to_ptr(targets),
                           static_cast<int>(targets.length()), matrix, exponent);
 }
@@ -938,6 +1068,7 @@ void applyDiagMatrPower(Qureg& qureg,
                         rust::Slice<const int> targets,
                         const DiagMatr& matrix,
                         Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyDiagMatrPower(qureg, quest_helper::slice_to_ptr(targets),
                        static_cast<int>(targets.length()), matrix, exponent);
 }
@@ -947,6 +1078,7 @@ void applyControlledDiagMatrPower(Qureg& qureg,
                                   rust::Slice<const int> targets,
                                   const DiagMatr& matrix,
                                   Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyControlledDiagMatrPower(
       qureg, control, quest_helper::slice_to_ptr(targets),
       static_cast<int>(targets.length()), matrix, exponent);
@@ -957,6 +1089,7 @@ void applyMultiControlledDiagMatrPower(Qureg& qureg,
                                        rust::Slice<const int> targets,
                                        const DiagMatr& matrix,
                                        Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiControlledDiagMatrPower(
       qureg, quest_helper::slice_to_ptr(controls),
       static_cast<int>(controls.length()), quest_helper::slice_to_ptr(targets),
@@ -969,6 +1102,7 @@ void applyMultiStateControlledDiagMatrPower(Qureg& qureg,
                                             rust::Slice<const int> targets,
                                             const DiagMatr& matrix,
                                             Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyMultiStateControlledDiagMatrPower(
       qureg, quest_helper::slice_to_ptr(controls),
       quest_helper::slice_to_ptr(states), static_cast<int>(controls.length()),
@@ -978,22 +1112,26 @@ void applyMultiStateControlledDiagMatrPower(Qureg& qureg,
 
 /// FullStateDiagMatr
 void multiplyFullStateDiagMatr(Qureg& qureg, const FullStateDiagMatr& matrix) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyFullStateDiagMatr(qureg, matrix);
 }
 
 void multiplyFullStateDiagMatrPower(Qureg& qureg,
                                     const FullStateDiagMatr& matrix,
                                     Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::multiplyFullStateDiagMatrPower(qureg, matrix, exponent);
 }
 
 void applyFullStateDiagMatr(Qureg& qureg, const FullStateDiagMatr& matrix) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyFullStateDiagMatr(qureg, matrix);
 }
 
 void applyFullStateDiagMatrPower(Qureg& qureg,
                                  const FullStateDiagMatr& matrix,
                                  Quest_Complex exponent) {
+  QUEST_SYS_PROFILE(quest_helper::profile_bytes(qureg));
   ::applyFullStateDiagMatrPower(qureg, matrix, exponent);
 }
 
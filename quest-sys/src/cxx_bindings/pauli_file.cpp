@@ -0,0 +1,496 @@
+#include "pauli_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "helper.hpp"
+#include "mapped_file.hpp"
+
+// Binary Pauli sum layout, in native byte order:
+//   [0, 64)                      PauliFileHeader
+//   [stringsOffset, +numTerms)   PauliStr masks, 16 bytes each
+//   [coeffsOffset, +numTerms)    qcomp coefficients
+
+namespace quest_sys {
+namespace {
+constexpr std::array<char, 8> pauli_file_magic = {'Q', 'S', 'Y', 'S',
+                                                  'P', 'A', 'U', 'L'};
+constexpr std::uint32_t pauli_file_version = 1;
+
+// Text is split into chunks of at least this many bytes, one per thread
+constexpr std::size_t parse_grain = std::size_t{1} << 20;
+
+struct PauliFileHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t headerBytes;
+  std::uint32_t pauliBytes;
+  std::uint32_t coeffBytes;
+  std::uint64_t numTerms;
+  std::uint64_t stringsOffset;
+  std::uint64_t coeffsOffset;
+  std::array<std::uint64_t, 2> reserved;
+};
+static_assert(sizeof(PauliFileHeader) == 64,
+              "Pauli file header must stay 64 bytes");
+
+bool is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+void skip_blanks(const char*& p, const char* end) {
+  while (p < end && is_blank(*p)) {
+    ++p;
+  }
+}
+
+// Whether a line holds a term rather than whitespace or a '#' comment
+bool is_term_line(const char* p, const char* end) {
+  skip_blanks(p, end);
+  return p < end && *p != '#';
+}
+
+// Decimal reals without locale or allocation. Up to 19 significant digits
+// with a small exponent convert exactly, as both factors are exact doubles;
+// anything longer defers to strtod.
+bool parse_real(const char*& p, const char* end, qreal& out) {
+  static constexpr std::array<double, 23> powers = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char* start = p;
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = *p++ == '-';
+  }
+  std::uint64_t mantissa = 0;
+  int numDigits = 0;
+  int exponent = 0;
+  bool anyDigits = false;
+  auto take_digit = [&](char c, bool isFraction) {
+    anyDigits = true;
+    if (numDigits < 19) {
+      if (mantissa != 0 || c != '0') {
+        ++numDigits;
+      }
+      mantissa = mantissa * 10 + static_cast<std::uint64_t>(c - '0');
+      exponent -= isFraction;
+    } else {
+      exponent += !isFraction;
+    }
+  };
+  while (p < end && *p >= '0' && *p <= '9') {
+    take_digit(*p++, false);
+  }
+  if (p < end && *p == '.') {
+    ++p;
+    while (p < end && *p >= '0' && *p <= '9') {
+      take_digit(*p++, true);
+    }
+  }
+  if (!anyDigits) {
+    return false;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negativeExp = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+      negativeExp = *p++ == '-';
+    }
+    if (p == end || *p < '0' || *p > '9') {
+      return false;
+    }
+    int value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+      value = std::min(value * 10 + (*p++ - '0'), 100000);
+    }
+    exponent += negativeExp ? -value : value;
+  }
+
+  double magnitude;
+  if (mantissa == 0) {
+    magnitude = 0;
+  } else if (mantissa < (std::uint64_t{1} << 53) && exponent >= -22 &&
+             exponent <= 22) {
+    auto m = static_cast<double>(mantissa);
+    magnitude = exponent < 0 ? m / powers[static_cast<std::size_t>(-exponent)]
+                             : m * powers[static_cast<std::size_t>(exponent)];
+  } else {
+    std::string token(start, p);
+    out = static_cast<qreal>(std::strtod(token.c_str(), nullptr));
+    return true;
+  }
+  out = static_cast<qreal>(negative ? -magnitude : magnitude);
+  return true;
+}
+
+bool is_imaginary_unit(const char* p, const char* end) {
+  return p < end && (*p == 'i' || *p == 'j');
+}
+
+// Real ("1.5"), imaginary ("-2i") or complex ("1 - 2.5j") coefficients
+bool parse_coeff(const char*& p, const char* end, qcomp& out) {
+  qreal first;
+  if (!parse_real(p, end, first)) {
+    return false;
+  }
+  if (is_imaginary_unit(p, end)) {
+    ++p;
+    out = qcomp(0, first);
+    return true;
+  }
+  const char* rest = p;
+  skip_blanks(rest, end);
+  if (rest < end && (*rest == '+' || *rest == '-')) {
+    bool negative = *rest++ == '-';
+    skip_blanks(rest, end);
+    qreal second;
+    if (!parse_real(rest, end, second) || !is_imaginary_unit(rest, end)) {
+      return false;
+    }
+    p = rest + 1;
+    out = qcomp(first, negative ? -second : second);
+    return true;
+  }
+  out = qcomp(first, 0);
+  return true;
+}
+
+// Pauli symbols as letters (either case) or as the digits 0-3
+int pauli_token(char c) {
+  switch (c) {
+    case 'I':
+    case 'i':
+    case '0':
+      return 0;
+    case 'X':
+    case 'x':
+    case '1':
+      return 1;
+    case 'Y':
+    case 'y':
+    case '2':
+      return 2;
+    case 'Z':
+    case 'z':
+    case '3':
+      return 3;
+    default:
+      return -1;
+  }
+}
+
+// Parses one term line; numPaulis is set on the first line and enforced after
+bool parse_term(const char* p,
+                const char* end,
+                bool isReversed,
+                int& numPaulis,
+                PauliStr& str,
+                qcomp& coeff) {
+  skip_blanks(p, end);
+  if (!parse_coeff(p, end, coeff)) {
+    return false;
+  }
+  std::array<int, quest_helper::max_pauli_qubits> codes{};
+  int count = 0;
+  for (;;) {
+    skip_blanks(p, end);
+    if (p == end) {
+      break;
+    }
+    int code = pauli_token(*p++);
+    if (code < 0 || count == quest_helper::max_pauli_qubits) {
+      return false;
+    }
+    codes[static_cast<std::size_t>(count++)] = code;
+  }
+  if (count == 0 || (numPaulis >= 0 && count != numPaulis)) {
+    return false;
+  }
+  numPaulis = count;
+
+  str = PauliStr{0, 0};
+  for (std::size_t k = 0; k < static_cast<std::size_t>(count); ++k) {
+    int qubit = isReversed ? static_cast<int>(k)
+                           : count - 1 - static_cast<int>(k);
+    auto bits = static_cast<PAULI_MASK_TYPE>(codes[k]) << (2 * (qubit % 32));
+    (qubit < 32 ? str.lowPaulis : str.highPaulis) |= bits;
+  }
+  return true;
+}
+
+// A line-aligned slice of the text and what parsing it found
+struct TextChunk {
+  const char* begin;
+  const char* end;
+  Quest_Index numTerms = 0;
+  Quest_Index numLines = 0;
+  Quest_Index firstTerm = 0;
+  Quest_Index firstTermLine = -1;  // chunk-relative, 0-based
+  Quest_Index badLine = -1;        // chunk-relative, 0-based
+  int numPaulis = -1;
+};
+
+template <typename Func>
+void for_each_line(const char* begin, const char* end, Func&& func) {
+  for (const char* line = begin; line < end;) {
+    const char* stop = static_cast<const char*>(
+        std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+    if (stop == nullptr) {
+      stop = end;
+    }
+    if (!func(line, stop)) {
+      return;
+    }
+    line = stop + 1;
+  }
+}
+
+// Splits the text into at most maxChunks chunks of at least grain bytes
+std::vector<TextChunk> split_lines(const char* text,
+                                   std::size_t size,
+                                   std::size_t grain,
+                                   std::size_t maxChunks) {
+  std::size_t numChunks = std::clamp<std::size_t>(size / grain, 1, maxChunks);
+  std::vector<TextChunk> chunks;
+  const char* end = text + size;
+  const char* begin = text;
+  for (std::size_t c = 1; c <= numChunks && begin < end; ++c) {
+    const char* stop = text + size * c / numChunks;
+    if (stop < begin) {
+      continue;
+    }
+    const char* newline = static_cast<const char*>(
+        std::memchr(stop, '\n', static_cast<std::size_t>(end - stop)));
+    stop = newline == nullptr ? end : newline + 1;
+    chunks.push_back({begin, stop});
+    begin = stop;
+  }
+  return chunks;
+}
+
+bool read_binary_header(const quest_helper::MappedFile& file,
+                        PauliFileHeader& header,
+                        const char* caller) {
+  if (!file.is_open()) {
+    ::invalidQuESTInputError("Could not open the Pauli sum file.", caller);
+    return false;
+  }
+  if (file.size() < sizeof(PauliFileHeader)) {
+    ::invalidQuESTInputError("The Pauli sum file is truncated.", caller);
+    return false;
+  }
+  std::memcpy(&header, file.data(), sizeof(PauliFileHeader));
+  if (header.magic != pauli_file_magic ||
+      header.version != pauli_file_version) {
+    ::invalidQuESTInputError(
+        "The file is not a Pauli sum written by this version of quest-sys.",
+        caller);
+    return false;
+  }
+  if (header.pauliBytes != sizeof(PauliStr) ||
+      header.coeffBytes != sizeof(qcomp)) {
+    ::invalidQuESTInputError(
+        "The Pauli sum was written with a different floating-point "
+        "precision.",
+        caller);
+    return false;
+  }
+  // bounds are compared by division so a crafted header cannot wrap them
+  auto fits = [&](std::uint64_t offset, std::size_t elemBytes) {
+    return offset <= file.size() &&
+           header.numTerms <= (file.size() - offset) / elemBytes;
+  };
+  if (header.numTerms == 0 || !fits(header.stringsOffset, sizeof(PauliStr)) ||
+      !fits(header.coeffsOffset, sizeof(qcomp))) {
+    ::invalidQuESTInputError("The Pauli sum file is truncated.", caller);
+    return false;
+  }
+  if (header.stringsOffset % alignof(PauliStr) != 0 ||
+      header.coeffsOffset % alignof(qcomp) != 0) {
+    ::invalidQuESTInputError("The Pauli sum file arrays are misaligned.",
+                             caller);
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<PauliStrSum> load_text(const char* path,
+                                       bool isReversed,
+                                       std::size_t grain,
+                                       std::size_t maxChunks,
+                                       const char* caller) {
+  quest_helper::MappedFile file(path);
+  if (!file.is_open()) {
+    ::invalidQuESTInputError("Could not open the Pauli sum file.", caller);
+    return nullptr;
+  }
+  file.advise_sequential();
+  const auto* text = reinterpret_cast<const char*>(file.data());
+  auto chunks = split_lines(text, file.size(), grain, maxChunks);
+  const bool multithreaded = ::getQuESTEnv().isMultithreaded;
+
+  // Count terms first so every chunk parses straight into its final slot
+  quest_helper::parallel_for(
+      multithreaded, static_cast<Quest_Index>(chunks.size()), 1,
+      [&](Quest_Index begin, Quest_Index end) {
+        for (auto c = begin; c < end; ++c) {
+          auto& chunk = chunks[static_cast<std::size_t>(c)];
+          for_each_line(chunk.begin, chunk.end, [&](auto line, auto stop) {
+            ++chunk.numLines;
+            chunk.numTerms += is_term_line(line, stop);
+            return true;
+          });
+        }
+      });
+  Quest_Index numTerms = 0;
+  for (auto& chunk : chunks) {
+    chunk.firstTerm = numTerms;
+    numTerms += chunk.numTerms;
+  }
+  if (numTerms == 0) {
+    ::invalidQuESTInputError("The Pauli sum file contains no terms.", caller);
+    return nullptr;
+  }
+
+  std::vector<PauliStr> strings(static_cast<std::size_t>(numTerms));
+  std::vector<qcomp> coeffs(static_cast<std::size_t>(numTerms));
+  quest_helper::parallel_for(
+      multithreaded, static_cast<Quest_Index>(chunks.size()), 1,
+      [&](Quest_Index begin, Quest_Index end) {
+        for (auto c = begin; c < end; ++c) {
+          auto& chunk = chunks[static_cast<std::size_t>(c)];
+          auto term = static_cast<std::size_t>(chunk.firstTerm);
+          Quest_Index line = 0;
+          for_each_line(chunk.begin, chunk.end, [&](auto first, auto stop) {
+            if (is_term_line(first, stop)) {
+              if (chunk.firstTermLine < 0) {
+                chunk.firstTermLine = line;
+              }
+              if (!parse_term(first, stop, isReversed, chunk.numPaulis,
+                              strings[term], coeffs[term])) {
+                chunk.badLine = line;
+                return false;
+              }
+              ++term;
+            }
+            ++line;
+            return true;
+          });
+        }
+      });
+
+  Quest_Index lineOffset = 0;
+  int numPaulis = -1;
+  for (const auto& chunk : chunks) {
+    bool isMismatched = chunk.numPaulis >= 0 && numPaulis >= 0 &&
+                        chunk.numPaulis != numPaulis;
+    if (chunk.badLine >= 0 || isMismatched) {
+      // a chunk disagreeing with earlier ones does so from its first term,
+      // before any line it found bad by its own count
+      auto lineNumber =
+          lineOffset +
+          (isMismatched ? chunk.firstTermLine : chunk.badLine) + 1;
+      std::string message = "Could not parse line " +
+                            std::to_string(lineNumber) +
+                            " of the Pauli sum file, or its number of Paulis "
+                            "differs from earlier lines.";
+      ::invalidQuESTInputError(message.c_str(), caller);
+      return nullptr;
+    }
+    if (chunk.numPaulis >= 0) {
+      numPaulis = chunk.numPaulis;
+    }
+    lineOffset += chunk.numLines;
+  }
+
+  return std::make_unique<PauliStrSum>(
+      ::createPauliStrSum(strings.data(), coeffs.data(), numTerms));
+}
+}  // namespace
+
+std::unique_ptr<PauliStrSum> loadPauliStrSumFile(rust::String path,
+                                                 bool isReversed) {
+  return load_text(
+      path.c_str(), isReversed, parse_grain,
+      static_cast<std::size_t>(quest_helper::max_worker_threads()), __func__);
+}
+
+std::unique_ptr<PauliStrSum> loadPauliStrSumFileInChunks(
+    rust::String path,
+    bool isReversed,
+    std::uint64_t chunkBytes) {
+  if (chunkBytes == 0) {
+    ::invalidQuESTInputError("The chunk size must be at least one byte.",
+                             __func__);
+    return nullptr;
+  }
+  return load_text(path.c_str(), isReversed,
+                   static_cast<std::size_t>(chunkBytes),
+                   std::numeric_limits<std::size_t>::max(), __func__);
+}
+
+void savePauliStrSumBinary(const PauliStrSum& sum, rust::String path) {
+  // Every rank holds the sum, so only one writes it
+  if (::getQuESTEnv().rank != 0) {
+    return;
+  }
+  PauliFileHeader header{};
+  header.magic = pauli_file_magic;
+  header.version = pauli_file_version;
+  header.headerBytes = sizeof(PauliFileHeader);
+  header.pauliBytes = sizeof(PauliStr);
+  header.coeffBytes = sizeof(qcomp);
+  header.numTerms = static_cast<std::uint64_t>(sum.numTerms);
+  header.stringsOffset = sizeof(PauliFileHeader);
+  header.coeffsOffset =
+      header.stringsOffset + header.numTerms * sizeof(PauliStr);
+
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    ::invalidQuESTInputError("Could not open the Pauli sum file to write.",
+                             __func__);
+    return;
+  }
+  auto numTerms = static_cast<std::size_t>(sum.numTerms);
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+            std::fwrite(sum.strings, sizeof(PauliStr), numTerms, file) ==
+                numTerms &&
+            std::fwrite(sum.coeffs, sizeof(qcomp), numTerms, file) == numTerms;
+  ok = (std::fclose(file) == 0) && ok;
+  if (!ok) {
+    ::invalidQuESTInputError("Failed to write the Pauli sum file.", __func__);
+  }
+}
+
+std::unique_ptr<PauliStrSum> loadPauliStrSumBinary(rust::String path) {
+  quest_helper::MappedFile file(path.c_str());
+  PauliFileHeader header{};
+  if (!read_binary_header(file, header, __func__)) {
+    return nullptr;
+  }
+  // QuEST copies both arrays, so they are handed over from the mapping
+  auto* strings = reinterpret_cast<PauliStr*>(
+      const_cast<std::byte*>(file.data() + header.stringsOffset));
+  auto* coeffs = reinterpret_cast<qcomp*>(
+      const_cast<std::byte*>(file.data() + header.coeffsOffset));
+  return std::make_unique<PauliStrSum>(::createPauliStrSum(
+      strings, coeffs, static_cast<Quest_Index>(header.numTerms)));
+}
+
+void convertPauliStrSumFileToBinary(rust::String textPath,
+                                    rust::String binaryPath,
+                                    bool isReversed) {
+  auto sum = loadPauliStrSumFile(std::move(textPath), isReversed);
+  if (!sum) {
+    return;
+  }
+  savePauliStrSumBinary(*sum, std::move(binaryPath));
+  ::destroyPauliStrSum(*sum);
+}
+}  // namespace quest_sys
@@ -0,0 +1,239 @@
+#include "profiling.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <mutex>
+
+namespace quest_helper {
+namespace {
+struct TraceEvent {
+  const char* name;
+  std::uint64_t startNs;
+  std::uint64_t durationNs;
+  std::uint32_t thread;
+};
+
+struct ProfileRegistry {
+  std::mutex mutex;
+  std::vector<ProfileSite*> sites;
+
+  std::atomic<bool> tracing{false};
+  std::vector<TraceEvent> events;  // ring buffer once full
+  std::size_t capacity = 0;
+  std::size_t next = 0;
+};
+
+ProfileRegistry& registry() {
+  static ProfileRegistry instance;
+  return instance;
+}
+
+const std::chrono::steady_clock::time_point& epoch() {
+  static const auto start = std::chrono::steady_clock::now();
+  return start;
+}
+
+std::uint32_t thread_index() {
+  static std::atomic<std::uint32_t> counter{0};
+  thread_local const std::uint32_t index = counter.fetch_add(1);
+  return index;
+}
+
+int latency_bucket(std::uint64_t ns) {
+  if (ns < 8) {
+    return static_cast<int>(ns);
+  }
+  int exponent = static_cast<int>(std::bit_width(ns)) - 1;
+  auto sub = static_cast<int>((ns >> (exponent - 2)) & 3);
+  return 8 + (exponent - 3) * 4 + sub;
+}
+
+// Midpoint of a bucket's range
+std::uint64_t bucket_value(int bucket) {
+  if (bucket < 8) {
+    return static_cast<std::uint64_t>(bucket);
+  }
+  int exponent = (bucket - 8) / 4 + 3;
+  auto sub = static_cast<std::uint64_t>((bucket - 8) % 4);
+  std::uint64_t width = std::uint64_t{1} << (exponent - 2);
+  return (4 + sub) * width + width / 2;
+}
+
+std::uint64_t percentile(const std::vector<std::uint64_t>& counts,
+                         std::uint64_t total,
+                         double fraction) {
+  auto rank = static_cast<std::uint64_t>(fraction * static_cast<double>(total));
+  rank = std::min(std::max<std::uint64_t>(rank, 1), total);
+  std::uint64_t seen = 0;
+  for (int b = 0; b < num_latency_buckets; ++b) {
+    seen += counts[static_cast<std::size_t>(b)];
+    if (seen >= rank) {
+      return bucket_value(b);
+    }
+  }
+  return 0;
+}
+
+void append_micros(std::string& out, std::uint64_t ns) {
+  std::array<char, 32> buffer{};
+  auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(),
+                              static_cast<double>(ns) / 1000.0);
+  out.append(buffer.data(), result.ptr);
+}
+}  // namespace
+
+ProfileSite::ProfileSite(const char* name) : name(name) {
+  epoch();
+  auto& reg = registry();
+  std::lock_guard lock(reg.mutex);
+  reg.sites.push_back(this);
+}
+
+ProfileScope::ProfileScope(ProfileSite& site, std::uint64_t bytes)
+    : site_(site), bytes_(bytes), start_(std::chrono::steady_clock::now()) {}
+
+ProfileScope::~ProfileScope() {
+  auto end = std::chrono::steady_clock::now();
+  auto ns = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_)
+          .count());
+
+  site_.calls.fetch_add(1, std::memory_order_relaxed);
+  site_.totalNs.fetch_add(ns, std::memory_order_relaxed);
+  site_.bytes.fetch_add(bytes_, std::memory_order_relaxed);
+  site_.buckets[static_cast<std::size_t>(latency_bucket(ns))].fetch_add(
+      1, std::memory_order_relaxed);
+  auto max = site_.maxNs.load(std::memory_order_relaxed);
+  while (ns > max && !site_.maxNs.compare_exchange_weak(
+                         max, ns, std::memory_order_relaxed)) {
+  }
+
+  auto& reg = registry();
+  if (!reg.tracing.load(std::memory_order_relaxed)) {
+    return;
+  }
+  auto startNs = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(start_ - epoch())
+          .count());
+  TraceEvent event{site_.name, startNs, ns, thread_index()};
+  std::lock_guard lock(reg.mutex);
+  if (reg.capacity == 0) {
+    return;
+  }
+  if (reg.events.size() < reg.capacity) {
+    reg.events.push_back(event);
+  } else {
+    reg.events[reg.next] = event;
+  }
+  reg.next = (reg.next + 1) % reg.capacity;
+}
+
+std::vector<ProfileStats> profile_snapshot() {
+  auto& reg = registry();
+  std::vector<ProfileSite*> sites;
+  {
+    std::lock_guard lock(reg.mutex);
+    sites = reg.sites;
+  }
+
+  std::vector<ProfileStats> stats;
+  std::vector<std::uint64_t> counts(num_latency_buckets);
+  for (const auto* site : sites) {
+    std::uint64_t total = 0;
+    for (int b = 0; b < num_latency_buckets; ++b) {
+      counts[static_cast<std::size_t>(b)] =
+          site->buckets[static_cast<std::size_t>(b)].load(
+              std::memory_order_relaxed);
+      total += counts[static_cast<std::size_t>(b)];
+    }
+    if (total == 0) {
+      continue;
+    }
+    auto max = site->maxNs.load(std::memory_order_relaxed);
+    stats.push_back({site->name, site->calls.load(std::memory_order_relaxed),
+                     site->totalNs.load(std::memory_order_relaxed),
+                     std::min(percentile(counts, total, 0.50), max),
+                     std::min(percentile(counts, total, 0.90), max),
+                     std::min(percentile(counts, total, 0.99), max), max,
+                     site->bytes.load(std::memory_order_relaxed)});
+  }
+  return stats;
+}
+
+void reset_profile() {
+  auto& reg = registry();
+  std::lock_guard lock(reg.mutex);
+  for (auto* site : reg.sites) {
+    site->calls = 0;
+    site->totalNs = 0;
+    site->maxNs = 0;
+    site->bytes = 0;
+    for (auto& bucket : site->buckets) {
+      bucket = 0;
+    }
+  }
+  reg.events.clear();
+  reg.next = 0;
+}
+
+void set_profile_trace_capacity(std::uint64_t numEvents) {
+  auto& reg = registry();
+  std::lock_guard lock(reg.mutex);
+  reg.capacity = static_cast<std::size_t>(numEvents);
+  reg.events.clear();
+  reg.events.reserve(reg.capacity);
+  reg.next = 0;
+  reg.tracing = numEvents > 0;
+}
+
+// Wrapper names are C++ identifiers, so nothing needs escaping
+std::string profile_json() {
+  std::string out = "{\"functions\":[";
+  bool first = true;
+  for (const auto& s : profile_snapshot()) {
+    out += first ? "{" : ",{";
+    first = false;
+    out += "\"name\":\"" + s.name + "\"";
+    out += ",\"calls\":" + std::to_string(s.calls);
+    out += ",\"total_ns\":" + std::to_string(s.totalNs);
+    out += ",\"p50_ns\":" + std::to_string(s.p50Ns);
+    out += ",\"p90_ns\":" + std::to_string(s.p90Ns);
+    out += ",\"p99_ns\":" + std::to_string(s.p99Ns);
+    out += ",\"max_ns\":" + std::to_string(s.maxNs);
+    out += ",\"bytes\":" + std::to_string(s.bytes) + "}";
+  }
+  out += "]}";
+  return out;
+}
+
+std::string profile_chrome_trace() {
+  auto& reg = registry();
+  std::vector<TraceEvent> events;
+  {
+    std::lock_guard lock(reg.mutex);
+    // Oldest first, unwinding the ring
+    events.reserve(reg.events.size());
+    std::size_t start = reg.events.size() < reg.capacity ? 0 : reg.next;
+    for (std::size_t i = 0; i < reg.events.size(); ++i) {
+      events.push_back(reg.events[(start + i) % reg.events.size()]);
+    }
+  }
+
+  std::string out = "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& e : events) {
+    out += first ? "{" : ",{";
+    first = false;
+    out += "\"name\":\"";
+    out += e.name;
+    out += "\",\"cat\":\"quest_sys\",\"ph\":\"X\",\"ts\":";
+    append_micros(out, e.startNs);
+    out += ",\"dur\":";
+    append_micros(out, e.durationNs);
+    out += ",\"pid\":0,\"tid\":" + std::to_string(e.thread) + "}";
+  }
+  out += "],\"displayTimeUnit\":\"ns\"}";
+  return out;
+}
+}  // namespace quest_helper
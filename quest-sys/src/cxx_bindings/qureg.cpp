@@ -2,9 +2,31 @@
 // Created by Erich Essmann on 14/03/2025.
 //
 #include "qureg.hpp"
+
+#include <algorithm>
+#include <vector>
+
 #include "helper.hpp"
+#include "profiling.hpp"
 
 namespace quest_sys {
+namespace {
+// Copies the block's columns from GPU memory into the CPU buffer
+void sync_density_columns(Qureg& qureg,
+                          Quest_Index startRow,
+                          Quest_Index startCol,
+                          Quest_Index numRows,
+                          Quest_Index numCols) {
+  if (!qureg.isGpuAccelerated) {
+    return;
+  }
+  const Quest_Index dim = Quest_Index{1} << qureg.numQubits;
+  for (Quest_Index c = 0; c < numCols; ++c) {
+    ::syncSubQuregFromGpu(qureg, startRow + (startCol + c) * dim, numRows);
+  }
+}
+}  // namespace
+
 // Qureg
 std::unique_ptr<Qureg> createQureg(int numQubits) {
   return std::make_unique<Qureg>(::createQureg(numQubits));
@@ -70,50 +92,158 @@ void syncSubQuregFromGpu(Qureg& qureg,
 rust::Vec<Quest_Complex> getQuregAmps(Qureg& qureg,
                                       Quest_Index startInd,
                                       Quest_Index numAmps) {
-  std::vector<qcomp> amps(numAmps);
+  QUEST_SYS_PROFILE(std::max<Quest_Index>(numAmps, 0) * sizeof(Quest_Complex));
   rust::Vec<Quest_Complex> out_amps;
-  ::getQuregAmps(amps.data(), qureg, startInd, numAmps);
-  auto convert_amps = quest_helper::apply_deep(
-      amps, [](qcomp val) { return Quest_Complex(val); });
-  for (auto amp : convert_amps) {
-    out_amps.emplace_back(amp);
+  if (numAmps <= 0) {
+    return out_amps;
+  }
+  out_amps.reserve(static_cast<std::size_t>(numAmps));
+  for (Quest_Index i = 0; i < numAmps; ++i) {
+    out_amps.emplace_back();
   }
+  ::getQuregAmps(Quest_Complex::to_qcomp_ptr(out_amps.data()), qureg, startInd,
+                 numAmps);
   return out_amps;
 }
 
-rust::Vec<Quest_Complex> getDensityQuregAmps(Qureg& qureg,
-                                             Quest_Index startRow,
-                                             Quest_Index startCol,
-                                             Quest_Index numRows,
-                                             Quest_Index numCols) {
-  std::vector<std::vector<qcomp>> amps(numRows);
-  for (auto& row : amps) {
-    row.reserve(numCols);
+void getQuregAmpsInto(Qureg& qureg,
+                      Quest_Index startInd,
+                      rust::Slice<Quest_Complex> outAmps) {
+  QUEST_SYS_PROFILE(outAmps.length() * sizeof(Quest_Complex));
+  // Quest_Complex and qcomp share a layout, so QuEST writes straight into the
+  // caller's buffer
+  ::getQuregAmps(Quest_Complex::to_qcomp_ptr(outAmps.data()), qureg, startInd,
+                 static_cast<Quest_Index>(outAmps.length()));
+}
+
+rust::Slice<const Quest_Complex> getQuregAmpsView(const Qureg& qureg) {
+  if (!isQuregAmpsViewable(qureg)) {
+    ::invalidQuESTInputError(
+        "Amplitudes can only be borrowed from a statevector which is neither "
+        "distributed nor GPU-accelerated.",
+        __func__);
+    return {};
   }
-  std::vector<qcomp*> amp_ptr(numRows);
-  ::getDensityQuregAmps(amp_ptr.data(), qureg, startRow, startCol, numRows,
-                        numCols);
+  return {Quest_Complex::from_qcomp_ptr(qureg.cpuAmps),
+          static_cast<std::size_t>(qureg.numAmps)};
+}
 
-  auto convert_amps = quest_helper::apply_deep(
-      amps, [](qcomp val) { return Quest_Complex(val); });
+bool isQuregAmpsViewable(const Qureg& qureg) {
+  return !qureg.isDensityMatrix && !qureg.isDistributed &&
+         !qureg.isGpuAccelerated;
+}
 
+rust::Vec<Quest_Complex> getDensityQuregAmps_flatten(Qureg& qureg,
+                                                     Quest_Index startRow,
+                                                     Quest_Index startCol,
+                                                     Quest_Index numRows,
+                                                     Quest_Index numCols) {
+  QUEST_SYS_PROFILE(std::max<Quest_Index>(numRows * numCols, 0) *
+                    sizeof(Quest_Complex));
   rust::Vec<Quest_Complex> out;
-  for (auto row : convert_amps) {
-    for (auto val : row) {
-      out.emplace_back(val);
+  if (numRows <= 0 || numCols <= 0) {
+    return out;
+  }
+  auto numAmps = static_cast<std::size_t>(numRows * numCols);
+  out.reserve(numAmps);
+  for (std::size_t i = 0; i < numAmps; ++i) {
+    out.emplace_back();
+  }
+  getDensityQuregAmpsInto(
+      qureg, startRow, startCol, numRows, numCols,
+      rust::Slice<Quest_Complex>(out.data(), out.size()));
+  return out;
+}
+
+void getDensityQuregAmpsInto(Qureg& qureg,
+                             Quest_Index startRow,
+                             Quest_Index startCol,
+                             Quest_Index numRows,
+                             Quest_Index numCols,
+                             rust::Slice<Quest_Complex> outAmps) {
+  QUEST_SYS_PROFILE(outAmps.length() * sizeof(Quest_Complex));
+  if (!quest_helper::validate_density_block(
+          qureg, startRow, startCol, numRows, numCols, outAmps.length(), false,
+          __func__)) {
+    return;
+  }
+  qcomp* out = Quest_Complex::to_qcomp_ptr(outAmps.data());
+
+  if (qureg.isDistributed) {
+    // a single table of row pointers into the caller's buffer
+    std::vector<qcomp*> rows(static_cast<std::size_t>(numRows));
+    for (Quest_Index r = 0; r < numRows; ++r) {
+      rows[static_cast<std::size_t>(r)] = out + r * numCols;
     }
+    ::getDensityQuregAmps(rows.data(), qureg, startRow, startCol, numRows,
+                          numCols);
+    return;
   }
 
-  return out;
+  // QuEST stores the density matrix column-major, so the block is gathered
+  // column by column and transposed tile-wise into row-major order
+  constexpr Quest_Index tile = 32;
+  const Quest_Index dim = Quest_Index{1} << qureg.numQubits;
+  sync_density_columns(qureg, startRow, startCol, numRows, numCols);
+  for (Quest_Index colTile = 0; colTile < numCols; colTile += tile) {
+    Quest_Index colEnd = std::min(colTile + tile, numCols);
+    for (Quest_Index rowTile = 0; rowTile < numRows; rowTile += tile) {
+      Quest_Index rowEnd = std::min(rowTile + tile, numRows);
+      for (Quest_Index c = colTile; c < colEnd; ++c) {
+        const qcomp* column = qureg.cpuAmps + startRow + (startCol + c) * dim;
+        for (Quest_Index r = rowTile; r < rowEnd; ++r) {
+          out[r * numCols + c] = column[r];
+        }
+      }
+    }
+  }
+}
+
+void getDensityQuregAmpsColMajorInto(Qureg& qureg,
+                                     Quest_Index startRow,
+                                     Quest_Index startCol,
+                                     Quest_Index numRows,
+                                     Quest_Index numCols,
+                                     rust::Slice<Quest_Complex> outAmps) {
+  QUEST_SYS_PROFILE(outAmps.length() * sizeof(Quest_Complex));
+  if (!quest_helper::validate_density_block(
+          qureg, startRow, startCol, numRows, numCols, outAmps.length(), false,
+          __func__)) {
+    return;
+  }
+  qcomp* out = Quest_Complex::to_qcomp_ptr(outAmps.data());
+
+  if (qureg.isDistributed) {
+    // fetch one column at a time, reusing the row pointer table
+    std::vector<qcomp*> rows(static_cast<std::size_t>(numRows));
+    for (Quest_Index c = 0; c < numCols; ++c) {
+      for (Quest_Index r = 0; r < numRows; ++r) {
+        rows[static_cast<std::size_t>(r)] = out + c * numRows + r;
+      }
+      ::getDensityQuregAmps(rows.data(), qureg, startRow, startCol + c,
+                            numRows, 1);
+    }
+    return;
+  }
+
+  // each column of the block is contiguous in the local amplitude buffer
+  const Quest_Index dim = Quest_Index{1} << qureg.numQubits;
+  sync_density_columns(qureg, startRow, startCol, numRows, numCols);
+  for (Quest_Index c = 0; c < numCols; ++c) {
+    std::copy_n(qureg.cpuAmps + startRow + (startCol + c) * dim, numRows,
+                out + c * numRows);
+  }
 }
 
 Quest_Complex getQuregAmp(Qureg& qureg, Quest_Index index) {
+  QUEST_SYS_PROFILE(sizeof(Quest_Complex));
   return ::getQuregAmp(qureg, index);
 }
 
 Quest_Complex getDensityQuregAmp(Qureg& qureg,
                                  Quest_Index row,
                                  Quest_Index column) {
+  QUEST_SYS_PROFILE(sizeof(Quest_Complex));
   return ::getDensityQuregAmp(qureg, row, column);
 }
 }  // namespace quest_sys
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "qureg_pool.hpp"
+#include "quest-sys/src/lib.rs.h"
+
+#include <algorithm>
+#include <optional>
+
+namespace quest_sys {
+namespace {
+// The deployment flag createQureg passes when QuEST should decide
+constexpr int auto_deployment = -1;
+
+QuregShape shape_of(const Qureg& qureg) {
+  return {qureg.numQubits, qureg.isDensityMatrix, qureg.isDistributed,
+          qureg.isGpuAccelerated, qureg.isMultithreaded};
+}
+
+// Amplitude memory of one node, not counting a GPU copy
+std::uint64_t amp_bytes(const Qureg& qureg) {
+  return static_cast<std::uint64_t>(qureg.numAmpsPerNode) * sizeof(qcomp);
+}
+
+Qureg create(const QuregShape& shape) {
+  if (shape.isDistributed == auto_deployment &&
+      shape.isGpuAccelerated == auto_deployment &&
+      shape.isMultithreaded == auto_deployment) {
+    return shape.isDensityMatrix ? ::createDensityQureg(shape.numQubits)
+                                 : ::createQureg(shape.numQubits);
+  }
+  return ::createCustomQureg(shape.numQubits, shape.isDensityMatrix,
+                             shape.isDistributed, shape.isGpuAccelerated,
+                             shape.isMultithreaded);
+}
+
+// Pops an idle register of the shape `request` resolved to when it was last
+// created, or returns false when there is none
+bool take(QuregPoolState& state, const QuregShape& request, Qureg& out) {
+  auto resolved = state.resolved.find(request);
+  const auto& shape =
+      resolved == state.resolved.end() ? request : resolved->second;
+  auto it = state.idle.find(shape);
+  if (it == state.idle.end() || it->second.empty()) {
+    return false;
+  }
+  out = it->second.back();
+  it->second.pop_back();
+  --state.numIdle;
+  state.idleBytes -= amp_bytes(out);
+  return true;
+}
+
+// Reuses an idle register of the requested shape or creates a new one.
+// Empty when QuEST rejected the creation without exiting, which leaves no
+// amplitude storage, so such a register is never lent out or shelved.
+template <typename Create>
+std::optional<Qureg> take_or_create(QuregPoolState& state,
+                                    const QuregShape& request,
+                                    Create&& create,
+                                    bool& reused) {
+  Qureg qureg{};
+  {
+    std::lock_guard lock(state.mutex);
+    reused = take(state, request, qureg);
+  }
+  if (!reused) {
+    qureg = create();
+    if (qureg.cpuAmps == nullptr) {
+      return std::nullopt;
+    }
+  }
+
+  std::lock_guard lock(state.mutex);
+  if (reused) {
+    ++state.numReused;
+  } else {
+    state.resolved.try_emplace(request, shape_of(qureg));
+    ++state.numCreated;
+  }
+  state.highWaterMark = std::max(state.highWaterMark, ++state.numInUse);
+  return qureg;
+}
+
+void destroy_idle(QuregPoolState& state) {
+  for (auto& [shape, quregs] : state.idle) {
+    for (auto& qureg : quregs) {
+      ::destroyQureg(qureg);
+    }
+  }
+  state.idle.clear();
+  state.numIdle = 0;
+  state.idleBytes = 0;
+}
+
+bool is_valid_init(int initialState, const char* caller) {
+  if (initialState < static_cast<int>(QuregInit::Keep) ||
+      initialState > static_cast<int>(QuregInit::Zero)) {
+    ::invalidQuESTInputError("Unknown initial state for a pooled Qureg.",
+                             caller);
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+QuregPoolState::~QuregPoolState() {
+  destroy_idle(*this);
+}
+
+PooledQureg::~PooledQureg() {
+  std::lock_guard lock(state_->mutex);
+  state_->idle[shape_of(qureg_)].push_back(qureg_);
+  ++state_->numIdle;
+  --state_->numInUse;
+  state_->idleBytes += amp_bytes(qureg_);
+}
+
+std::unique_ptr<PooledQureg> QuregPool::acquire(const QuregShape& shape,
+                                                QuregInit init) {
+  if (shape.numQubits < 1) {
+    ::invalidQuESTInputError("A pooled Qureg needs at least one qubit.",
+                             "acquireQureg");
+    return nullptr;
+  }
+  bool reused = false;
+  auto qureg = take_or_create(
+      *state_, shape, [&] { return create(shape); }, reused);
+  if (!qureg) {
+    return nullptr;
+  }
+  if (init == QuregInit::Blank) {
+    ::initBlankState(*qureg);
+  } else if (init == QuregInit::Zero && reused) {
+    ::initZeroState(*qureg);
+  }
+  return std::make_unique<PooledQureg>(state_, *qureg);
+}
+
+std::unique_ptr<PooledQureg> QuregPool::acquireClone(const Qureg& qureg) {
+  bool reused = false;
+  auto clone = take_or_create(
+      *state_, shape_of(qureg), [&] { return ::createCloneQureg(qureg); },
+      reused);
+  if (!clone) {
+    return nullptr;
+  }
+  if (reused) {
+    ::setQuregToClone(*clone, qureg);
+  }
+  return std::make_unique<PooledQureg>(state_, *clone);
+}
+
+QuregPoolStats QuregPool::stats() const {
+  std::lock_guard lock(state_->mutex);
+  return QuregPoolStats{state_->numInUse,      state_->numIdle,
+                        state_->highWaterMark, state_->numCreated,
+                        state_->numReused,     state_->idleBytes};
+}
+
+void QuregPool::clear() {
+  std::lock_guard lock(state_->mutex);
+  destroy_idle(*state_);
+}
+
+// Qureg pools
+std::unique_ptr<QuregPool> createQuregPool() {
+  return std::make_unique<QuregPool>();
+}
+
+std::unique_ptr<PooledQureg> acquireQureg(QuregPool& pool,
+                                          int numQubits,
+                                          int initialState) {
+  if (!is_valid_init(initialState, __func__)) {
+    return nullptr;
+  }
+  return pool.acquire({numQubits, 0, auto_deployment, auto_deployment,
+                       auto_deployment},
+                      static_cast<QuregInit>(initialState));
+}
+
+std::unique_ptr<PooledQureg> acquireDensityQureg(QuregPool& pool,
+                                                 int numQubits,
+                                                 int initialState) {
+  if (!is_valid_init(initialState, __func__)) {
+    return nullptr;
+  }
+  return pool.acquire({numQubits, 1, auto_deployment, auto_deployment,
+                       auto_deployment},
+                      static_cast<QuregInit>(initialState));
+}
+
+std::unique_ptr<PooledQureg> acquireCustomQureg(QuregPool& pool,
+                                                int numQubits,
+                                                int isDensMatr,
+                                                int useDistrib,
+                                                int useGpuAccel,
+                                                int useMultithread,
+                                                int initialState) {
+  if (!is_valid_init(initialState, __func__)) {
+    return nullptr;
+  }
+  return pool.acquire(
+      {numQubits, isDensMatr, useDistrib, useGpuAccel, useMultithread},
+      static_cast<QuregInit>(initialState));
+}
+
+std::unique_ptr<PooledQureg> acquireCloneQureg(QuregPool& pool,
+                                               const Qureg& qureg) {
+  return pool.acquireClone(qureg);
+}
+
+const Qureg& getPooledQureg(const PooledQureg& handle) {
+  return handle.get();
+}
+
+Qureg& getPooledQuregMut(PooledQureg& handle) {
+  return handle.get();
+}
+
+QuregPoolStats getQuregPoolStats(const QuregPool& pool) {
+  return pool.stats();
+}
+
+void clearQuregPool(QuregPool& pool) {
+  pool.clear();
+}
+}  // namespace quest_sys
@@ -0,0 +1,249 @@
+#include "sweep.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace quest_sys {
+namespace {
+// Above this many statevector qubits one register threaded by QuEST beats
+// several unthreaded ones, which would each be bandwidth bound
+constexpr int max_qubits_per_worker = 20;
+
+bool validate_register(const Qureg& qureg,
+                       const ParameterisedCircuit& circuit,
+                       const char* caller) {
+  if (circuit.tape().maxQubit() >= qureg.numQubits) {
+    ::invalidQuESTInputError(
+        "The circuit tape targets qubits beyond the width of the Qureg.",
+        caller);
+    return false;
+  }
+  return true;
+}
+
+// Workers on a local register run unthreaded so circuits, not QuEST's loops,
+// are what runs in parallel
+Qureg create_worker(const Qureg& initial, bool isShared) {
+  if (!isShared) {
+    return ::createCloneQureg(initial);
+  }
+  return ::createCustomQureg(initial.numQubits, initial.isDensityMatrix, 0, 0,
+                             0);
+}
+
+// The copy keeps the tape's layout, so parameter offsets carry over
+std::unique_ptr<CircuitTape> copy_tape(const CircuitTape& tape) {
+  CircuitTapeBuilder builder;
+  for (const auto& inst : tape.instructions()) {
+    builder.copy(tape, inst);
+  }
+  return builder.build();
+}
+}  // namespace
+
+ParameterisedCircuit::ParameterisedCircuit(
+    std::unique_ptr<CircuitTape> tape,
+    std::vector<ParameterBinding> bindings)
+    : tape_(std::move(tape)), bindings_(std::move(bindings)) {
+  for (const auto& binding : bindings_) {
+    numColumns_ = std::max(numColumns_, binding.column + 1);
+  }
+}
+
+void ParameterisedCircuit::bind(const qreal* row,
+                                std::vector<qreal>& params) const {
+  for (const auto& binding : bindings_) {
+    params[binding.paramIndex] = binding.scale * row[binding.column];
+  }
+}
+
+std::unique_ptr<ParameterisedCircuit> ParameterisedCircuit::rebind(
+    std::vector<ParameterBinding> bindings) const {
+  return std::make_unique<ParameterisedCircuit>(copy_tape(*tape_),
+                                                std::move(bindings));
+}
+
+std::vector<qreal> ParameterisedCircuit::defaultParams() const {
+  std::vector<qreal> params(tape_->numParams());
+  for (const auto& inst : tape_->instructions()) {
+    const qreal* p = tape_->params(inst);
+    std::copy_n(p, gateKindNumParams(inst.kind, inst.numQubits),
+                params.begin() + inst.paramOffset);
+  }
+  return params;
+}
+
+void ParameterisedCircuit::apply(Qureg& qureg,
+                                 std::vector<qreal>& params,
+                                 const qreal* row) const {
+  bind(row, params);
+  tape_->applyRange(qureg, 0, tape_->size(), params.data());
+}
+
+std::vector<qreal> calcSweepExpectations(const Qureg& initial,
+                                         const ParameterisedCircuit& circuit,
+                                         const PauliStrSum& observable,
+                                         const qreal* rows,
+                                         std::size_t numSets,
+                                         int numWorkers) {
+  if (numSets == 0) {
+    return {};
+  }
+  std::size_t numColumns = circuit.numColumns();
+
+  // Distributed and GPU registers cannot be driven from several threads
+  int effectiveQubits = initial.numQubits * (initial.isDensityMatrix ? 2 : 1);
+  if (numWorkers <= 0) {
+    numWorkers = effectiveQubits > max_qubits_per_worker
+                     ? 1
+                     : static_cast<int>(std::max(
+                           1u, std::thread::hardware_concurrency()));
+  }
+  if (initial.isDistributed || initial.isGpuAccelerated) {
+    numWorkers = 1;
+  }
+  numWorkers = static_cast<int>(
+      std::min(static_cast<std::size_t>(numWorkers), numSets));
+  bool isShared = numWorkers > 1;
+
+  std::vector<qreal> values(numSets);
+  auto evaluate = [&](Qureg& q, std::vector<qreal>& params, std::size_t i) {
+    ::setQuregToClone(q, initial);
+    circuit.apply(q, params, rows + i * numColumns);
+    values[i] = ::calcExpecPauliStrSum(q, observable);
+  };
+
+  // The first set runs alone so QuEST computes and caches the lazily
+  // evaluated matrix and observable properties before they are shared
+  auto qureg = create_worker(initial, isShared);
+  auto params = circuit.defaultParams();
+  evaluate(qureg, params, 0);
+
+  std::atomic<std::size_t> next{1};
+  auto work = [&](Qureg& q, std::vector<qreal>& p) {
+    for (auto i = next++; i < numSets; i = next++) {
+      evaluate(q, p, i);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  std::vector<Qureg> pool;
+  std::vector<std::vector<qreal>> buffers;
+  for (int w = 1; w < numWorkers; ++w) {
+    pool.push_back(create_worker(initial, isShared));
+    buffers.push_back(params);
+  }
+  for (std::size_t w = 0; w < pool.size(); ++w) {
+    workers.emplace_back(work, std::ref(pool[w]), std::ref(buffers[w]));
+  }
+  work(qureg, params);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (auto& q : pool) {
+    ::destroyQureg(q);
+  }
+  ::destroyQureg(qureg);
+
+  return values;
+}
+
+// Parameter sweeps
+std::unique_ptr<ParameterisedCircuit> createParameterisedCircuit(
+    const CircuitTape& tape,
+    rust::Slice<const std::uint32_t> instructions,
+    rust::Slice<const std::uint32_t> columns,
+    rust::Slice<const double> scales) {
+  if (instructions.length() != columns.length() ||
+      instructions.length() != scales.length()) {
+    ::invalidQuESTInputError(
+        "Every bound instruction needs exactly one column and one scale.",
+        __func__);
+    return nullptr;
+  }
+  if (instructions.empty()) {
+    ::invalidQuESTInputError("At least one angle must be bound.", __func__);
+    return nullptr;
+  }
+
+  const auto& insts = tape.instructions();
+  std::vector<ParameterBinding> bindings;
+  for (std::size_t i = 0; i < instructions.length(); ++i) {
+    if (instructions[i] >= insts.size() ||
+        !gateKindHasAngle(insts[instructions[i]].kind)) {
+      ::invalidQuESTInputError(
+          "Only the angle of a rotation or phase instruction can be bound.",
+          __func__);
+      return nullptr;
+    }
+    bindings.push_back({insts[instructions[i]].paramOffset, columns[i],
+                        static_cast<qreal>(scales[i])});
+  }
+
+  for (const auto& inst : insts) {
+    if (inst.kind == GateKind::FullStateDiagMatr) {
+      ::invalidQuESTInputError(
+          "Tapes with coalesced whole-register diagonals cannot be "
+          "parameterised; bind the angles before coalescing.",
+          __func__);
+      return nullptr;
+    }
+  }
+  return std::make_unique<ParameterisedCircuit>(copy_tape(tape),
+                                                std::move(bindings));
+}
+
+std::uint32_t getParameterisedCircuitNumColumns(
+    const ParameterisedCircuit& circuit) {
+  return circuit.numColumns();
+}
+
+void applyParameterisedCircuit(Qureg& qureg,
+                               const ParameterisedCircuit& circuit,
+                               rust::Slice<const double> row) {
+  if (row.length() != circuit.numColumns()) {
+    ::invalidQuESTInputError(
+        "The parameter row does not match the circuit's number of columns.",
+        __func__);
+    return;
+  }
+  if (!validate_register(qureg, circuit, __func__)) {
+    return;
+  }
+  auto params = circuit.defaultParams();
+  circuit.apply(qureg, params, quest_helper::slice_to_ptr(row));
+}
+
+rust::Vec<Quest_Real> runParameterSweep(const Qureg& initial,
+                                        const ParameterisedCircuit& circuit,
+                                        const PauliStrSum& observable,
+                                        rust::Slice<const double> parameters,
+                                        int numWorkers) {
+  rust::Vec<Quest_Real> out;
+  std::size_t numColumns = circuit.numColumns();
+  if (parameters.length() % numColumns != 0) {
+    ::invalidQuESTInputError(
+        "The parameter matrix length is not a multiple of the circuit's "
+        "number of columns.",
+        __func__);
+    return out;
+  }
+  if (!validate_register(initial, circuit, __func__)) {
+    return out;
+  }
+
+  std::size_t numSets = parameters.length() / numColumns;
+  auto values =
+      calcSweepExpectations(initial, circuit, observable,
+                            quest_helper::slice_to_ptr(parameters), numSets,
+                            numWorkers);
+  out.reserve(numSets);
+  for (qreal value : values) {
+    out.push_back(value);
+  }
+  return out;
+}
+}  // namespace quest_sys
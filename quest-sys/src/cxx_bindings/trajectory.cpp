@@ -0,0 +1,306 @@
+#include "trajectory.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace quest_sys {
+namespace {
+// A channel prepared for sampling. Mixed-unitary channels (all the Pauli
+// channels) pick a branch from fixed weights and apply a unitary; damping and
+// general Kraus maps weigh each operator by the norm it leaves behind.
+struct SampledChannel {
+  bool isMixedUnitary = false;
+  bool isDamping = false;
+  std::vector<Quest_Real> weights;  // mixed-unitary only
+  std::vector<bool> isIdentity;     // mixed-unitary only
+  std::vector<CompMatr> ops;
+};
+
+struct SampledSite {
+  std::uint32_t channel;
+  std::vector<int> targets;
+};
+
+struct TrajectoryPlan {
+  std::vector<SampledChannel> channels;
+  std::vector<std::vector<SampledSite>> sites;  // per instruction
+
+  ~TrajectoryPlan() {
+    for (auto& channel : channels) {
+      for (auto& op : channel.ops) {
+        ::destroyCompMatr(op);
+      }
+    }
+  }
+};
+
+CompMatr make_op(const qcomp* elems, int numQubits, qreal scale) {
+  auto op = ::createCompMatr(numQubits);
+  auto count = static_cast<std::size_t>(op.numRows) *
+               static_cast<std::size_t>(op.numRows);
+  for (std::size_t i = 0; i < count; ++i) {
+    op.cpuElemsFlat[i] = elems[i] * scale;
+  }
+  ::syncCompMatr(op);
+  return op;
+}
+
+SampledChannel prepare_channel(const NoiseChannel& channel) {
+  SampledChannel out;
+  auto dim = std::size_t{1} << channel.numQubits;
+  auto opSize = dim * dim;
+  out.isDamping = channel.kind == ChannelKind::Damping;
+  out.isMixedUnitary = channel.kind != ChannelKind::Damping &&
+                       channel.kind != ChannelKind::Kraus;
+
+  for (int k = 0; k < channel.numOperators; ++k) {
+    const qcomp* elems =
+        channel.kraus.data() + static_cast<std::size_t>(k) * opSize;
+    if (!out.isMixedUnitary) {
+      out.ops.push_back(make_op(elems, channel.numQubits, 1));
+      continue;
+    }
+    // Each operator is sqrt(w) times a Pauli string, so |K[0][c]|^2 = w for
+    // the single non-zero c of row 0
+    Quest_Real weight = 0;
+    for (std::size_t c = 0; c < dim; ++c) {
+      weight += std::norm(elems[c]);
+    }
+    if (weight == 0) {
+      continue;
+    }
+    out.weights.push_back(weight);
+    out.isIdentity.push_back(k == 0);
+    out.ops.push_back(make_op(elems, channel.numQubits, 1 / std::sqrt(weight)));
+  }
+  return out;
+}
+
+void apply_op(Qureg& qureg, const std::vector<int>& targets, CompMatr op) {
+  ::multiplyCompMatr(qureg, const_cast<int*>(targets.data()),
+                     static_cast<int>(targets.size()), op);
+}
+
+void sample_channel(Qureg& qureg,
+                    Qureg& scratch,
+                    const SampledChannel& channel,
+                    const std::vector<int>& targets,
+                    std::mt19937_64& rng) {
+  std::uniform_real_distribution<Quest_Real> uniform(0, 1);
+  Quest_Real r = uniform(rng);
+
+  if (channel.isMixedUnitary) {
+    std::size_t k = 0;
+    while (k + 1 < channel.weights.size() && r >= channel.weights[k]) {
+      r -= channel.weights[k++];
+    }
+    if (!channel.isIdentity[k]) {
+      apply_op(qureg, targets, channel.ops[k]);
+    }
+    return;
+  }
+
+  std::size_t last = channel.ops.size() - 1;
+  std::size_t chosen = last;
+  if (channel.isDamping) {
+    // Only the decay operator has a state-dependent norm: p * P(|1>)
+    Quest_Real root = channel.ops[1].cpuElemsFlat[1].real();
+    Quest_Real decay =
+        root * root * ::calcProbOfQubitOutcome(qureg, targets[0], 1);
+    chosen = r < decay ? 1 : 0;
+  } else {
+    for (std::size_t k = 0; k < last; ++k) {
+      ::setQuregToClone(scratch, qureg);
+      apply_op(scratch, targets, channel.ops[k]);
+      Quest_Real norm = ::calcTotalProb(scratch);
+      if (r < norm) {
+        std::swap(qureg, scratch);
+        ::setQuregToRenormalized(qureg);
+        return;
+      }
+      r -= norm;
+    }
+  }
+  apply_op(qureg, targets, channel.ops[chosen]);
+  ::setQuregToRenormalized(qureg);
+}
+
+Quest_Real run_trajectory(Qureg& qureg,
+                          Qureg& scratch,
+                          const Qureg& initial,
+                          const CircuitTape& tape,
+                          const TrajectoryPlan& plan,
+                          const PauliStrSum& observable,
+                          std::uint64_t seed,
+                          std::uint64_t index) {
+  std::seed_seq seq{static_cast<std::uint32_t>(seed),
+                    static_cast<std::uint32_t>(seed >> 32),
+                    static_cast<std::uint32_t>(index),
+                    static_cast<std::uint32_t>(index >> 32)};
+  std::mt19937_64 rng(seq);
+
+  ::setQuregToClone(qureg, initial);
+  for (std::size_t i = 0; i < plan.sites.size(); ++i) {
+    tape.applyRange(qureg, i, i + 1);
+    for (const auto& site : plan.sites[i]) {
+      sample_channel(qureg, scratch, plan.channels[site.channel],
+                     site.targets, rng);
+    }
+  }
+  return ::calcExpecPauliStrSum(qureg, observable);
+}
+
+// Workers on a local register run unthreaded so trajectories, not QuEST's
+// loops, are what runs in parallel
+Qureg create_worker(const Qureg& initial, bool isShared) {
+  if (!isShared) {
+    return ::createCloneQureg(initial);
+  }
+  auto qureg = ::createCustomQureg(initial.numQubits, 0, 0, 0, 0);
+  ::setQuregToClone(qureg, initial);
+  return qureg;
+}
+}  // namespace
+
+TrajectoryResult::TrajectoryResult(std::vector<Quest_Real> samples)
+    : samples_(std::move(samples)) {
+  // Welford's update, stable for long runs of near-equal samples
+  Quest_Real sumSq = 0;
+  std::size_t n = 0;
+  for (Quest_Real x : samples_) {
+    ++n;
+    Quest_Real delta = x - mean_;
+    mean_ += delta / static_cast<Quest_Real>(n);
+    sumSq += delta * (x - mean_);
+  }
+  variance_ = n > 1 ? sumSq / static_cast<Quest_Real>(n - 1) : 0;
+}
+
+Quest_Real TrajectoryResult::standardError() const {
+  return samples_.empty()
+             ? 0
+             : std::sqrt(variance_ / static_cast<Quest_Real>(samples_.size()));
+}
+
+// Trajectories
+std::unique_ptr<TrajectoryResult> runNoisyTrajectories(
+    const Qureg& initial,
+    const CircuitTape& tape,
+    const NoiseModel& model,
+    const PauliStrSum& observable,
+    std::uint64_t numTrajectories,
+    int numWorkers,
+    std::uint64_t seed) {
+  if (initial.isDensityMatrix) {
+    ::invalidQuESTInputError(
+        "Trajectories must start from a statevector; apply noisy circuits to "
+        "density matrices with applyNoisyCircuit.",
+        __func__);
+    return nullptr;
+  }
+  if (tape.maxQubit() >= initial.numQubits) {
+    ::invalidQuESTInputError(
+        "The circuit tape targets qubits beyond the width of the Qureg.",
+        __func__);
+    return nullptr;
+  }
+  if (numTrajectories == 0) {
+    ::invalidQuESTInputError("At least one trajectory is required.",
+                             __func__);
+    return nullptr;
+  }
+
+  TrajectoryPlan plan;
+  for (const auto& channel : model.channels()) {
+    plan.channels.push_back(prepare_channel(channel));
+  }
+  std::vector<ChannelTarget> targets;
+  for (const auto& inst : tape.instructions()) {
+    if (!resolveNoiseRules(model, tape, inst, targets)) {
+      return nullptr;
+    }
+    const int* q = tape.qubits(inst);
+    auto& sites = plan.sites.emplace_back();
+    for (const auto& target : targets) {
+      std::vector<int> qubits;
+      for (int pos : target.operands) {
+        qubits.push_back(q[pos]);
+      }
+      sites.push_back({target.channel, std::move(qubits)});
+    }
+  }
+
+  // Distributed and GPU registers cannot be driven from several threads
+  if (numWorkers <= 0) {
+    numWorkers = static_cast<int>(
+        std::max(1u, std::thread::hardware_concurrency()));
+  }
+  if (initial.isDistributed || initial.isGpuAccelerated) {
+    numWorkers = 1;
+  }
+  numWorkers = static_cast<int>(
+      std::min<std::uint64_t>(static_cast<std::uint64_t>(numWorkers),
+                              numTrajectories));
+  bool isShared = numWorkers > 1;
+
+  std::vector<Quest_Real> samples(numTrajectories);
+
+  // The first trajectory runs alone so QuEST computes and caches the lazily
+  // evaluated matrix and observable properties before they are shared
+  auto qureg = create_worker(initial, isShared);
+  auto scratch = create_worker(initial, isShared);
+  samples[0] = run_trajectory(qureg, scratch, initial, tape, plan, observable,
+                              seed, 0);
+
+  std::atomic<std::uint64_t> next{1};
+  auto work = [&](Qureg& q, Qureg& s) {
+    for (auto i = next++; i < numTrajectories; i = next++) {
+      samples[i] =
+          run_trajectory(q, s, initial, tape, plan, observable, seed, i);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  std::vector<std::pair<Qureg, Qureg>> pool;
+  for (int w = 1; w < numWorkers; ++w) {
+    pool.emplace_back(create_worker(initial, isShared),
+                      create_worker(initial, isShared));
+  }
+  for (auto& [q, s] : pool) {
+    workers.emplace_back(work, std::ref(q), std::ref(s));
+  }
+  work(qureg, scratch);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (auto& [q, s] : pool) {
+    ::destroyQureg(q);
+    ::destroyQureg(s);
+  }
+  ::destroyQureg(qureg);
+  ::destroyQureg(scratch);
+  return std::make_unique<TrajectoryResult>(std::move(samples));
+}
+
+Quest_Real getTrajectoryMean(const TrajectoryResult& result) {
+  return result.mean();
+}
+
+Quest_Real getTrajectoryVariance(const TrajectoryResult& result) {
+  return result.variance();
+}
+
+Quest_Real getTrajectoryStdError(const TrajectoryResult& result) {
+  return result.standardError();
+}
+
+rust::Slice<const Quest_Real> getTrajectorySamples(
+    const TrajectoryResult& result) {
+  return {result.samples().data(), result.samples().size()};
+}
+}  // namespace quest_sys
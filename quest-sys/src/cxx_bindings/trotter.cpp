@@ -0,0 +1,376 @@
+#include "trotter.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <map>
+
+namespace quest_sys {
+namespace {
+// Widest regions folded into one DiagMatr or CompMatr
+constexpr int max_diagonal_qubits = 16;
+constexpr int max_matrix_qubits = 4;
+
+bool is_diagonal(const PauliStr& str) {
+  for (int q = 0; q < quest_helper::max_pauli_qubits; ++q) {
+    int code = quest_helper::pauli_code(str, q);
+    if (code == 1 || code == 2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool commutes(const PauliStr& a, const PauliStr& b) {
+  int numAnticommuting = 0;
+  for (int q = 0; q < quest_helper::max_pauli_qubits; ++q) {
+    int ca = quest_helper::pauli_code(a, q);
+    int cb = quest_helper::pauli_code(b, q);
+    numAnticommuting += ca && cb && ca != cb;
+  }
+  return numAnticommuting % 2 == 0;
+}
+
+bool blocks_commute(const TrotterBlock& a, const TrotterBlock& b) {
+  for (const auto& ta : a.terms) {
+    for (const auto& tb : b.terms) {
+      if (!commutes(ta.str, tb.str)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<int> support_qubits(std::uint64_t support) {
+  std::vector<int> qubits;
+  for (int q = 0; q < quest_helper::max_pauli_qubits; ++q) {
+    if ((support >> q) & 1) {
+      qubits.push_back(q);
+    }
+  }
+  return qubits;
+}
+
+// Masks of a term over its block's qubits: P|b> = i^numY (-1)^|b & z| |b ^ x>
+struct LocalPauli {
+  std::uint64_t x = 0;
+  std::uint64_t z = 0;
+  qcomp phase{1, 0};
+};
+
+LocalPauli localise(const PauliStr& str, const std::vector<int>& qubits) {
+  LocalPauli out;
+  int numY = 0;
+  for (std::size_t j = 0; j < qubits.size(); ++j) {
+    int code = quest_helper::pauli_code(str, qubits[j]);
+    if (code == 1 || code == 2) {
+      out.x |= std::uint64_t{1} << j;
+    }
+    if (code == 2 || code == 3) {
+      out.z |= std::uint64_t{1} << j;
+    }
+    numY += code == 2;
+  }
+  const qcomp yPhases[] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+  out.phase = yPhases[numY % 4];
+  return out;
+}
+
+// Suzuki's recursion, as QuEST applies it, flattened into first-order passes
+void expand_passes(int order,
+                   Quest_Real factor,
+                   std::vector<std::pair<Quest_Real, bool>>& out) {
+  if (order == 1) {
+    out.emplace_back(factor, false);
+    return;
+  }
+  if (order == 2) {
+    out.emplace_back(factor / 2, false);
+    out.emplace_back(factor / 2, true);
+    return;
+  }
+  Quest_Real p = 1 / (4 - std::pow(4, 1.0 / (order - 1)));
+  for (Quest_Real f : {p, p, 1 - 4 * p, p, p}) {
+    expand_passes(order - 2, f * factor, out);
+  }
+}
+
+// Groups terms into blocks: diagonal terms by region, then the rest by exact
+// support, with identical strings merged
+std::vector<TrotterBlock> build_blocks(const PauliStrSum& sum) {
+  std::map<std::pair<PAULI_MASK_TYPE, PAULI_MASK_TYPE>, std::size_t> merged;
+  std::vector<TrotterTerm> terms;
+  for (Quest_Index t = 0; t < sum.numTerms; ++t) {
+    const auto& str = sum.strings[t];
+    auto [it, isNew] =
+        merged.try_emplace({str.lowPaulis, str.highPaulis}, terms.size());
+    if (!isNew) {
+      terms[it->second].coeff += sum.coeffs[t].real();
+      continue;
+    }
+    std::uint64_t support = 0;
+    for (int q = 0; q < quest_helper::max_pauli_qubits; ++q) {
+      if (quest_helper::pauli_code(str, q)) {
+        support |= std::uint64_t{1} << q;
+      }
+    }
+    terms.push_back({str, sum.coeffs[t].real(), support});
+  }
+
+  std::vector<TrotterBlock> blocks;
+  std::uint64_t diagonalSupport = 0;
+  std::map<std::uint64_t, std::size_t> bySupport;
+  for (const auto& term : terms) {
+    if (is_diagonal(term.str)) {
+      auto combined = diagonalSupport | term.support;
+      bool fits = std::popcount(combined) <= max_diagonal_qubits;
+      bool isOpen = !blocks.empty() &&
+                    blocks.back().kind == TrotterBlock::Kind::Diagonal;
+      if (!isOpen || !fits) {
+        blocks.push_back({TrotterBlock::Kind::Diagonal, {}, {}, {}, {}, {}});
+        combined = term.support;
+      }
+      diagonalSupport = combined;
+      blocks.back().terms.push_back(term);
+      blocks.back().qubits = support_qubits(diagonalSupport);
+    }
+  }
+  std::size_t numDiagonal = blocks.size();
+  for (const auto& term : terms) {
+    if (is_diagonal(term.str)) {
+      continue;
+    }
+    bool canMerge = std::popcount(term.support) <= max_matrix_qubits;
+    auto it = bySupport.find(term.support);
+    if (canMerge && it != bySupport.end()) {
+      blocks[it->second].kind = TrotterBlock::Kind::Matrix;
+      blocks[it->second].terms.push_back(term);
+      continue;
+    }
+    if (canMerge) {
+      bySupport[term.support] = blocks.size();
+    }
+    blocks.push_back({TrotterBlock::Kind::Gadget, {term},
+                      support_qubits(term.support), {}, {}, {}});
+  }
+
+  // Chain the off-diagonal blocks so neighbours commute where possible
+  std::vector<TrotterBlock> ordered(
+      std::make_move_iterator(blocks.begin()),
+      std::make_move_iterator(blocks.begin() +
+                              static_cast<std::ptrdiff_t>(numDiagonal)));
+  std::vector<bool> used(blocks.size(), false);
+  for (std::size_t placed = numDiagonal; placed < blocks.size(); ++placed) {
+    std::size_t next = numDiagonal;
+    while (used[next]) {
+      ++next;
+    }
+    if (!ordered.empty()) {
+      for (std::size_t b = next; b < blocks.size(); ++b) {
+        if (!used[b] && blocks_commute(ordered.back(), blocks[b])) {
+          next = b;
+          break;
+        }
+      }
+    }
+    used[next] = true;
+    ordered.push_back(std::move(blocks[next]));
+  }
+  return ordered;
+}
+}  // namespace
+
+TrotterSchedule::TrotterSchedule(const PauliStrSum& sum, int order, int reps)
+    : reps_(reps) {
+  numTerms_ = sum.numTerms;
+  blocks_ = build_blocks(sum);
+  expand_passes(order, 1, passes_);
+  for (const auto& pass : passes_) {
+    auto it = std::find(slots_.begin(), slots_.end(), pass);
+    passSlot_.push_back(static_cast<std::size_t>(it - slots_.begin()));
+    if (it == slots_.end()) {
+      slots_.push_back(pass);
+    }
+  }
+
+  for (auto& block : blocks_) {
+    if (!block.qubits.empty()) {
+      maxQubit_ = std::max(maxQubit_, block.qubits.back());
+    }
+    if (block.kind == TrotterBlock::Kind::Diagonal) {
+      // Identity-only diagonals are a global phase, carried on qubit 0
+      if (block.qubits.empty()) {
+        block.qubits.push_back(0);
+        maxQubit_ = std::max(maxQubit_, 0);
+      }
+      block.energies.assign(std::size_t{1} << block.qubits.size(), 0);
+      for (const auto& term : block.terms) {
+        auto local = localise(term.str, block.qubits);
+        for (std::size_t b = 0; b < block.energies.size(); ++b) {
+          bool isOdd = std::popcount(b & local.z) & 1;
+          block.energies[b] += isOdd ? -term.coeff : term.coeff;
+        }
+      }
+      for (std::size_t s = 0; s < slots_.size(); ++s) {
+        block.diagonals.push_back(
+            ::createDiagMatr(static_cast<int>(block.qubits.size())));
+      }
+    } else if (block.kind == TrotterBlock::Kind::Matrix) {
+      for (std::size_t s = 0; s < slots_.size(); ++s) {
+        block.matrices.push_back(
+            ::createCompMatr(static_cast<int>(block.qubits.size())));
+      }
+    }
+  }
+}
+
+TrotterSchedule::~TrotterSchedule() {
+  for (auto& block : blocks_) {
+    for (auto& matr : block.matrices) {
+      ::destroyCompMatr(matr);
+    }
+    for (auto& matr : block.diagonals) {
+      ::destroyDiagMatr(matr);
+    }
+  }
+}
+
+// Each gadget is exp(-i a c P), which QuEST's Trotteriser applies as
+// applyPauliGadget(2 a c) with a the pass angle
+void TrotterSchedule::refill(Quest_Real angle) {
+  Quest_Real stepAngle = angle / reps_;
+  for (auto& block : blocks_) {
+    for (std::size_t s = 0; s < slots_.size(); ++s) {
+      auto [factor, isReversed] = slots_[s];
+      Quest_Real a = stepAngle * factor;
+
+      if (block.kind == TrotterBlock::Kind::Diagonal) {
+        auto& matr = block.diagonals[s];
+        for (std::size_t b = 0; b < block.energies.size(); ++b) {
+          matr.cpuElems[b] = std::polar<qreal>(1, -a * block.energies[b]);
+        }
+        ::syncDiagMatr(matr);
+      } else if (block.kind == TrotterBlock::Kind::Matrix) {
+        auto dim = std::size_t{1} << block.qubits.size();
+        std::vector<qcomp> total(dim * dim, qcomp(0, 0));
+        for (std::size_t d = 0; d < dim; ++d) {
+          total[d * dim + d] = 1;
+        }
+        std::vector<qcomp> next(dim * dim);
+        for (std::size_t k = 0; k < block.terms.size(); ++k) {
+          const auto& term =
+              block.terms[isReversed ? block.terms.size() - 1 - k : k];
+          auto local = localise(term.str, block.qubits);
+          Quest_Real phi = a * term.coeff;
+          // (cos(phi) I - i sin(phi) P) * total, row by row
+          for (std::size_t c = 0; c < dim; ++c) {
+            for (std::size_t r = 0; r < dim; ++r) {
+              auto src = r ^ local.x;
+              qcomp sign = (std::popcount(src & local.z) & 1) ? -1 : 1;
+              next[r * dim + c] =
+                  std::cos(phi) * total[r * dim + c] -
+                  qcomp(0, std::sin(phi)) * local.phase * sign *
+                      total[src * dim + c];
+            }
+          }
+          std::swap(total, next);
+        }
+        auto& matr = block.matrices[s];
+        std::copy(total.begin(), total.end(), matr.cpuElemsFlat);
+        ::syncCompMatr(matr);
+      }
+    }
+  }
+  isFilled_ = true;
+  filledAngle_ = angle;
+}
+
+void TrotterSchedule::apply(Qureg& qureg, Quest_Real angle) {
+  if (!isFilled_ || angle != filledAngle_) {
+    refill(angle);
+  }
+  Quest_Real stepAngle = angle / reps_;
+  for (int rep = 0; rep < reps_; ++rep) {
+    for (std::size_t p = 0; p < passes_.size(); ++p) {
+      auto [factor, isReversed] = passes_[p];
+      std::size_t slot = passSlot_[p];
+      for (std::size_t i = 0; i < blocks_.size(); ++i) {
+        auto& block = blocks_[isReversed ? blocks_.size() - 1 - i : i];
+        auto* qubits = block.qubits.data();
+        auto numQubits = static_cast<int>(block.qubits.size());
+        switch (block.kind) {
+          case TrotterBlock::Kind::Gadget: {
+            const auto& term = block.terms.front();
+            ::applyPauliGadget(qureg, term.str,
+                               2 * stepAngle * factor * term.coeff);
+            break;
+          }
+          case TrotterBlock::Kind::Matrix:
+            ::applyCompMatr(qureg, qubits, numQubits, block.matrices[slot]);
+            break;
+          case TrotterBlock::Kind::Diagonal:
+            ::applyDiagMatr(qureg, qubits, numQubits, block.diagonals[slot]);
+            break;
+        }
+      }
+    }
+  }
+}
+
+Quest_Index TrotterSchedule::numTermSweeps() const {
+  return numTerms_ * static_cast<Quest_Index>(passes_.size()) * reps_;
+}
+
+Quest_Index TrotterSchedule::numBlockSweeps() const {
+  return static_cast<Quest_Index>(blocks_.size() * passes_.size()) * reps_;
+}
+
+// Trotter schedules
+std::unique_ptr<TrotterSchedule> createTrotterSchedule(const PauliStrSum& sum,
+                                                       int order,
+                                                       int reps) {
+  if (order < 1 || (order > 1 && order % 2 != 0)) {
+    ::invalidQuESTInputError(
+        "The Trotter order must be 1 or a positive even number.", __func__);
+    return nullptr;
+  }
+  if (reps < 1) {
+    ::invalidQuESTInputError("The number of Trotter repetitions must be "
+                             "positive.",
+                             __func__);
+    return nullptr;
+  }
+  for (Quest_Index t = 0; t < sum.numTerms; ++t) {
+    if (std::abs(sum.coeffs[t].imag()) > ::getValidationEpsilon()) {
+      ::invalidQuESTInputError(
+          "Trotter schedules require a Hermitian PauliStrSum, with real "
+          "coefficients.",
+          __func__);
+      return nullptr;
+    }
+  }
+  return std::make_unique<TrotterSchedule>(sum, order, reps);
+}
+
+void applyTrotterSchedule(Qureg& qureg,
+                          TrotterSchedule& schedule,
+                          Quest_Real angle) {
+  if (schedule.maxQubit() >= qureg.numQubits) {
+    ::invalidQuESTInputError(
+        "The Trotter schedule targets qubits beyond the width of the Qureg.",
+        __func__);
+    return;
+  }
+  schedule.apply(qureg, angle);
+}
+
+Quest_Index getTrotterScheduleNumSweeps(const TrotterSchedule& schedule) {
+  return schedule.numBlockSweeps();
+}
+
+Quest_Index getTrotterScheduleSweepsSaved(const TrotterSchedule& schedule) {
+  return schedule.numTermSweeps() - schedule.numBlockSweeps();
+}
+}  // namespace quest_sys
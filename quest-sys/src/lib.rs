@@ -7,6 +7,79 @@ pub mod ffi {
         pub im: f64,
     }
 
+    // Per-wrapper counters from the profiling feature; times are wall-clock
+    // nanoseconds and percentiles are accurate to within 12.5%
+    #[namespace = "quest_sys"]
+    #[derive(Debug, Clone)]
+    pub struct ProfileEntry {
+        pub name: String,
+        pub calls: u64,
+        pub total_ns: u64,
+        pub p50_ns: u64,
+        pub p90_ns: u64,
+        pub p99_ns: u64,
+        pub max_ns: u64,
+        pub bytes: u64,
+    }
+
+    // Occupancy of a QuregPool in registers; idle_bytes is the amplitude
+    // memory per node held by idle registers, not counting GPU copies
+    #[namespace = "quest_sys"]
+    #[derive(Debug, Clone, Copy)]
+    pub struct QuregPoolStats {
+        pub in_use: u64,
+        pub idle: u64,
+        pub high_water_mark: u64,
+        pub created: u64,
+        pub reused: u64,
+        pub idle_bytes: u64,
+    }
+
+    // Opcodes of a CircuitTape. circuit.hpp holds the definition and cxx
+    // checks every value below against it, so the two cannot drift apart
+    #[namespace = "quest_sys"]
+    #[repr(u32)]
+    enum GateKind {
+        Hadamard = 0,
+        PauliX,
+        PauliY,
+        PauliZ,
+        S,
+        T,
+        RotateX,
+        RotateY,
+        RotateZ,
+        PhaseShift,
+        RotateAroundAxis,
+        Swap,
+        SqrtSwap,
+        ControlledHadamard,
+        ControlledPauliX,
+        ControlledPauliY,
+        ControlledPauliZ,
+        ControlledRotateX,
+        ControlledRotateY,
+        ControlledRotateZ,
+        MultiQubitPhaseShift,
+        MultiQubitPhaseFlip,
+        PhaseGadget,
+        CompMatr1,
+        CompMatr2,
+        DiagMatr1,
+        DiagMatr2,
+        CompMatr,
+        DiagMatr,
+    }
+
+    // How a pooled register is initialised, checked against qureg_pool.hpp
+    #[namespace = "quest_sys"]
+    #[repr(i32)]
+    enum QuregInit {
+        Keep = 0,
+        Blank = 1,
+        Zero = 2,
+    }
+
     unsafe extern "C++" {
         include!("types.hpp");
 
@@ -46,6 +119,10 @@ pub mod ffi {
         fn calcProbOfMultiQubitOutcome(qureg: &Qureg, qubits: &[i32], outcomes: &[i32]) -> f64;
         fn calcProbsOfAllMultiQubitOutcomes(outcomeProbs: &mut [f64], qureg: &Qureg, qubits: &[i32]);
 
+        // Shot sampling, seeded from setSeeds and the per-call seed
+        fn sampleMultiQubitOutcomes(qureg: &Qureg, qubits: &[i32], numShots: u64, seed: u64) -> Vec<i64>;
+        fn sampleMultiQubitOutcomeCounts(counts: &mut [u64], qureg: &Qureg, qubits: &[i32], numShots: u64, seed: u64);
+
         // Purity and fidelity
         fn calcPurity(qureg: &Qureg) -> f64;
         fn calcFidelity(qureg: &Qureg, other: &Qureg) -> f64;
@@ -64,6 +141,23 @@ pub mod ffi {
         fn calcExpecNonHermitianFullStateDiagMatrPower(qureg: &Qureg, matrix: &FullStateDiagMatr, exponent: Quest_Complex) -> Quest_Complex;
     }
 
+    // Channel cache
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("channel_cache.hpp");
+        type ChannelCache;
+
+        // Handles are non-zero; identical operators return the same handle
+        fn createChannelCache() -> UniquePtr<ChannelCache>;
+        fn cacheKrausMap(cache: Pin<&mut ChannelCache>, numQubits: i32, numOperators: i32, matrices: &[Quest_Complex]) -> u64;
+        fn getCachedKrausMap(cache: &ChannelCache, handle: u64) -> &KrausMap;
+        fn getCachedSuperOp(cache: &ChannelCache, handle: u64) -> &SuperOp;
+        fn evictCachedChannel(cache: Pin<&mut ChannelCache>, handle: u64) -> bool;
+        fn clearChannelCache(cache: Pin<&mut ChannelCache>);
+        fn getChannelCacheNumEntries(cache: &ChannelCache) -> usize;
+        fn getChannelCacheBytes(cache: &ChannelCache) -> usize;
+    }
+
     // Channels
     #[namespace = "quest_sys"]
     unsafe extern "C++" {
@@ -82,6 +176,42 @@ pub mod ffi {
         fn setSuperOp(map: Pin<&mut SuperOp>, matrix: &[&[Quest_Complex]]);
         fn createInlineKrausMap(numQubits: i32, numOperators: i32, matrices: &[&[&[Quest_Complex]]]) -> UniquePtr<KrausMap>;
         fn createInlineSuperOp(numQubits: i32, matrix: &[&[Quest_Complex]]) -> UniquePtr<SuperOp>;
+
+        // Flat operators x dim x dim inputs, each operator row-major
+        fn setKrausMapFlat(map: Pin<&mut KrausMap>, matrices: &[Quest_Complex]);
+        fn setSuperOpFlat(op: Pin<&mut SuperOp>, matrix: &[Quest_Complex]);
+        fn createInlineKrausMapFlat(numQubits: i32, numOperators: i32, matrices: &[Quest_Complex]) -> UniquePtr<KrausMap>;
+        fn createInlineSuperOpFlat(numQubits: i32, matrix: &[Quest_Complex]) -> UniquePtr<SuperOp>;
+    }
+
+    // Checkpoints
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("checkpoint.hpp");
+        fn saveQuregCheckpoint(qureg: Pin<&mut Qureg>, path: String, withChecksum: bool);
+        // A rejected checkpoint leaves the register untouched and returns false;
+        // createQuregFromCheckpoint then returns null
+        fn loadQuregCheckpoint(qureg: Pin<&mut Qureg>, path: String) -> bool;
+        fn createQuregFromCheckpoint(path: String) -> UniquePtr<Qureg>;
+    }
+
+    // Circuits
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("circuit.hpp");
+        type GateKind;
+        type CircuitTape;
+
+        // Gate tapes, see `gate_kind` for the opcodes
+        fn createCircuitTape(opcodes: &[u32], arities: &[u32], qubits: &[i32], params: &[f64]) -> UniquePtr<CircuitTape>;
+        fn applyCircuitTape(qureg: Pin<&mut Qureg>, tape: &CircuitTape);
+        fn getCircuitTapeSize(tape: &CircuitTape) -> usize;
+
+        // Gate fusion
+        fn fuseCircuitTape(tape: &CircuitTape, maxWidth: i32) -> UniquePtr<CircuitTape>;
+
+        // Diagonal coalescing
+        fn coalesceDiagonalGates(tape: &CircuitTape, numQubits: i32, maxDiagWidth: i32) -> UniquePtr<CircuitTape>;
     }
 
     // Debug
@@ -111,6 +241,14 @@ pub mod ffi {
 
         // Environment 
         fn getEnvironmentString() -> String;
+
+        // Profiling
+        fn isProfilingEnabled() -> bool;
+        fn getProfileEntries() -> Vec<ProfileEntry>;
+        fn getProfileJson() -> String;
+        fn getProfileChromeTrace() -> String;
+        fn setProfileTraceCapacity(numEvents: u64);
+        fn resetProfile();
     }
 
     // Decoherence
@@ -141,6 +279,36 @@ pub mod ffi {
         fn getQuESTEnv() -> UniquePtr<QuESTEnv>;
     }
 
+    // Gradients
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("gradient.hpp");
+        type DifferentiableCircuit;
+
+        fn createDifferentiableCircuit(circuit: &ParameterisedCircuit) -> UniquePtr<DifferentiableCircuit>;
+        // d<observable>/d(row[c]) for every column; the shifted circuits run as one parameter sweep
+        fn calcParameterShiftGradient(initial: &Qureg, circuit: &DifferentiableCircuit, observable: &PauliStrSum, row: &[f64], numWorkers: i32) -> Vec<f64>;
+        // As above in about three circuit executions, on statevectors only
+        fn calcAdjointGradient(initial: &Qureg, circuit: &DifferentiableCircuit, observable: &PauliStrSum, row: &[f64]) -> Vec<f64>;
+    }
+
+    // Hamiltonians
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("hamiltonian.hpp");
+        type AnalysedHamiltonian;
+
+        // Terms are split into qubit-wise-commuting groups once, at creation
+        fn createAnalysedHamiltonian(sum: &PauliStrSum) -> UniquePtr<AnalysedHamiltonian>;
+        fn getAnalysedHamiltonianNumGroups(ham: &AnalysedHamiltonian) -> usize;
+        fn getAnalysedHamiltonianGroupQubits(ham: &AnalysedHamiltonian, group: usize) -> &[i32];
+        fn calcExpecAnalysedHamiltonian(qureg: &Qureg, ham: &AnalysedHamiltonian, workspace: Pin<&mut Qureg>) -> f64;
+
+        // Hardware emulation: rotate into a group's basis, then sample its qubits
+        fn setQuregToHamiltonianGroupBasis(out: Pin<&mut Qureg>, in_: &Qureg, ham: &AnalysedHamiltonian, group: usize);
+        fn allocateAnalysedHamiltonianShots(counts: &mut [u64], ham: &AnalysedHamiltonian, numShots: u64);
+    }
+
     // Initialisation
     #[namespace = "quest_sys"]
     unsafe extern "C++" {
@@ -159,6 +327,7 @@ pub mod ffi {
         // Setting amplitudes
         fn setQuregAmps(qureg: Pin<&mut Qureg>, startInd: i64, amps: &[Quest_Complex]);
         fn setDensityQuregAmps(qureg: Pin<&mut Qureg>, startRow: i64, startCol: i64, amps: &[&[Quest_Complex]]);
+        fn setDensityQuregAmpsFlat(qureg: Pin<&mut Qureg>, startRow: i64, startCol: i64, numRows: i64, numCols: i64, amps: &[Quest_Complex]);
         fn setDensityQuregFlatAmps(qureg: Pin<&mut Qureg>, startInd: i64, amps: &[Quest_Complex]);
 
         // Qureg manipulation
@@ -175,6 +344,8 @@ pub mod ffi {
         // Matrix creation and destruction
         fn getCompMatr1(in_: &[&[Quest_Complex]]) -> UniquePtr<CompMatr1>;
         fn getCompMatr2(in_: &[&[Quest_Complex]]) -> UniquePtr<CompMatr2>;
+        fn getCompMatr1Flat(in_: &[Quest_Complex]) -> UniquePtr<CompMatr1>;
+        fn getCompMatr2Flat(in_: &[Quest_Complex]) -> UniquePtr<CompMatr2>;
         fn getDiagMatr1(in_: &[Quest_Complex]) -> UniquePtr<DiagMatr1>;
         fn getDiagMatr2(in_: &[Quest_Complex]) -> UniquePtr<DiagMatr2>;
 
@@ -194,6 +365,7 @@ pub mod ffi {
 
         // Setting matrix values
         fn setCompMatr(out: Pin<&mut CompMatr>, in_: &[&[Quest_Complex]]);
+        fn setCompMatrFlat(out: Pin<&mut CompMatr>, in_: &[Quest_Complex], dim: i64);
         fn setDiagMatr(out: Pin<&mut DiagMatr>, in_: &[Quest_Complex]);
         fn setFullStateDiagMatr(out: Pin<&mut FullStateDiagMatr>, startInd: i64, in_: &[Quest_Complex]);
 
@@ -211,6 +383,60 @@ pub mod ffi {
         fn reportFullStateDiagMatr(matr: &FullStateDiagMatr);
     }
 
+    // Matrix pools
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("matrix_pool.hpp");
+        type MatrixPool;
+        type PooledCompMatr;
+        type PooledDiagMatr;
+        type PooledFullStateDiagMatr;
+
+        // Handles return their matrix to the pool when dropped. Acquiring
+        // returns null if QuEST rejects the width or the allocation.
+        fn createMatrixPool() -> UniquePtr<MatrixPool>;
+        fn acquireCompMatr(pool: Pin<&mut MatrixPool>, numQubits: i32) -> UniquePtr<PooledCompMatr>;
+        fn acquireDiagMatr(pool: Pin<&mut MatrixPool>, numQubits: i32) -> UniquePtr<PooledDiagMatr>;
+        fn acquireFullStateDiagMatr(pool: Pin<&mut MatrixPool>, numQubits: i32) -> UniquePtr<PooledFullStateDiagMatr>;
+
+        fn getPooledCompMatr(handle: &PooledCompMatr) -> &CompMatr;
+        fn getPooledCompMatrMut(handle: Pin<&mut PooledCompMatr>) -> Pin<&mut CompMatr>;
+        fn getPooledDiagMatr(handle: &PooledDiagMatr) -> &DiagMatr;
+        fn getPooledDiagMatrMut(handle: Pin<&mut PooledDiagMatr>) -> Pin<&mut DiagMatr>;
+        fn getPooledFullStateDiagMatr(handle: &PooledFullStateDiagMatr) -> &FullStateDiagMatr;
+        fn getPooledFullStateDiagMatrMut(handle: Pin<&mut PooledFullStateDiagMatr>) -> Pin<&mut FullStateDiagMatr>;
+
+        fn getMatrixPoolNumIdle(pool: &MatrixPool) -> usize;
+        fn clearMatrixPool(pool: Pin<&mut MatrixPool>);
+    }
+
+    // Noise models
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("noise.hpp");
+        type NoiseModel;
+        type NoisyCircuit;
+
+        // Channel constructors return an index to pass to addNoiseRule, or u32::MAX if rejected
+        fn createNoiseModel() -> UniquePtr<NoiseModel>;
+        fn addDephasingChannel(model: Pin<&mut NoiseModel>, prob: f64) -> u32;
+        fn addDepolarisingChannel(model: Pin<&mut NoiseModel>, prob: f64) -> u32;
+        fn addDampingChannel(model: Pin<&mut NoiseModel>, prob: f64) -> u32;
+        fn addPauliChannel(model: Pin<&mut NoiseModel>, probX: f64, probY: f64, probZ: f64) -> u32;
+        fn addTwoQubitDephasingChannel(model: Pin<&mut NoiseModel>, prob: f64) -> u32;
+        fn addTwoQubitDepolarisingChannel(model: Pin<&mut NoiseModel>, prob: f64) -> u32;
+        fn addKrausChannel(model: Pin<&mut NoiseModel>, numQubits: i32, numOperators: i32, matrices: &[Quest_Complex]) -> u32;
+
+        // An empty qubit list matches the opcode on any qubits
+        fn addNoiseRule(model: Pin<&mut NoiseModel>, opcode: u32, qubits: &[i32], channel: u32);
+
+        // Gates of up to maxFusedQubits (0 to 5; 0 disables fusion) are fused
+        // with their noise into one SuperOp. Null if the width is rejected.
+        fn compileNoisyCircuit(tape: &CircuitTape, model: &NoiseModel, maxFusedQubits: i32) -> UniquePtr<NoisyCircuit>;
+        fn applyNoisyCircuit(qureg: Pin<&mut Qureg>, circuit: &NoisyCircuit);
+        fn getNoisyCircuitNumSuperOps(circuit: &NoisyCircuit) -> usize;
+    }
+
     // Operations
     #[namespace = "quest_sys"]
     unsafe extern "C++" {
@@ -413,6 +639,51 @@ pub mod ffi {
         fn reportPauliStrSum(str: Pin<&mut PauliStrSum>);
     }
 
+    // Parameter sweeps
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("sweep.hpp");
+        type ParameterisedCircuit;
+
+        // Binds the angle of instruction instructions[i] to scale[i] * row[columns[i]]
+        fn createParameterisedCircuit(tape: &CircuitTape, instructions: &[u32], columns: &[u32], scales: &[f64]) -> UniquePtr<ParameterisedCircuit>;
+        fn getParameterisedCircuitNumColumns(circuit: &ParameterisedCircuit) -> u32;
+        fn applyParameterisedCircuit(qureg: Pin<&mut Qureg>, circuit: &ParameterisedCircuit, row: &[f64]);
+
+        // One expectation value per row of the row-major parameters; <= 0 workers picks automatically
+        fn runParameterSweep(initial: &Qureg, circuit: &ParameterisedCircuit, observable: &PauliStrSum, parameters: &[f64], numWorkers: i32) -> Vec<f64>;
+    }
+
+    // Pauli batches
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("pauli_batch.hpp");
+        type PauliStrSumBatch;
+
+        // Sums are copied in; results follow the order they were added. Adding
+        // returns the sum's index, or u32::MAX if it is rejected as non-Hermitian
+        fn createPauliStrSumBatch() -> UniquePtr<PauliStrSumBatch>;
+        fn addPauliStrSumToBatch(batch: Pin<&mut PauliStrSumBatch>, sum: &PauliStrSum) -> u32;
+        fn getPauliStrSumBatchNumGroups(batch: &PauliStrSumBatch) -> usize;
+        fn calcExpecPauliStrSums(qureg: &Qureg, batch: &PauliStrSumBatch) -> Vec<f64>;
+    }
+
+    // Pauli files
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("pauli_file.hpp");
+        // Parallel parser for QuEST's text format
+        fn loadPauliStrSumFile(path: String, isReversed: bool) -> UniquePtr<PauliStrSum>;
+        // The same parser split into chunks of about chunkBytes regardless of
+        // the core count, for tuning and testing
+        fn loadPauliStrSumFileInChunks(path: String, isReversed: bool, chunkBytes: u64) -> UniquePtr<PauliStrSum>;
+
+        // Native binary format, loaded straight from a memory map
+        fn savePauliStrSumBinary(sum: &PauliStrSum, path: String);
+        fn loadPauliStrSumBinary(path: String) -> UniquePtr<PauliStrSum>;
+        fn convertPauliStrSumFileToBinary(textPath: String, binaryPath: String, isReversed: bool);
+    }
+
     // Qureg
     #[namespace = "quest_sys"]
     unsafe extern "C++" {
@@ -438,10 +709,65 @@ pub mod ffi {
 
         // Qureg amplitude access
         fn getQuregAmps(qureg: Pin<&mut Qureg>, startInd: i64, numAmps: i64) -> Vec<Quest_Complex>;
+        fn getQuregAmpsInto(qureg: Pin<&mut Qureg>, startInd: i64, outAmps: &mut [Quest_Complex]);
+        fn getQuregAmpsView(qureg: &Qureg) -> &[Quest_Complex];
+        fn isQuregAmpsViewable(qureg: &Qureg) -> bool;
         fn getDensityQuregAmps_flatten(qureg: Pin<&mut Qureg>, startRow: i64, startCol: i64, numRows: i64, numCols: i64) -> Vec<Quest_Complex>;
+        fn getDensityQuregAmpsInto(qureg: Pin<&mut Qureg>, startRow: i64, startCol: i64, numRows: i64, numCols: i64, outAmps: &mut [Quest_Complex]);
+        fn getDensityQuregAmpsColMajorInto(qureg: Pin<&mut Qureg>, startRow: i64, startCol: i64, numRows: i64, numCols: i64, outAmps: &mut [Quest_Complex]);
         fn getQuregAmp(qureg: Pin<&mut Qureg>, index: i64) -> Quest_Complex;
         fn getDensityQuregAmp(qureg: Pin<&mut Qureg>, row: i64, column: i64) -> Quest_Complex;
     }
+
+    // Qureg pools
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("qureg_pool.hpp");
+        type QuregInit;
+        type QuregPool;
+        type PooledQureg;
+
+        // Handles return their register to the pool when dropped; see `qureg_init` for initialState
+        // Acquiring returns null if QuEST rejects the register
+        fn createQuregPool() -> UniquePtr<QuregPool>;
+        fn acquireQureg(pool: Pin<&mut QuregPool>, numQubits: i32, initialState: i32) -> UniquePtr<PooledQureg>;
+        fn acquireDensityQureg(pool: Pin<&mut QuregPool>, numQubits: i32, initialState: i32) -> UniquePtr<PooledQureg>;
+        fn acquireCustomQureg(pool: Pin<&mut QuregPool>, numQubits: i32, isDensMatr: i32, useDistrib: i32, useGpuAccel: i32, useMultithread: i32, initialState: i32) -> UniquePtr<PooledQureg>;
+        fn acquireCloneQureg(pool: Pin<&mut QuregPool>, qureg: &Qureg) -> UniquePtr<PooledQureg>;
+
+        fn getPooledQureg(handle: &PooledQureg) -> &Qureg;
+        fn getPooledQuregMut(handle: Pin<&mut PooledQureg>) -> Pin<&mut Qureg>;
+
+        fn getQuregPoolStats(pool: &QuregPool) -> QuregPoolStats;
+        fn clearQuregPool(pool: Pin<&mut QuregPool>);
+    }
+
+    // Trajectories
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("trajectory.hpp");
+        type TrajectoryResult;
+
+        // Samples are per trajectory and independent of numWorkers; <= 0 uses every core
+        fn runNoisyTrajectories(initial: &Qureg, tape: &CircuitTape, model: &NoiseModel, observable: &PauliStrSum, numTrajectories: u64, numWorkers: i32, seed: u64) -> UniquePtr<TrajectoryResult>;
+        fn getTrajectoryMean(result: &TrajectoryResult) -> f64;
+        fn getTrajectoryVariance(result: &TrajectoryResult) -> f64;
+        fn getTrajectoryStdError(result: &TrajectoryResult) -> f64;
+        fn getTrajectorySamples(result: &TrajectoryResult) -> &[f64];
+    }
+
+    // Trotter schedules
+    #[namespace = "quest_sys"]
+    unsafe extern "C++" {
+        include!("trotter.hpp");
+        type TrotterSchedule;
+
+        // Terms are reordered into blocks, so non-commuting sums give a different product formula of the same order
+        fn createTrotterSchedule(sum: &PauliStrSum, order: i32, reps: i32) -> UniquePtr<TrotterSchedule>;
+        fn applyTrotterSchedule(qureg: Pin<&mut Qureg>, schedule: Pin<&mut TrotterSchedule>, angle: f64);
+        fn getTrotterScheduleNumSweeps(schedule: &TrotterSchedule) -> i64;
+        fn getTrotterScheduleSweepsSaved(schedule: &TrotterSchedule) -> i64;
+    }
 }
 
 pub use ffi::*;
@@ -452,6 +778,58 @@ pub fn complex(re: f64, im: f64) -> Quest_Complex {
     Quest_Complex { re, im }
 }
 
+/// Opcodes for `createCircuitTape`, taken from the shared `GateKind` enum.
+///
+/// Qubits are listed controls first, then targets. Matrix parameters are
+/// row-major `(re, im)` pairs.
+pub mod gate_kind {
+    use super::GateKind;
+
+    pub const HADAMARD: u32 = GateKind::Hadamard.repr;
+    pub const PAULI_X: u32 = GateKind::PauliX.repr;
+    pub const PAULI_Y: u32 = GateKind::PauliY.repr;
+    pub const PAULI_Z: u32 = GateKind::PauliZ.repr;
+    pub const S: u32 = GateKind::S.repr;
+    pub const T: u32 = GateKind::T.repr;
+    pub const ROTATE_X: u32 = GateKind::RotateX.repr;
+    pub const ROTATE_Y: u32 = GateKind::RotateY.repr;
+    pub const ROTATE_Z: u32 = GateKind::RotateZ.repr;
+    pub const PHASE_SHIFT: u32 = GateKind::PhaseShift.repr;
+    pub const ROTATE_AROUND_AXIS: u32 = GateKind::RotateAroundAxis.repr;
+    pub const SWAP: u32 = GateKind::Swap.repr;
+    pub const SQRT_SWAP: u32 = GateKind::SqrtSwap.repr;
+    pub const CONTROLLED_HADAMARD: u32 = GateKind::ControlledHadamard.repr;
+    pub const CONTROLLED_PAULI_X: u32 = GateKind::ControlledPauliX.repr;
+    pub const CONTROLLED_PAULI_Y: u32 = GateKind::ControlledPauliY.repr;
+    pub const CONTROLLED_PAULI_Z: u32 = GateKind::ControlledPauliZ.repr;
+    pub const CONTROLLED_ROTATE_X: u32 = GateKind::ControlledRotateX.repr;
+    pub const CONTROLLED_ROTATE_Y: u32 = GateKind::ControlledRotateY.repr;
+    pub const CONTROLLED_ROTATE_Z: u32 = GateKind::ControlledRotateZ.repr;
+    pub const MULTI_QUBIT_PHASE_SHIFT: u32 = GateKind::MultiQubitPhaseShift.repr;
+    pub const MULTI_QUBIT_PHASE_FLIP: u32 = GateKind::MultiQubitPhaseFlip.repr;
+    pub const PHASE_GADGET: u32 = GateKind::PhaseGadget.repr;
+    pub const COMP_MATR_1: u32 = GateKind::CompMatr1.repr;
+    pub const COMP_MATR_2: u32 = GateKind::CompMatr2.repr;
+    pub const DIAG_MATR_1: u32 = GateKind::DiagMatr1.repr;
+    pub const DIAG_MATR_2: u32 = GateKind::DiagMatr2.repr;
+    pub const COMP_MATR: u32 = GateKind::CompMatr.repr;
+    pub const DIAG_MATR: u32 = GateKind::DiagMatr.repr;
+}
+
+/// Initial states for the `acquire*Qureg` pool functions, taken from the
+/// shared `QuregInit` enum.
+///
+/// Newly created registers already hold the zero state, so `ZERO` only
+/// reinitialises recycled ones. `KEEP` leaves whatever the previous holder
+/// left behind.
+pub mod qureg_init {
+    use super::QuregInit;
+
+    pub const KEEP: i32 = QuregInit::Keep.repr;
+    pub const BLANK: i32 = QuregInit::Blank.repr;
+    pub const ZERO: i32 = QuregInit::Zero.repr;
+}
+
 
 // Create a safe module with re-exports of commonly used functions
 pub mod safe {
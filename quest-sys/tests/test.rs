@@ -1,5 +1,7 @@
+use std::cell::RefCell;
+use std::ffi::{CStr, c_char};
 use std::f64::consts::PI;
-use std::sync::Once;
+use std::sync::{Mutex, MutexGuard, Once};
 use approx::assert_relative_eq;
 use quest_sys::*;
 
@@ -26,6 +28,23 @@ fn ensure_quest_env_initialized() {
     assert!(unsafe { QUEST_ENV_INITIALIZED }, "QuEST environment failed to initialize");
 }
 
+thread_local! {
+    static LAST_QUEST_ERROR: RefCell<Option<String>> = const { RefCell::new(None) };
+}
+
+// Overrides QuEST's default input error handler, which exits, so tests can
+// check that invalid input is rejected. Errors are recorded per thread.
+#[unsafe(no_mangle)]
+pub extern "C" fn invalidQuESTInputError(msg: *const c_char, _func: *const c_char) {
+    let msg = unsafe { CStr::from_ptr(msg) }.to_string_lossy().into_owned();
+    LAST_QUEST_ERROR.with(|last| *last.borrow_mut() = Some(msg));
+}
+
+// The message of the last input error raised on this thread, if any
+fn take_quest_error() -> Option<String> {
+    LAST_QUEST_ERROR.with(|last| last.borrow_mut().take())
+}
+
 // Function to be called at program exit to clean up QuEST
 extern "C" fn finalize_quest_at_exit() {
     println!("Finalizing QuEST environment...");
@@ -402,4 +421,1072 @@ fn test_utility_functions() {
 
     // These just test that the bindings don't crash
     assert!(true);
-}
\ No newline at end of file
+}
+
+#[test]
+fn test_get_qureg_amps_into_and_view() {
+    ensure_quest_env_initialized();
+
+    // Force a local CPU statevector so its amplitudes can be borrowed
+    let mut qureg = createCustomQureg(3, 0, 0, 0, 0);
+    initDebugState(qureg.pin_mut());
+
+    let copied = getQuregAmps(qureg.pin_mut(), 0, 8);
+
+    let mut out = vec![complex(0.0, 0.0); 5];
+    getQuregAmpsInto(qureg.pin_mut(), 2, &mut out);
+    for (i, amp) in out.iter().enumerate() {
+        assert_relative_eq!(amp.re, copied[i + 2].re);
+        assert_relative_eq!(amp.im, copied[i + 2].im);
+    }
+
+    let view = getQuregAmpsView(&qureg);
+    assert_eq!(view.len(), 8);
+    for (amp, expected) in view.iter().zip(copied.iter()) {
+        assert_relative_eq!(amp.re, expected.re);
+        assert_relative_eq!(amp.im, expected.im);
+    }
+
+    destroyQureg(qureg.pin_mut());
+}
+
+#[test]
+fn test_density_qureg_block_readout() {
+    ensure_quest_env_initialized();
+
+    let mut qureg = createDensityQureg(2);
+    initDebugState(qureg.pin_mut());
+
+    let (start_row, start_col, num_rows, num_cols) = (1, 0, 3, 2);
+
+    let mut row_major = vec![complex(0.0, 0.0); 6];
+    getDensityQuregAmpsInto(qureg.pin_mut(), start_row, start_col, num_rows, num_cols, &mut row_major);
+
+    let mut col_major = vec![complex(0.0, 0.0); 6];
+    getDensityQuregAmpsColMajorInto(qureg.pin_mut(), start_row, start_col, num_rows, num_cols, &mut col_major);
+
+    let flattened = getDensityQuregAmps_flatten(qureg.pin_mut(), start_row, start_col, num_rows, num_cols);
+
+    for r in 0..num_rows {
+        for c in 0..num_cols {
+            let expected = getDensityQuregAmp(qureg.pin_mut(), start_row + r, start_col + c);
+            let by_row = row_major[(r * num_cols + c) as usize];
+            let by_col = col_major[(c * num_rows + r) as usize];
+            let flat = flattened[(r * num_cols + c) as usize];
+            for amp in [by_row, by_col, flat] {
+                assert_relative_eq!(amp.re, expected.re);
+                assert_relative_eq!(amp.im, expected.im);
+            }
+        }
+    }
+
+    destroyQureg(qureg.pin_mut());
+}
+
+#[test]
+fn test_qureg_checkpoint_roundtrip() {
+    ensure_quest_env_initialized();
+
+    let path = std::env::temp_dir().join(format!("quest_sys_checkpoint_{}.qckpt", std::process::id()));
+    let path_str = path.to_string_lossy().to_string();
+
+    let mut qureg = createDensityQureg(3);
+    initDebugState(qureg.pin_mut());
+    saveQuregCheckpoint(qureg.pin_mut(), path_str.clone(), true);
+
+    let mut restored = createDensityQureg(3);
+    initZeroState(restored.pin_mut());
+    assert!(loadQuregCheckpoint(restored.pin_mut(), path_str.clone()));
+
+    let mut recreated = createQuregFromCheckpoint(path_str.clone());
+    assert!(!recreated.is_null());
+
+    for row in 0..8 {
+        for col in 0..8 {
+            let expected = getDensityQuregAmp(qureg.pin_mut(), row, col);
+            for amp in [
+                getDensityQuregAmp(restored.pin_mut(), row, col),
+                getDensityQuregAmp(recreated.pin_mut(), row, col),
+            ] {
+                assert_relative_eq!(amp.re, expected.re);
+                assert_relative_eq!(amp.im, expected.im);
+            }
+        }
+    }
+
+    // A payload that fails its checksum yields no register at all
+    let mut bytes = std::fs::read(&path).unwrap();
+    bytes[4096] ^= 0xFF;
+    std::fs::write(&path, &bytes).unwrap();
+    assert!(createQuregFromCheckpoint(path_str.clone()).is_null());
+    assert!(take_quest_error().is_some());
+    assert!(!loadQuregCheckpoint(restored.pin_mut(), path_str));
+    assert!(take_quest_error().is_some());
+
+    std::fs::remove_file(&path).ok();
+    destroyQureg(qureg.pin_mut());
+    destroyQureg(restored.pin_mut());
+    destroyQureg(recreated.pin_mut());
+}
+
+#[test]
+fn test_bulk_set_qureg_amps() {
+    ensure_quest_env_initialized();
+
+    let num_qubits = 12;
+    let num_amps = 1_i64 << num_qubits;
+    let mut qureg = createCustomQureg(num_qubits, 0, 0, 0, 0);
+    initZeroState(qureg.pin_mut());
+
+    let start = 5;
+    let amps: Vec<Quest_Complex> = (start..num_amps)
+        .map(|i| complex(i as f64, -(i as f64)))
+        .collect();
+    setQuregAmps(qureg.pin_mut(), start, &amps);
+
+    for i in 0..num_amps {
+        let amp = getQuregAmp(qureg.pin_mut(), i);
+        let expected = if i < start { 0.0 } else { i as f64 };
+        assert_relative_eq!(amp.re, expected);
+        assert_relative_eq!(amp.im, -expected);
+    }
+
+    destroyQureg(qureg.pin_mut());
+}
+
+#[test]
+fn test_circuit_tape_matches_direct_calls() {
+    ensure_quest_env_initialized();
+
+    let opcodes = [gate_kind::HADAMARD, gate_kind::CONTROLLED_PAULI_X, gate_kind::ROTATE_Y, gate_kind::CONTROLLED_ROTATE_Z];
+    let arities = [1, 2, 1, 3];
+    let qubits = [0, 0, 1, 2, 0, 1, 2];
+    let params = [0.3, 1.1];
+    let tape = createCircuitTape(&opcodes, &arities, &qubits, &params);
+    assert!(!tape.is_null());
+    assert_eq!(getCircuitTapeSize(&tape), 4);
+
+    let mut direct = createQureg(3);
+    initZeroState(direct.pin_mut());
+    applyHadamard(direct.pin_mut(), 0);
+    applyControlledPauliX(direct.pin_mut(), 0, 1);
+    applyRotateY(direct.pin_mut(), 2, 0.3);
+    applyMultiControlledRotateZ(direct.pin_mut(), &[0, 1], 2, 1.1);
+
+    // The same tape is replayed on several registers
+    for _ in 0..2 {
+        let mut qureg = createQureg(3);
+        initZeroState(qureg.pin_mut());
+        applyCircuitTape(qureg.pin_mut(), &tape);
+        for i in 0..8 {
+            let amp = getQuregAmp(qureg.pin_mut(), i);
+            let expected = getQuregAmp(direct.pin_mut(), i);
+            assert_relative_eq!(amp.re, expected.re, epsilon = 1e-12);
+            assert_relative_eq!(amp.im, expected.im, epsilon = 1e-12);
+        }
+        destroyQureg(qureg.pin_mut());
+    }
+
+    destroyQureg(direct.pin_mut());
+}
+
+#[test]
+fn test_fused_circuit_tape_matches_unfused() {
+    ensure_quest_env_initialized();
+
+    let opcodes = [
+        gate_kind::HADAMARD,
+        gate_kind::ROTATE_X,
+        gate_kind::CONTROLLED_PAULI_X,
+        gate_kind::ROTATE_Z,
+        gate_kind::CONTROLLED_PAULI_X,
+        gate_kind::T,
+        gate_kind::SWAP,
+        gate_kind::ROTATE_Y,
+    ];
+    let arities = [1, 1, 2, 1, 2, 1, 2, 1];
+    let qubits = [0, 1, 0, 1, 1, 1, 2, 2, 0, 3, 3];
+    let params = [0.4, -0.7, 1.3];
+    let tape = createCircuitTape(&opcodes, &arities, &qubits, &params);
+
+    for width in [2, 3] {
+        let fused = fuseCircuitTape(&tape, width);
+        assert!(!fused.is_null());
+        assert!(getCircuitTapeSize(&fused) < getCircuitTapeSize(&tape));
+
+        let mut expected = createQureg(4);
+        let mut actual = createQureg(4);
+        initPlusState(expected.pin_mut());
+        initPlusState(actual.pin_mut());
+        applyCircuitTape(expected.pin_mut(), &tape);
+        applyCircuitTape(actual.pin_mut(), &fused);
+
+        for i in 0..16 {
+            let a = getQuregAmp(actual.pin_mut(), i);
+            let e = getQuregAmp(expected.pin_mut(), i);
+            assert_relative_eq!(a.re, e.re, epsilon = 1e-12);
+            assert_relative_eq!(a.im, e.im, epsilon = 1e-12);
+        }
+        destroyQureg(expected.pin_mut());
+        destroyQureg(actual.pin_mut());
+    }
+}
+
+#[test]
+fn test_coalesced_diagonal_layer_matches_gates() {
+    ensure_quest_env_initialized();
+
+    // A QAOA-style cost layer followed by a mixer
+    let opcodes = [
+        gate_kind::PHASE_GADGET,
+        gate_kind::PHASE_GADGET,
+        gate_kind::ROTATE_Z,
+        gate_kind::MULTI_QUBIT_PHASE_SHIFT,
+        gate_kind::S,
+        gate_kind::T,
+        gate_kind::CONTROLLED_PAULI_Z,
+        gate_kind::ROTATE_X,
+    ];
+    let arities = [2, 2, 1, 2, 1, 1, 2, 1];
+    let qubits = [0, 1, 1, 2, 3, 0, 3, 2, 1, 2, 3, 0];
+    let params = [0.5, -0.25, 0.8, 1.2, 0.3];
+    let tape = createCircuitTape(&opcodes, &arities, &qubits, &params);
+
+    // The first width keeps a DiagMatr, the second forces a FullStateDiagMatr
+    for max_width in [4, 2] {
+        let coalesced = coalesceDiagonalGates(&tape, 4, max_width);
+        assert!(!coalesced.is_null());
+        assert_eq!(getCircuitTapeSize(&coalesced), 2);
+
+        let mut expected = createQureg(4);
+        let mut actual = createQureg(4);
+        initPlusState(expected.pin_mut());
+        initPlusState(actual.pin_mut());
+        applyCircuitTape(expected.pin_mut(), &tape);
+        applyCircuitTape(actual.pin_mut(), &coalesced);
+
+        for i in 0..16 {
+            let a = getQuregAmp(actual.pin_mut(), i);
+            let e = getQuregAmp(expected.pin_mut(), i);
+            assert_relative_eq!(a.re, e.re, epsilon = 1e-12);
+            assert_relative_eq!(a.im, e.im, epsilon = 1e-12);
+        }
+        destroyQureg(expected.pin_mut());
+        destroyQureg(actual.pin_mut());
+    }
+}
+
+#[test]
+fn test_tape_passes_accept_coalesced_full_state_diagonals() {
+    ensure_quest_env_initialized();
+
+    let opcodes = [gate_kind::HADAMARD, gate_kind::PHASE_GADGET, gate_kind::ROTATE_Z, gate_kind::ROTATE_X];
+    let arities = [1, 3, 1, 1];
+    let qubits = [0, 0, 1, 2, 2, 1];
+    let params = [0.7, -0.4, 0.9];
+    let tape = createCircuitTape(&opcodes, &arities, &qubits, &params);
+    let coalesced = coalesceDiagonalGates(&tape, 3, 1);
+    assert!(!coalesced.is_null());
+
+    // Passes over a coalesced tape copy its whole-register diagonal
+    let passes = [fuseCircuitTape(&coalesced, 2), coalesceDiagonalGates(&coalesced, 3, 1)];
+    let mut expected = createQureg(3);
+    initPlusState(expected.pin_mut());
+    applyCircuitTape(expected.pin_mut(), &tape);
+    for pass in &passes {
+        assert!(!pass.is_null());
+        let mut actual = createQureg(3);
+        initPlusState(actual.pin_mut());
+        applyCircuitTape(actual.pin_mut(), pass);
+        for i in 0..8 {
+            let a = getQuregAmp(actual.pin_mut(), i);
+            let e = getQuregAmp(expected.pin_mut(), i);
+            assert_relative_eq!(a.re, e.re, epsilon = 1e-12);
+            assert_relative_eq!(a.im, e.im, epsilon = 1e-12);
+        }
+        destroyQureg(actual.pin_mut());
+    }
+    destroyQureg(expected.pin_mut());
+}
+
+#[test]
+fn test_coalesced_full_state_diagonal_follows_register_deployment() {
+    ensure_quest_env_initialized();
+
+    let opcodes = [gate_kind::HADAMARD, gate_kind::PHASE_GADGET, gate_kind::ROTATE_Z];
+    let tape = createCircuitTape(&opcodes, &[1, 3, 1], &[0, 0, 1, 2, 1], &[0.7, -0.4]);
+    let coalesced = coalesceDiagonalGates(&tape, 3, 1);
+
+    // A local, single-threaded worker like those of trajectory and sweep runs,
+    // whatever the environment's deployment
+    let mut expected = createQureg(3);
+    initPlusState(expected.pin_mut());
+    applyCircuitTape(expected.pin_mut(), &tape);
+    for _ in 0..2 {
+        let mut local = createCustomQureg(3, 0, 0, 0, 0);
+        initPlusState(local.pin_mut());
+        applyCircuitTape(local.pin_mut(), &coalesced);
+        for i in 0..8 {
+            let a = getQuregAmp(local.pin_mut(), i);
+            let e = getQuregAmp(expected.pin_mut(), i);
+            assert_relative_eq!(a.re, e.re, epsilon = 1e-12);
+            assert_relative_eq!(a.im, e.im, epsilon = 1e-12);
+        }
+        destroyQureg(local.pin_mut());
+    }
+    destroyQureg(expected.pin_mut());
+}
+
+#[test]
+fn test_matrix_pool_recycles_by_shape() {
+    ensure_quest_env_initialized();
+
+    let mut pool = createMatrixPool();
+    assert_eq!(getMatrixPoolNumIdle(&pool), 0);
+
+    let mut qureg = createQureg(2);
+    initPlusState(qureg.pin_mut());
+    for _ in 0..3 {
+        let mut diag = acquireDiagMatr(pool.pin_mut(), 1);
+        setDiagMatr(getPooledDiagMatrMut(diag.pin_mut()), &[complex(1.0, 0.0), complex(-1.0, 0.0)]);
+        applyDiagMatr(qureg.pin_mut(), &[0], getPooledDiagMatr(&diag));
+        drop(diag);
+        // The released matrix is shelved rather than destroyed
+        assert_eq!(getMatrixPoolNumIdle(&pool), 1);
+    }
+
+    let first = acquireCompMatr(pool.pin_mut(), 2);
+    let second = acquireCompMatr(pool.pin_mut(), 2);
+    drop(first);
+    drop(second);
+    assert_eq!(getMatrixPoolNumIdle(&pool), 3);
+
+    // A rejected matrix is never handed out, so it never reaches the shelf
+    assert!(acquireDiagMatr(pool.pin_mut(), 0).is_null());
+    assert!(take_quest_error().is_some());
+    assert_eq!(getMatrixPoolNumIdle(&pool), 3);
+
+    clearMatrixPool(pool.pin_mut());
+    assert_eq!(getMatrixPoolNumIdle(&pool), 0);
+    destroyQureg(qureg.pin_mut());
+}
+
+#[test]
+fn test_qureg_pool_recycles_by_shape() {
+    ensure_quest_env_initialized();
+
+    let mut pool = createQuregPool();
+    let mut first = acquireQureg(pool.pin_mut(), 2, qureg_init::ZERO);
+    let second = acquireQureg(pool.pin_mut(), 2, qureg_init::ZERO);
+    applyPauliX(getPooledQuregMut(first.pin_mut()), 0);
+    // The modified register is shelved last, so it is the next one handed out
+    drop(second);
+    drop(first);
+
+    let stats = getQuregPoolStats(&pool);
+    assert_eq!(stats.in_use, 0);
+    assert_eq!(stats.idle, 2);
+    assert_eq!(stats.high_water_mark, 2);
+    assert_eq!(stats.created, 2);
+
+    // A reused register is reset even though its last holder left |01>
+    for _ in 0..2 {
+        let mut reused = acquireQureg(pool.pin_mut(), 2, qureg_init::ZERO);
+        let amp = getQuregAmp(getPooledQuregMut(reused.pin_mut()), 0);
+        assert_relative_eq!(amp.re, 1.0);
+    }
+
+    // A different shape is never served from the statevector shelf
+    let rho = acquireDensityQureg(pool.pin_mut(), 2, qureg_init::ZERO);
+    let clone = acquireCloneQureg(pool.pin_mut(), getPooledQureg(&rho));
+    assert_relative_eq!(calcTotalProb(getPooledQureg(&clone)), 1.0);
+    drop(rho);
+    drop(clone);
+
+    let stats = getQuregPoolStats(&pool);
+    assert_eq!(stats.created, 4);
+    assert_eq!(stats.reused, 2);
+    assert_eq!(stats.idle, 4);
+    assert!(stats.idle_bytes > 0);
+
+    clearQuregPool(pool.pin_mut());
+    let stats = getQuregPoolStats(&pool);
+    assert_eq!(stats.idle, 0);
+    assert_eq!(stats.idle_bytes, 0);
+
+    // A rejected register is neither lent out nor counted
+    assert!(acquireQureg(pool.pin_mut(), 0, qureg_init::ZERO).is_null());
+    assert!(take_quest_error().is_some());
+    assert_eq!(getQuregPoolStats(&pool).created, 4);
+}
+
+#[test]
+fn test_flat_matrix_and_density_setters() {
+    ensure_quest_env_initialized();
+
+    // Pauli X, row-major
+    let x = [complex(0.0, 0.0), complex(1.0, 0.0), complex(1.0, 0.0), complex(0.0, 0.0)];
+    let mut dense = createCompMatr(1);
+    setCompMatrFlat(dense.pin_mut(), &x, 2);
+    let small = getCompMatr1Flat(&x);
+
+    let mut a = createQureg(1);
+    let mut b = createQureg(1);
+    initZeroState(a.pin_mut());
+    initZeroState(b.pin_mut());
+    applyCompMatr(a.pin_mut(), &[0], &dense);
+    applyCompMatr1(b.pin_mut(), 0, &small);
+    for qureg in [&mut a, &mut b] {
+        let amp = getQuregAmp(qureg.pin_mut(), 1);
+        assert_relative_eq!(amp.re, 1.0);
+    }
+
+    // A 2x3 row-major block written into a 2-qubit density matrix
+    let mut rho = createDensityQureg(2);
+    initBlankState(rho.pin_mut());
+    let block: Vec<Quest_Complex> = (0..6).map(|i| complex(i as f64, 0.5 * i as f64)).collect();
+    setDensityQuregAmpsFlat(rho.pin_mut(), 1, 0, 2, 3, &block);
+    for r in 0..2 {
+        for c in 0..3 {
+            let amp = getDensityQuregAmp(rho.pin_mut(), 1 + r, c);
+            let expected = block[(r * 3 + c) as usize];
+            assert_relative_eq!(amp.re, expected.re);
+            assert_relative_eq!(amp.im, expected.im);
+        }
+    }
+
+    destroyCompMatr(dense.pin_mut());
+    destroyQureg(a.pin_mut());
+    destroyQureg(b.pin_mut());
+    destroyQureg(rho.pin_mut());
+}
+
+#[test]
+fn test_flat_kraus_map_and_superop() {
+    ensure_quest_env_initialized();
+
+    // Amplitude damping with probability p, as two row-major 2x2 operators
+    let p: f64 = 0.3;
+    let zero = complex(0.0, 0.0);
+    let kraus = [
+        complex(1.0, 0.0), zero, zero, complex((1.0 - p).sqrt(), 0.0),
+        zero, complex(p.sqrt(), 0.0), zero, zero,
+    ];
+    let mut map = createInlineKrausMapFlat(1, 2, &kraus);
+
+    let mut expected = createDensityQureg(2);
+    let mut actual = createDensityQureg(2);
+    initPlusState(expected.pin_mut());
+    initPlusState(actual.pin_mut());
+    mixDamping(expected.pin_mut(), 1, p);
+    mixKrausMap(actual.pin_mut(), &[1], &map);
+
+    // The identity superoperator must leave the state untouched
+    let identity: Vec<Quest_Complex> = (0..16)
+        .map(|i| if i % 5 == 0 { complex(1.0, 0.0) } else { zero })
+        .collect();
+    let mut superop = createInlineSuperOpFlat(1, &identity);
+    applySuperOp(actual.pin_mut(), &[0], &superop);
+
+    for row in 0..4 {
+        for col in 0..4 {
+            let a = getDensityQuregAmp(actual.pin_mut(), row, col);
+            let e = getDensityQuregAmp(expected.pin_mut(), row, col);
+            assert_relative_eq!(a.re, e.re, epsilon = 1e-12);
+            assert_relative_eq!(a.im, e.im, epsilon = 1e-12);
+        }
+    }
+
+    destroyKrausMap(map.pin_mut());
+    destroySuperOp(superop.pin_mut());
+    destroyQureg(expected.pin_mut());
+    destroyQureg(actual.pin_mut());
+}
+
+#[test]
+fn test_channel_cache_deduplicates_channels() {
+    ensure_quest_env_initialized();
+
+    let p: f64 = 0.2;
+    let zero = complex(0.0, 0.0);
+    let damping = |p: f64| {
+        vec![
+            complex(1.0, 0.0), zero, zero, complex((1.0 - p).sqrt(), 0.0),
+            zero, complex(p.sqrt(), 0.0), zero, zero,
+        ]
+    };
+
+    let mut cache = createChannelCache();
+    let first = cacheKrausMap(cache.pin_mut(), 1, 2, &damping(p));
+    let again = cacheKrausMap(cache.pin_mut(), 1, 2, &damping(p));
+    let other = cacheKrausMap(cache.pin_mut(), 1, 2, &damping(0.5));
+    assert_ne!(first, 0);
+    assert_eq!(first, again);
+    assert_ne!(first, other);
+    assert_eq!(getChannelCacheNumEntries(&cache), 2);
+    let bytes = getChannelCacheBytes(&cache);
+    assert!(bytes > 0);
+
+    let mut expected = createDensityQureg(1);
+    let mut via_map = createDensityQureg(1);
+    let mut via_superop = createDensityQureg(1);
+    for qureg in [&mut expected, &mut via_map, &mut via_superop] {
+        initPlusState(qureg.pin_mut());
+    }
+    mixDamping(expected.pin_mut(), 0, p);
+    mixKrausMap(via_map.pin_mut(), &[0], getCachedKrausMap(&cache, first));
+    applySuperOp(via_superop.pin_mut(), &[0], getCachedSuperOp(&cache, first));
+    for row in 0..2 {
+        for col in 0..2 {
+            let e = getDensityQuregAmp(expected.pin_mut(), row, col);
+            for qureg in [&mut via_map, &mut via_superop] {
+                let a = getDensityQuregAmp(qureg.pin_mut(), row, col);
+                assert_relative_eq!(a.re, e.re, epsilon = 1e-12);
+                assert_relative_eq!(a.im, e.im, epsilon = 1e-12);
+            }
+        }
+    }
+
+    assert!(evictCachedChannel(cache.pin_mut(), other));
+    assert!(!evictCachedChannel(cache.pin_mut(), other));
+    assert_eq!(getChannelCacheNumEntries(&cache), 1);
+    assert_eq!(getChannelCacheBytes(&cache), bytes / 2);
+    clearChannelCache(cache.pin_mut());
+    assert_eq!(getChannelCacheBytes(&cache), 0);
+
+    destroyQureg(expected.pin_mut());
+    destroyQureg(via_map.pin_mut());
+    destroyQureg(via_superop.pin_mut());
+}
+
+#[test]
+fn test_noisy_circuit_matches_manual_channels() {
+    ensure_quest_env_initialized();
+
+    let opcodes = [gate_kind::HADAMARD, gate_kind::CONTROLLED_PAULI_X, gate_kind::ROTATE_X];
+    let arities = [1, 2, 1];
+    let qubits = [0, 0, 1, 1];
+    let params = [0.4];
+    let tape = createCircuitTape(&opcodes, &arities, &qubits, &params);
+
+    let mut model = createNoiseModel();
+    let dephasing = addDephasingChannel(model.pin_mut(), 0.05);
+    let depolarising = addTwoQubitDepolarisingChannel(model.pin_mut(), 0.1);
+    let damping = addDampingChannel(model.pin_mut(), 0.2);
+    addNoiseRule(model.pin_mut(), gate_kind::HADAMARD, &[], dephasing);
+    addNoiseRule(model.pin_mut(), gate_kind::CONTROLLED_PAULI_X, &[0, 1], depolarising);
+    addNoiseRule(model.pin_mut(), gate_kind::ROTATE_X, &[0], damping);
+
+    let mut expected = createDensityQureg(2);
+    initZeroState(expected.pin_mut());
+    applyHadamard(expected.pin_mut(), 0);
+    mixDephasing(expected.pin_mut(), 0, 0.05);
+    applyControlledPauliX(expected.pin_mut(), 0, 1);
+    mixTwoQubitDepolarising(expected.pin_mut(), 0, 1, 0.1);
+    applyRotateX(expected.pin_mut(), 1, 0.4);
+
+    for (max_fused, num_superops) in [(2, 2), (0, 0)] {
+        let circuit = compileNoisyCircuit(&tape, &model, max_fused);
+        assert_eq!(getNoisyCircuitNumSuperOps(&circuit), num_superops);
+
+        let mut qureg = createDensityQureg(2);
+        initZeroState(qureg.pin_mut());
+        applyNoisyCircuit(qureg.pin_mut(), &circuit);
+        for row in 0..4 {
+            for col in 0..4 {
+                let e = getDensityQuregAmp(expected.pin_mut(), row, col);
+                let a = getDensityQuregAmp(qureg.pin_mut(), row, col);
+                assert_relative_eq!(a.re, e.re, epsilon = 1e-12);
+                assert_relative_eq!(a.im, e.im, epsilon = 1e-12);
+            }
+        }
+        destroyQureg(qureg.pin_mut());
+    }
+
+    destroyQureg(expected.pin_mut());
+}
+
+#[test]
+fn test_noisy_circuit_rejects_wide_fusion() {
+    ensure_quest_env_initialized();
+
+    let tape = createCircuitTape(&[gate_kind::HADAMARD], &[1], &[0], &[]);
+    let model = createNoiseModel();
+    for width in [-1, 6, i32::MAX] {
+        assert!(compileNoisyCircuit(&tape, &model, width).is_null());
+        assert!(take_quest_error().is_some());
+    }
+    assert!(!compileNoisyCircuit(&tape, &model, 5).is_null());
+    assert!(take_quest_error().is_none());
+}
+
+#[test]
+fn test_noisy_trajectories_converge_to_density_matrix() {
+    ensure_quest_env_initialized();
+
+    let opcodes = [gate_kind::HADAMARD, gate_kind::CONTROLLED_PAULI_X];
+    let tape = createCircuitTape(&opcodes, &[1, 2], &[0, 0, 1], &[]);
+    let mut model = createNoiseModel();
+    let depolarising = addDepolarisingChannel(model.pin_mut(), 0.1);
+    let damping = addDampingChannel(model.pin_mut(), 0.3);
+    addNoiseRule(model.pin_mut(), gate_kind::HADAMARD, &[], depolarising);
+    addNoiseRule(model.pin_mut(), gate_kind::CONTROLLED_PAULI_X, &[], damping);
+    let mut observable = createInlinePauliStrSum("1 ZZ\n0.5 IX\n-0.25 ZI".to_string());
+
+    let mut rho = createDensityQureg(2);
+    initZeroState(rho.pin_mut());
+    applyNoisyCircuit(rho.pin_mut(), &compileNoisyCircuit(&tape, &model, 0));
+    let exact = calcExpecPauliStrSum(&rho, &observable);
+
+    let mut psi = createQureg(2);
+    initZeroState(psi.pin_mut());
+    let parallel = runNoisyTrajectories(&psi, &tape, &model, &observable, 4000, 4, 7);
+    let serial = runNoisyTrajectories(&psi, &tape, &model, &observable, 4000, 1, 7);
+    assert_eq!(getTrajectorySamples(&parallel), getTrajectorySamples(&serial));
+
+    let mean = getTrajectoryMean(&parallel);
+    let error = getTrajectoryStdError(&parallel);
+    assert!(error > 0.0);
+    assert_relative_eq!(error, (getTrajectoryVariance(&parallel) / 4000.0).sqrt());
+    assert!((mean - exact).abs() < 5.0 * error, "mean {mean} exact {exact} error {error}");
+
+    destroyPauliStrSum(observable.pin_mut());
+    destroyQureg(rho.pin_mut());
+    destroyQureg(psi.pin_mut());
+}
+
+#[test]
+fn test_parameter_sweep_matches_serial_evaluation() {
+    ensure_quest_env_initialized();
+
+    let opcodes = [gate_kind::ROTATE_X, gate_kind::CONTROLLED_PAULI_X, gate_kind::ROTATE_Y, gate_kind::ROTATE_Z];
+    let tape = createCircuitTape(&opcodes, &[1, 2, 1, 1], &[0, 0, 1, 1, 2], &[0.0, 0.0, 0.7]);
+    // Columns 0 and 1; the last rotation keeps its angle from the tape
+    let circuit = createParameterisedCircuit(&tape, &[0, 2], &[0, 1], &[1.0, 0.5]);
+    assert!(!circuit.is_null());
+    assert_eq!(getParameterisedCircuitNumColumns(&circuit), 2);
+    let mut observable = createInlinePauliStrSum("1 ZZI\n0.5 IXI\n-0.25 YIZ".to_string());
+
+    let mut initial = createQureg(3);
+    initZeroState(initial.pin_mut());
+    let parameters: Vec<f64> = (0..64).flat_map(|i| [0.1 * i as f64, 0.2 - 0.05 * i as f64]).collect();
+    let parallel = runParameterSweep(&initial, &circuit, &observable, &parameters, 4);
+    let serial = runParameterSweep(&initial, &circuit, &observable, &parameters, 1);
+    assert_eq!(parallel.len(), 64);
+    assert_eq!(parallel, serial);
+
+    for (row, value) in parameters.chunks(2).zip(&parallel) {
+        let mut qureg = createQureg(3);
+        initZeroState(qureg.pin_mut());
+        applyRotateX(qureg.pin_mut(), 0, row[0]);
+        applyControlledPauliX(qureg.pin_mut(), 0, 1);
+        applyRotateY(qureg.pin_mut(), 1, 0.5 * row[1]);
+        applyRotateZ(qureg.pin_mut(), 2, 0.7);
+        assert_relative_eq!(*value, calcExpecPauliStrSum(&qureg, &observable), epsilon = 1e-12);
+
+        initZeroState(qureg.pin_mut());
+        applyParameterisedCircuit(qureg.pin_mut(), &circuit, row);
+        assert_relative_eq!(*value, calcExpecPauliStrSum(&qureg, &observable), epsilon = 1e-12);
+        destroyQureg(qureg.pin_mut());
+    }
+
+    destroyPauliStrSum(observable.pin_mut());
+    destroyQureg(initial.pin_mut());
+}
+
+#[test]
+fn test_adjoint_and_parameter_shift_gradients_agree() {
+    ensure_quest_env_initialized();
+
+    let opcodes = [
+        gate_kind::HADAMARD,
+        gate_kind::ROTATE_X,
+        gate_kind::CONTROLLED_ROTATE_Y,
+        gate_kind::T,
+        gate_kind::PHASE_SHIFT,
+        gate_kind::CONTROLLED_PAULI_X,
+        gate_kind::ROTATE_Z,
+    ];
+    let qubits = [0, 1, 0, 2, 2, 1, 2, 0, 0];
+    let tape = createCircuitTape(&opcodes, &[1, 1, 2, 1, 1, 2, 1], &qubits, &[0.0, 0.0, 0.0, 0.0]);
+    // Column 0 drives two angles, so its gradient sums both contributions
+    let circuit = createParameterisedCircuit(&tape, &[1, 2, 4, 6], &[0, 1, 0, 2], &[1.0, 1.0, -2.0, 0.5]);
+    let gradients = createDifferentiableCircuit(&circuit);
+    let mut observable = createInlinePauliStrSum("1 ZZI\n0.5 IXY\n-0.25 YIZ".to_string());
+
+    let mut initial = createQureg(3);
+    initZeroState(initial.pin_mut());
+    let row = [0.4, -0.9, 1.3];
+    let adjoint = calcAdjointGradient(&initial, &gradients, &observable, &row);
+    let shifted = calcParameterShiftGradient(&initial, &gradients, &observable, &row, 0);
+    assert_eq!(adjoint.len(), 3);
+    assert_eq!(shifted.len(), 3);
+
+    let step = 1e-6;
+    for c in 0..3 {
+        let mut rows = [row, row];
+        rows[0][c] += step;
+        rows[1][c] -= step;
+        let values = runParameterSweep(&initial, &circuit, &observable, &rows.concat(), 1);
+        let central = (values[0] - values[1]) / (2.0 * step);
+        assert_relative_eq!(adjoint[c], shifted[c], epsilon = 1e-10);
+        assert_relative_eq!(adjoint[c], central, epsilon = 1e-6);
+    }
+
+    destroyPauliStrSum(observable.pin_mut());
+    destroyQureg(initial.pin_mut());
+}
+
+// Serialises the tests that read or change QuEST's global seeds, and puts
+// back the seeds found on entry when the test ends, even by panicking
+static SEED_LOCK: Mutex<()> = Mutex::new(());
+
+struct SeedGuard {
+    previous: Vec<u32>,
+    _lock: MutexGuard<'static, ()>,
+}
+
+impl SeedGuard {
+    fn new() -> Self {
+        let lock = SEED_LOCK.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+        Self { previous: getSeeds(), _lock: lock }
+    }
+}
+
+impl Drop for SeedGuard {
+    fn drop(&mut self) {
+        setSeeds(&self.previous);
+    }
+}
+
+#[test]
+fn test_sampling_follows_global_seeds() {
+    ensure_quest_env_initialized();
+    let _seeds = SeedGuard::new();
+
+    let mut qureg = createQureg(3);
+    initPlusState(qureg.pin_mut());
+    let qubits = [0, 1, 2];
+
+    setSeeds(&[7, 8, 9]);
+    assert_eq!(getSeeds(), vec![7, 8, 9]);
+    let shots = sampleMultiQubitOutcomes(&qureg, &qubits, 2000, 11);
+    assert_eq!(shots, sampleMultiQubitOutcomes(&qureg, &qubits, 2000, 11));
+
+    // Other global seeds give other shots for the same per-call seed, and
+    // returning to the first seeds reproduces them
+    setSeeds(&[7, 8, 10]);
+    assert_eq!(getSeeds(), vec![7, 8, 10]);
+    assert_ne!(shots, sampleMultiQubitOutcomes(&qureg, &qubits, 2000, 11));
+    setSeeds(&[7, 8, 9]);
+    assert_eq!(shots, sampleMultiQubitOutcomes(&qureg, &qubits, 2000, 11));
+
+    destroyQureg(qureg.pin_mut());
+}
+
+#[test]
+fn test_sample_multi_qubit_outcomes() {
+    ensure_quest_env_initialized();
+    let _seeds = SeedGuard::new();
+
+    // P(00) = 1/2, P(01) = 0, P(10) = P(11) = 1/4 over qubits [0, 2]
+    let mut qureg = createQureg(3);
+    initZeroState(qureg.pin_mut());
+    applyHadamard(qureg.pin_mut(), 2);
+    applyControlledHadamard(qureg.pin_mut(), 2, 0);
+    let qubits = [0, 2];
+    let expected = [0.5, 0.0, 0.25, 0.25];
+
+    // Only the per-call seed varies here; the global seeds are held still by
+    // the guard above
+    let num_shots = 200_000_u64;
+    let shots = sampleMultiQubitOutcomes(&qureg, &qubits, num_shots, 11);
+    assert_eq!(shots.len(), num_shots as usize);
+    assert_eq!(shots, sampleMultiQubitOutcomes(&qureg, &qubits, num_shots, 11));
+    assert_ne!(shots, sampleMultiQubitOutcomes(&qureg, &qubits, num_shots, 12));
+
+    let mut counts = [0_u64; 4];
+    sampleMultiQubitOutcomeCounts(&mut counts, &qureg, &qubits, num_shots, 11);
+    assert_eq!(counts.iter().sum::<u64>(), num_shots);
+    for (outcome, prob) in expected.iter().enumerate() {
+        let hits = shots.iter().filter(|&&s| s == outcome as i64).count() as f64;
+        assert_relative_eq!(hits / num_shots as f64, prob, epsilon = 0.01);
+        assert_relative_eq!(counts[outcome] as f64 / num_shots as f64, prob, epsilon = 0.01);
+    }
+
+    destroyQureg(qureg.pin_mut());
+}
+
+#[test]
+fn test_batched_pauli_str_sum_expectations() {
+    ensure_quest_env_initialized();
+
+    let mut sums = [
+        createInlinePauliStrSum("0.5 ZZI\n-1.5 XXY\n0.25 IYZ".to_string()),
+        createInlinePauliStrSum("1 XXZ\n2 ZII\n-0.75 IXI".to_string()),
+        createInlinePauliStrSum("0.3 YXY\n0.6 IIZ".to_string()),
+    ];
+    let mut batch = createPauliStrSumBatch();
+    for (i, sum) in sums.iter().enumerate() {
+        assert_eq!(addPauliStrSumToBatch(batch.pin_mut(), sum), i as u32);
+    }
+
+    // A non-Hermitian sum is refused with a sentinel no valid index can take
+    let path = std::env::temp_dir().join(format!("quest_sys_batch_{}.txt", std::process::id()));
+    std::fs::write(&path, "0.5 ZZI\n2i XII\n").unwrap();
+    let mut complex = loadPauliStrSumFile(path.to_string_lossy().to_string(), false);
+    assert_eq!(addPauliStrSumToBatch(batch.pin_mut(), &complex), u32::MAX);
+    assert!(take_quest_error().is_some());
+    destroyPauliStrSum(complex.pin_mut());
+    std::fs::remove_file(&path).ok();
+
+    // Flip masks: {ZZI, ZII, IIZ}, {XXY, YXY}, {IYZ, IXI} and {XXZ}
+    assert_eq!(getPauliStrSumBatchNumGroups(&batch), 4);
+
+    let mut qureg = createQureg(3);
+    initRandomPureState(qureg.pin_mut());
+    let mut rho = createDensityQureg(3);
+    initRandomMixedState(rho.pin_mut(), 4);
+    for state in [&qureg, &rho] {
+        let values = calcExpecPauliStrSums(state, &batch);
+        assert_eq!(values.len(), sums.len());
+        for (value, sum) in values.iter().zip(sums.iter()) {
+            assert_relative_eq!(*value, calcExpecPauliStrSum(state, sum), epsilon = 1e-12);
+        }
+    }
+
+    for sum in sums.iter_mut() {
+        destroyPauliStrSum(sum.pin_mut());
+    }
+    destroyQureg(qureg.pin_mut());
+    destroyQureg(rho.pin_mut());
+}
+
+#[test]
+fn test_analysed_hamiltonian_groups_commuting_terms() {
+    ensure_quest_env_initialized();
+
+    let mut sum = createInlinePauliStrSum(
+        "0.5 III\n1.0 ZZI\n-0.7 ZIZ\n0.4 XXI\n0.3 IXX\n0.2 YIY\n-0.1 XYZ".to_string(),
+    );
+    let ham = createAnalysedHamiltonian(&sum);
+    // {ZZI, ZIZ}, {XXI, IXX}, {YIY} and {XYZ}; the identity needs no group
+    assert_eq!(getAnalysedHamiltonianNumGroups(&ham), 4);
+    assert_eq!(getAnalysedHamiltonianGroupQubits(&ham, 0), &[0, 1, 2]);
+
+    for is_density in [false, true] {
+        let (mut qureg, mut workspace) = if is_density {
+            (createDensityQureg(3), createDensityQureg(3))
+        } else {
+            (createQureg(3), createQureg(3))
+        };
+        initRandomPureState(qureg.pin_mut());
+        let value = calcExpecAnalysedHamiltonian(&qureg, &ham, workspace.pin_mut());
+        assert_relative_eq!(value, calcExpecPauliStrSum(&qureg, &sum), epsilon = 1e-12);
+        destroyQureg(qureg.pin_mut());
+        destroyQureg(workspace.pin_mut());
+    }
+
+    let mut counts = [0_u64; 4];
+    allocateAnalysedHamiltonianShots(&mut counts, &ham, 1000);
+    assert_eq!(counts.iter().sum::<u64>(), 1000);
+    assert!(counts[0] > counts[3]);
+
+    destroyPauliStrSum(sum.pin_mut());
+}
+
+#[test]
+fn test_pauli_str_sum_file_loaders() {
+    ensure_quest_env_initialized();
+
+    let dir = std::env::temp_dir();
+    let text = dir.join(format!("quest_sys_paulis_{}.txt", std::process::id()));
+    let binary = dir.join(format!("quest_sys_paulis_{}.qpauli", std::process::id()));
+    let text_str = text.to_string_lossy().to_string();
+    let binary_str = binary.to_string_lossy().to_string();
+    std::fs::write(&text, "0.5 XYZ\n-1.25e-1 ZZI\n\n2 IXY\n0.75 YYX\n").unwrap();
+
+    let mut qureg = createQureg(3);
+    initRandomPureState(qureg.pin_mut());
+
+    for reversed in [false, true] {
+        let mut reference = if reversed {
+            createPauliStrSumFromReversedFile(text_str.clone())
+        } else {
+            createPauliStrSumFromFile(text_str.clone())
+        };
+        let mut parsed = loadPauliStrSumFile(text_str.clone(), reversed);
+        convertPauliStrSumFileToBinary(text_str.clone(), binary_str.clone(), reversed);
+        let mut mapped = loadPauliStrSumBinary(binary_str.clone());
+
+        let expected = calcExpecPauliStrSum(&qureg, &reference);
+        for sum in [&parsed, &mapped] {
+            assert_relative_eq!(calcExpecPauliStrSum(&qureg, sum), expected, epsilon = 1e-12);
+        }
+        for sum in [&mut reference, &mut parsed, &mut mapped] {
+            destroyPauliStrSum(sum.pin_mut());
+        }
+    }
+
+    std::fs::remove_file(&text).ok();
+    std::fs::remove_file(&binary).ok();
+    destroyQureg(qureg.pin_mut());
+}
+
+#[test]
+fn test_pauli_str_sum_file_parses_in_chunks() {
+    ensure_quest_env_initialized();
+
+    let path = std::env::temp_dir().join(format!("quest_sys_chunked_{}.txt", std::process::id()));
+    let path_str = path.to_string_lossy().to_string();
+    let paulis = ["XYZ", "ZZI", "IXY", "YYX", "ZIZ"];
+    let lines: Vec<String> = (0..40)
+        .map(|i| if i == 9 { String::new() } else { format!("{} {}", 0.05 * (i as f64 - 17.0), paulis[i % 5]) })
+        .collect();
+    std::fs::write(&path, lines.join("\n") + "\n").unwrap();
+
+    let mut qureg = createQureg(3);
+    initRandomPureState(qureg.pin_mut());
+    let mut reference = createPauliStrSumFromFile(path_str.clone());
+    let expected = calcExpecPauliStrSum(&qureg, &reference);
+
+    // Down to one line per chunk, so every chunk boundary is exercised
+    for chunk_bytes in [1, 7, 64] {
+        let mut parsed = loadPauliStrSumFileInChunks(path_str.clone(), false, chunk_bytes);
+        assert_relative_eq!(calcExpecPauliStrSum(&qureg, &parsed), expected, epsilon = 1e-12);
+        destroyPauliStrSum(parsed.pin_mut());
+    }
+
+    // Errors in a late chunk report the offending line of the whole file,
+    // whether the line is unreadable or has a different number of Paulis
+    for (line, bad) in [(31, "0.5 XYQ"), (33, "1 XXXX")] {
+        let mut broken = lines.clone();
+        broken[line - 1] = bad.to_string();
+        std::fs::write(&path, broken.join("\n") + "\n").unwrap();
+        for chunk_bytes in [1, 7, 64, 1 << 20] {
+            assert!(loadPauliStrSumFileInChunks(path_str.clone(), false, chunk_bytes).is_null());
+            let message = take_quest_error().expect("the broken line is reported");
+            assert!(message.contains(&format!("line {line} ")), "{message}");
+        }
+    }
+
+    std::fs::remove_file(&path).ok();
+    destroyPauliStrSum(reference.pin_mut());
+    destroyQureg(qureg.pin_mut());
+}
+
+#[test]
+fn test_trotter_schedule_matches_quest() {
+    ensure_quest_env_initialized();
+
+    // Mutually commuting terms, so any ordering is exact and must agree
+    let mut sum = createInlinePauliStrSum(
+        "0.4 ZZI\n-0.3 IZZ\n0.2 ZIZ\n0.5 III\n0.7 XXX\n-0.6 YYX\n0.1 ZZI".to_string(),
+    );
+    for (order, reps) in [(1, 1), (2, 3), (4, 2)] {
+        let mut schedule = createTrotterSchedule(&sum, order, reps);
+        assert!(getTrotterScheduleSweepsSaved(&schedule) > 0);
+
+        for angle in [0.3, -0.45, 0.3] {
+            let mut expected = createQureg(3);
+            initRandomPureState(expected.pin_mut());
+            let mut qureg = createCloneQureg(&expected);
+            applyTrotterizedPauliStrSumGadget(expected.pin_mut(), &sum, angle, order, reps);
+            applyTrotterSchedule(qureg.pin_mut(), schedule.pin_mut(), angle);
+            for index in 0..8 {
+                let e = getQuregAmp(expected.pin_mut(), index);
+                let a = getQuregAmp(qureg.pin_mut(), index);
+                assert_relative_eq!(a.re, e.re, epsilon = 1e-12);
+                assert_relative_eq!(a.im, e.im, epsilon = 1e-12);
+            }
+            destroyQureg(expected.pin_mut());
+            destroyQureg(qureg.pin_mut());
+        }
+    }
+    destroyPauliStrSum(sum.pin_mut());
+}
+
+#[test]
+fn test_trotter_schedule_converges_at_its_order() {
+    ensure_quest_env_initialized();
+
+    // Non-commuting terms, so the reordered formula differs from QuEST's
+    let mut sum =
+        createInlinePauliStrSum("0.5 XII\n0.4 ZZI\n-0.3 IYX\n0.6 IZZ\n0.25 XIY\n-0.35 YXI".to_string());
+    let angle = 0.8;
+    let mut initial = createQureg(3);
+    initRandomPureState(initial.pin_mut());
+    let mut exact = createCloneQureg(&initial);
+    applyTrotterizedPauliStrSumGadget(exact.pin_mut(), &sum, angle, 4, 200);
+
+    let mut distance = |qureg: &mut cxx::UniquePtr<Qureg>| {
+        (0..8)
+            .map(|index| {
+                let a = getQuregAmp(qureg.pin_mut(), index);
+                let e = getQuregAmp(exact.pin_mut(), index);
+                (a.re - e.re).powi(2) + (a.im - e.im).powi(2)
+            })
+            .sum::<f64>()
+            .sqrt()
+    };
+
+    for order in [1, 2, 4] {
+        let mut errors = Vec::new();
+        for reps in [4, 8] {
+            let mut schedule = createTrotterSchedule(&sum, order, reps);
+            let mut qureg = createCloneQureg(&initial);
+            applyTrotterSchedule(qureg.pin_mut(), schedule.pin_mut(), angle);
+            let mut reference = createCloneQureg(&initial);
+            applyTrotterizedPauliStrSumGadget(reference.pin_mut(), &sum, angle, order, reps);
+
+            let error = distance(&mut qureg);
+            let quest_error = distance(&mut reference);
+            assert!(error > 0.5 * quest_error && error < 2.0 * quest_error, "{error} vs {quest_error}");
+            errors.push(error);
+            destroyQureg(qureg.pin_mut());
+            destroyQureg(reference.pin_mut());
+        }
+
+        // Doubling the repetitions divides the error by 2^order
+        let ratio = errors[0] / errors[1];
+        let expected = 2f64.powi(order);
+        assert!(ratio > 0.75 * expected && ratio < 1.25 * expected, "order {order}: ratio {ratio}");
+    }
+
+    destroyQureg(initial.pin_mut());
+    destroyQureg(exact.pin_mut());
+    destroyPauliStrSum(sum.pin_mut());
+}
+
+#[test]
+fn test_profile_counters() {
+    ensure_quest_env_initialized();
+
+    let mut qureg = createQureg(4);
+    if !isProfilingEnabled() {
+        initPlusState(qureg.pin_mut());
+        assert!(getProfileEntries().is_empty());
+        destroyQureg(qureg.pin_mut());
+        return;
+    }
+
+    // Other tests may be calling wrappers concurrently, so only lower bounds hold
+    setProfileTraceCapacity(1 << 16);
+    for _ in 0..10 {
+        applyHadamard(qureg.pin_mut(), 0);
+    }
+    let amps = getQuregAmps(qureg.pin_mut(), 0, 16);
+    assert_eq!(amps.len(), 16);
+
+    let entries = getProfileEntries();
+    let hadamard = entries.iter().find(|e| e.name == "applyHadamard").unwrap();
+    assert!(hadamard.calls >= 10);
+    assert!(hadamard.bytes >= 10 * 16 * 16);
+    assert!(hadamard.p50_ns <= hadamard.p99_ns && hadamard.p99_ns <= hadamard.max_ns);
+    assert!(entries.iter().any(|e| e.name == "getQuregAmps"));
+    assert!(getProfileJson().contains("\"name\":\"applyHadamard\""));
+    assert!(getProfileChromeTrace().contains("\"ph\":\"X\""));
+
+    setProfileTraceCapacity(0);
+    destroyQureg(qureg.pin_mut());
+}
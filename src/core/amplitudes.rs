@@ -0,0 +1,121 @@
+use std::pin::Pin;
+
+use num_complex::Complex64;
+use quest_sys::{Quest_Complex, Qureg};
+
+/// Default number of amplitudes per chunk (16 MiB of `Complex64`)
+pub const DEFAULT_CHUNK_SIZE: usize = 1 << 20;
+
+// Quest_Complex is a repr(C) pair of f64, exactly like Complex64
+const _: () = assert!(std::mem::size_of::<Quest_Complex>() == std::mem::size_of::<Complex64>());
+const _: () = assert!(std::mem::align_of::<Quest_Complex>() == std::mem::align_of::<Complex64>());
+
+pub(crate) fn as_complex64(amps: &[Quest_Complex]) -> &[Complex64] {
+    unsafe { std::slice::from_raw_parts(amps.as_ptr().cast(), amps.len()) }
+}
+
+pub(crate) fn as_quest_complex_mut(amps: &mut [Complex64]) -> &mut [Quest_Complex] {
+    unsafe { std::slice::from_raw_parts_mut(amps.as_mut_ptr().cast(), amps.len()) }
+}
+
+/// Streams the amplitudes of a register in bounded chunks.
+///
+/// Local CPU statevectors are walked through a borrowed view of the amplitude
+/// buffer and never copied. Other registers (GPU, distributed or density
+/// matrices) are read chunk by chunk into a single reused buffer, so the peak
+/// overhead is one chunk regardless of the register size. Density matrices
+/// are streamed in QuEST's column-major flat order, in whole columns.
+pub struct AmplitudeChunks<'a> {
+    qureg: Pin<&'a mut Qureg>,
+    num_qubits: usize,
+    is_density_matrix: bool,
+    num_amps: i64,
+    chunk_size: usize,
+    next_index: i64,
+    buffer: Vec<Quest_Complex>,
+}
+
+impl<'a> AmplitudeChunks<'a> {
+    pub(crate) fn new(
+        qureg: Pin<&'a mut Qureg>,
+        num_qubits: usize,
+        is_density_matrix: bool,
+        chunk_size: usize,
+    ) -> Self {
+        assert!(chunk_size > 0, "chunk size must be positive");
+        let num_amps = if is_density_matrix {
+            1_i64 << (2 * num_qubits)
+        } else {
+            1_i64 << num_qubits
+        };
+        Self {
+            qureg,
+            num_qubits,
+            is_density_matrix,
+            num_amps,
+            chunk_size,
+            next_index: 0,
+            buffer: Vec::new(),
+        }
+    }
+
+    /// Total number of amplitudes the stream will yield
+    pub fn num_amps(&self) -> i64 {
+        self.num_amps
+    }
+
+    /// Returns the flat index of the next chunk together with its amplitudes,
+    /// or `None` once the register is exhausted. The slice is only valid until
+    /// the next call.
+    pub fn next_chunk(&mut self) -> Option<(i64, &[Complex64])> {
+        if self.next_index >= self.num_amps {
+            return None;
+        }
+        let start = self.next_index;
+
+        if quest_sys::isQuregAmpsViewable(&self.qureg) {
+            let len = (self.chunk_size as i64).min(self.num_amps - start);
+            self.next_index += len;
+            let view = quest_sys::getQuregAmpsView(&self.qureg);
+            let chunk = &view[start as usize..(start + len) as usize];
+            return Some((start, as_complex64(chunk)));
+        }
+
+        let len = if self.is_density_matrix {
+            self.read_density_columns(start)
+        } else {
+            let len = (self.chunk_size as i64).min(self.num_amps - start);
+            self.buffer.resize(len as usize, quest_sys::complex(0.0, 0.0));
+            quest_sys::getQuregAmpsInto(self.qureg.as_mut(), start, &mut self.buffer);
+            len
+        };
+        self.next_index += len;
+        Some((start, as_complex64(&self.buffer[..len as usize])))
+    }
+
+    /// Consumes the stream, handing every chunk to `f`
+    pub fn for_each_chunk<F: FnMut(i64, &[Complex64])>(mut self, mut f: F) {
+        while let Some((start, chunk)) = self.next_chunk() {
+            f(start, chunk);
+        }
+    }
+
+    // Reads as many whole columns as fit in a chunk, starting at a flat index
+    fn read_density_columns(&mut self, start: i64) -> i64 {
+        let dim = 1_i64 << self.num_qubits;
+        let max_cols = (self.chunk_size as i64 / dim).max(1);
+        let start_col = start / dim;
+        let num_cols = max_cols.min(dim - start_col);
+        let len = num_cols * dim;
+        self.buffer.resize(len as usize, quest_sys::complex(0.0, 0.0));
+        quest_sys::getDensityQuregAmpsColMajorInto(
+            self.qureg.as_mut(),
+            0,
+            start_col,
+            dim,
+            num_cols,
+            &mut self.buffer,
+        );
+        len
+    }
+}
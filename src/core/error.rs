@@ -0,0 +1,10 @@
+use thiserror::Error;
+
+/// Failures reported by the high-level register API
+#[derive(Debug, Error)]
+pub enum QuestError {
+    /// QuEST rejected the request and its error handler returned instead of
+    /// exiting, so no register was produced
+    #[error("QuEST could not provide a {num_qubits}-qubit register")]
+    RegisterUnavailable { num_qubits: usize },
+}
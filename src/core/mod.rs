@@ -1,2 +1,11 @@
+mod amplitudes;
 mod environment;
-mod register;
\ No newline at end of file
+mod error;
+mod pool;
+mod register;
+
+pub use amplitudes::{AmplitudeChunks, DEFAULT_CHUNK_SIZE};
+pub use environment::QuESTEnvironment;
+pub use error::QuestError;
+pub use pool::RegisterPool;
+pub use register::QuantumRegister;
@@ -0,0 +1,60 @@
+use quest_sys::{QuregPool, QuregPoolStats, qureg_init};
+use cxx::UniquePtr;
+
+use super::error::QuestError;
+use super::register::QuantumRegister;
+
+/// Recycles QuEST registers of the same size, type and deployment.
+///
+/// Registers acquired here are handed back to the pool rather than destroyed
+/// when they drop, so short-lived scratch registers reuse their amplitude
+/// buffers instead of reallocating them. Idle registers are freed by `clear`
+/// or once the pool and every register it lent out have been dropped.
+pub struct RegisterPool {
+    pool: UniquePtr<QuregPool>,
+}
+
+impl RegisterPool {
+    pub fn new() -> Self {
+        Self { pool: quest_sys::createQuregPool() }
+    }
+
+    /// A statevector in the zero state
+    pub fn acquire(&mut self, num_qubits: usize) -> Result<QuantumRegister, QuestError> {
+        let handle = quest_sys::acquireQureg(self.pool.pin_mut(), num_qubits as i32, qureg_init::ZERO);
+        QuantumRegister::pooled(handle, num_qubits, false)
+    }
+
+    /// A density matrix in the zero state
+    pub fn acquire_density(&mut self, num_qubits: usize) -> Result<QuantumRegister, QuestError> {
+        let handle = quest_sys::acquireDensityQureg(self.pool.pin_mut(), num_qubits as i32, qureg_init::ZERO);
+        QuantumRegister::pooled(handle, num_qubits, true)
+    }
+
+    /// A statevector or density matrix whose amplitudes are left as the
+    /// previous holder left them, for callers that overwrite every amplitude
+    pub fn acquire_uninitialised(&mut self, num_qubits: usize, is_density_matrix: bool) -> Result<QuantumRegister, QuestError> {
+        let pool = self.pool.pin_mut();
+        let handle = if is_density_matrix {
+            quest_sys::acquireDensityQureg(pool, num_qubits as i32, qureg_init::KEEP)
+        } else {
+            quest_sys::acquireQureg(pool, num_qubits as i32, qureg_init::KEEP)
+        };
+        QuantumRegister::pooled(handle, num_qubits, is_density_matrix)
+    }
+
+    /// A copy of `source`, deployed the same way
+    pub fn acquire_clone(&mut self, source: &QuantumRegister) -> Result<QuantumRegister, QuestError> {
+        let handle = quest_sys::acquireCloneQureg(self.pool.pin_mut(), source.qureg());
+        QuantumRegister::pooled(handle, source.num_qubits(), source.is_density_matrix())
+    }
+
+    pub fn stats(&self) -> QuregPoolStats {
+        quest_sys::getQuregPoolStats(&self.pool)
+    }
+
+    /// Frees the idle registers; registers still in use return later
+    pub fn clear(&mut self) {
+        quest_sys::clearQuregPool(self.pool.pin_mut());
+    }
+}
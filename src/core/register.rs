@@ -1,10 +1,22 @@
-use quest_sys::Qureg;
+use std::pin::Pin;
+
+use quest_sys::{PooledQureg, Qureg};
 use cxx::UniquePtr;
 use ndarray::{Array1, Array2, ArrayView1};
 use num_complex::Complex64;
 
+use super::amplitudes::{self, AmplitudeChunks};
+use super::error::QuestError;
+
+// A register is either owned outright or borrowed from a `RegisterPool`,
+// which gets it back when the handle is dropped
+enum Storage {
+    Owned(UniquePtr<Qureg>),
+    Pooled(UniquePtr<PooledQureg>),
+}
+
 pub struct QuantumRegister {
-    qureg: UniquePtr<Qureg>,
+    storage: Storage,
     num_qubits: usize,
     is_density_matrix: bool,
 }
@@ -12,7 +24,7 @@ pub struct QuantumRegister {
 impl QuantumRegister {
     pub fn new(num_qubits: usize) -> Self {
         Self {
-            qureg: quest_sys::createQureg(num_qubits as i32),
+            storage: Storage::Owned(quest_sys::createQureg(num_qubits as i32)),
             num_qubits,
             is_density_matrix: false,
         }
@@ -20,49 +32,88 @@ impl QuantumRegister {
 
     pub fn new_density(num_qubits: usize) -> Self {
         Self {
-            qureg: quest_sys::createDensityQureg(num_qubits as i32),
+            storage: Storage::Owned(quest_sys::createDensityQureg(num_qubits as i32)),
             num_qubits,
             is_density_matrix: true,
         }
     }
 
+    // A null handle means QuEST rejected the request without exiting
+    pub(crate) fn pooled(
+        handle: UniquePtr<PooledQureg>,
+        num_qubits: usize,
+        is_density_matrix: bool,
+    ) -> Result<Self, QuestError> {
+        if handle.is_null() {
+            return Err(QuestError::RegisterUnavailable { num_qubits });
+        }
+        Ok(Self {
+            storage: Storage::Pooled(handle),
+            num_qubits,
+            is_density_matrix,
+        })
+    }
+
+    pub(crate) fn qureg(&self) -> &Qureg {
+        match &self.storage {
+            Storage::Owned(qureg) => &**qureg,
+            Storage::Pooled(handle) => quest_sys::getPooledQureg(handle),
+        }
+    }
+
+    pub fn num_qubits(&self) -> usize {
+        self.num_qubits
+    }
+
+    pub fn is_density_matrix(&self) -> bool {
+        self.is_density_matrix
+    }
+
+    fn qureg_mut(&mut self) -> Pin<&mut Qureg> {
+        match &mut self.storage {
+            Storage::Owned(qureg) => qureg.pin_mut(),
+            Storage::Pooled(handle) => quest_sys::getPooledQuregMut(handle.pin_mut()),
+        }
+    }
+
     // State initialization methods
     pub fn init_zero(&mut self) {
-        quest_sys::initZeroState(self.qureg.pin_mut());
+        quest_sys::initZeroState(self.qureg_mut());
     }
 
     pub fn init_plus(&mut self) {
-        quest_sys::initPlusState(self.qureg.pin_mut());
+        quest_sys::initPlusState(self.qureg_mut());
     }
 
     // Measurement
     pub fn measure_qubit(&mut self, qubit: usize) -> bool {
-        let result = quest_sys::applyQubitMeasurement(self.qureg.pin_mut(), qubit as i32);
+        let result = quest_sys::applyQubitMeasurement(self.qureg_mut(), qubit as i32);
         result == 1
     }
 
     // Integration with ndarray
     pub fn to_statevector(&mut self) -> Array1<Complex64> {
-        // Get amplitudes and convert to ndarray
-        let amps = quest_sys::getQuregAmps(
-            self.qureg.pin_mut(),
-            0,
-            (1_i64 << self.num_qubits as i64)
-        );
-
+        // QuEST writes straight into the ndarray buffer
         let dim = 1 << self.num_qubits;
         let mut result = Array1::zeros(dim);
-
-        for (i, amp) in amps.iter().enumerate() {
-            result[i] = Complex64::new(amp.re, amp.im);
-        }
+        let out = result.as_slice_mut().expect("freshly allocated arrays are contiguous");
+        quest_sys::getQuregAmpsInto(self.qureg_mut(), 0, amplitudes::as_quest_complex_mut(out));
 
         result
     }
+
+    // Streaming access for registers too large to copy out whole
+    pub fn amplitude_chunks(&mut self, chunk_size: usize) -> AmplitudeChunks<'_> {
+        let (num_qubits, is_density_matrix) = (self.num_qubits, self.is_density_matrix);
+        AmplitudeChunks::new(self.qureg_mut(), num_qubits, is_density_matrix, chunk_size)
+    }
 }
 
 impl Drop for QuantumRegister {
     fn drop(&mut self) {
-        quest_sys::destroyQureg(self.qureg.pin_mut());
+        // Pooled handles hand their register back when they drop
+        if let Storage::Owned(qureg) = &mut self.storage {
+            quest_sys::destroyQureg(qureg.pin_mut());
+        }
     }
 }
\ No newline at end of file
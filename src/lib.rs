@@ -1,5 +1,7 @@
 mod core;
 
+pub use self::core::{AmplitudeChunks, DEFAULT_CHUNK_SIZE, QuESTEnvironment, QuantumRegister, QuestError, RegisterPool};
+
 pub fn add(left: u64, right: u64) -> u64 {
     left + right
 }
@@ -0,0 +1,93 @@
+use std::sync::Once;
+
+use num_complex::Complex64;
+use quest_rs::{QuESTEnvironment, QuantumRegister, RegisterPool};
+
+static INIT: Once = Once::new();
+
+// QuEST can only be initialised once per process, so the environment is
+// leaked rather than finalised when a test ends
+fn ensure_quest_env_initialized() {
+    INIT.call_once(|| std::mem::forget(QuESTEnvironment::new()));
+}
+
+#[test]
+fn test_register_pool_recycles_registers() {
+    ensure_quest_env_initialized();
+
+    let mut pool = RegisterPool::new();
+    let mut first = pool.acquire(2).expect("a 2-qubit register");
+    first.init_plus();
+    drop(first);
+
+    let stats = pool.stats();
+    assert_eq!(stats.in_use, 0);
+    assert_eq!(stats.idle, 1);
+    assert_eq!(stats.created, 1);
+
+    // The recycled register is handed out in the zero state again
+    let mut reused = pool.acquire(2).expect("a recycled 2-qubit register");
+    let amps = reused.to_statevector();
+    assert!((amps[0].re - 1.0).abs() < 1e-12);
+    assert!(amps.iter().skip(1).all(|amp| amp.norm() < 1e-12));
+
+    let clone = pool.acquire_clone(&reused).expect("a clone");
+    assert_eq!(clone.num_qubits(), 2);
+    assert!(!clone.is_density_matrix());
+
+    let rho = pool.acquire_density(2).expect("a 2-qubit density matrix");
+    assert!(rho.is_density_matrix());
+    drop((reused, clone, rho));
+
+    let stats = pool.stats();
+    assert_eq!(stats.reused, 1);
+    assert_eq!(stats.high_water_mark, 3);
+    assert_eq!(stats.idle, 3);
+
+    pool.clear();
+    assert_eq!(pool.stats().idle, 0);
+}
+
+// Concatenates a register's chunks, checking they arrive in order and within
+// `max_len` amplitudes each
+fn collect_chunks(register: &mut QuantumRegister, chunk_size: usize, max_len: usize) -> Vec<Complex64> {
+    let mut out = Vec::new();
+    let chunks = register.amplitude_chunks(chunk_size);
+    let num_amps = chunks.num_amps();
+    chunks.for_each_chunk(|start, chunk| {
+        assert_eq!(start, out.len() as i64);
+        assert!(!chunk.is_empty() && chunk.len() <= max_len);
+        out.extend_from_slice(chunk);
+    });
+    assert_eq!(out.len() as i64, num_amps);
+    out
+}
+
+#[test]
+fn test_amplitude_chunks_stream_whole_register() {
+    ensure_quest_env_initialized();
+
+    // Measuring one qubit of |+++> leaves unequal amplitudes to compare
+    let mut psi = QuantumRegister::new(3);
+    psi.init_plus();
+    psi.measure_qubit(0);
+    let expected = psi.to_statevector().to_vec();
+    for chunk_size in [1, 3, 100] {
+        assert_eq!(collect_chunks(&mut psi, chunk_size, chunk_size), expected);
+    }
+
+    // Density matrices stream whole columns in column-major order, so a
+    // chunk holds at least one column of `dim` amplitudes
+    let dim = 4;
+    let mut rho = QuantumRegister::new_density(2);
+    rho.init_plus();
+    let outcome = rho.measure_qubit(0) as usize;
+    for chunk_size in [1, 6, 100] {
+        let amps = collect_chunks(&mut rho, chunk_size, chunk_size.max(dim));
+        for (flat, amp) in amps.iter().enumerate() {
+            let (row, col) = (flat % dim, flat / dim);
+            let expected = if row & 1 == outcome && col & 1 == outcome { 0.5 } else { 0.0 };
+            assert!((amp.re - expected).abs() < 1e-12 && amp.im.abs() < 1e-12);
+        }
+    }
+}